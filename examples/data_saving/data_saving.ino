@@ -509,8 +509,8 @@ void setup() {
 // ==========================================================================
 /** Start [loop] */
 // Use this long loop when you want to do something special
-// Because of the way alarms work on the RTC, it will wake the processor and
-// start the loop every minute exactly on the minute.
+// The RTC alarm is set for the start of the next logging interval, so it will
+// wake the processor and start the loop exactly on the logging interval.
 // The processor may also be woken up by another interrupt or level change on a
 // pin - from a button or some other input.
 // The "if" statements in the loop determine what will happen - whether the
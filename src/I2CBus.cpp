@@ -0,0 +1,161 @@
+/**
+ * @file I2CBus.cpp
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the I2CBus class.
+ */
+
+#include "I2CBus.h"
+
+// The list of busses
+I2CBus* I2CBus::_firstBus = NULL;
+
+// The constructor - the bus isn't started until it's needed
+I2CBus::I2CBus(TwoWire* wire) {
+    _wire             = wire;
+    _begun            = false;
+    _clock_Hz         = MS_I2C_DEFAULT_CLOCK;
+    _numDevices       = 0;
+    _current          = -1;
+    _inTransaction    = false;
+    _transactionStart = 0;
+    _nextBus          = NULL;
+}
+
+
+// This finds the bus for a TwoWire instance or makes a new one
+I2CBus* I2CBus::getBus(TwoWire* wire) {
+    I2CBus* bus = _firstBus;
+    while (bus != NULL) {
+        if (bus->_wire == wire) return bus;
+        bus = bus->_nextBus;
+    }
+    bus           = new I2CBus(wire);
+    bus->_nextBus = _firstBus;
+    _firstBus     = bus;
+    return bus;
+}
+
+
+void I2CBus::begin(void) {
+    if (_begun) return;
+    MS_DBG(F("Beginning wire (I2C)"));
+    _wire->begin();
+    // Eliminate any potential extra waits in the wire library
+    // These waits would be caused by a readBytes or parseX being called
+    // on wire after the Wire buffer has emptied.  The default stream
+    // functions - used by wire - wait a timeout period after reading the
+    // end of the buffer to see if an interrupt puts something into the
+    // buffer.  In the case of the Wire library, that will never happen and
+    // the timeout period is a useless delay.
+    _wire->setTimeout(0);
+    // Beginning the Wire library resets the clock
+    _clock_Hz = MS_I2C_DEFAULT_CLOCK;
+    _begun    = true;
+}
+
+
+void I2CBus::end(void) {
+    _wire->end();
+    _begun = false;
+}
+
+
+int8_t I2CBus::findDevice(uint8_t i2cAddress) {
+    for (uint8_t i = 0; i < _numDevices; i++) {
+        if (_addresses[i] == i2cAddress) return i;
+    }
+    if (_numDevices >= MS_I2C_MAX_DEVICES) return -1;
+
+    uint8_t slot        = _numDevices++;
+    _addresses[slot]    = i2cAddress;
+    _clocks[slot]       = MS_I2C_DEFAULT_CLOCK;
+    _busTime_us[slot]   = 0;
+    _transactions[slot] = 0;
+    _nacks[slot]        = 0;
+    return slot;
+}
+
+
+void I2CBus::setDeviceClock(uint8_t i2cAddress, uint32_t clock_Hz) {
+    int8_t slot = findDevice(i2cAddress);
+    if (slot >= 0) _clocks[slot] = clock_Hz;
+}
+
+
+void I2CBus::beginTransaction(uint8_t i2cAddress) {
+    begin();
+    _current = findDevice(i2cAddress);
+
+    uint32_t clock_Hz = MS_I2C_DEFAULT_CLOCK;
+    if (_current >= 0) clock_Hz = _clocks[_current];
+    // The bus is always at the default clock between transactions
+    if (clock_Hz != _clock_Hz) {
+        _wire->setClock(clock_Hz);
+        _clock_Hz = clock_Hz;
+    }
+    _inTransaction    = true;
+    _transactionStart = micros();
+}
+
+
+void I2CBus::endTransaction(bool acknowledged) {
+    if (_current >= 0 && !acknowledged) {
+        _nacks[_current]++;
+        MS_DBG(F("I2C device at 0x"), String(_addresses[_current], HEX),
+               F("did not acknowledge"));
+    }
+    endTransaction();
+}
+
+
+void I2CBus::endTransaction(void) {
+    if (_current >= 0) {
+        _busTime_us[_current] += micros() - _transactionStart;
+        _transactions[_current]++;
+        _current = -1;
+    }
+    _inTransaction = false;
+    // Put a fast clock back to the default so nothing else using the Wire
+    // library outside of a transaction runs fast by accident
+    if (_clock_Hz != MS_I2C_DEFAULT_CLOCK) {
+        _wire->setClock(MS_I2C_DEFAULT_CLOCK);
+        _clock_Hz = MS_I2C_DEFAULT_CLOCK;
+    }
+}
+
+
+bool I2CBus::inTransaction(void) {
+    return _inTransaction;
+}
+
+
+uint32_t I2CBus::getBusTime(uint8_t i2cAddress) {
+    for (uint8_t i = 0; i < _numDevices; i++) {
+        if (_addresses[i] == i2cAddress) return _busTime_us[i];
+    }
+    return 0;
+}
+uint16_t I2CBus::getTransactionCount(uint8_t i2cAddress) {
+    for (uint8_t i = 0; i < _numDevices; i++) {
+        if (_addresses[i] == i2cAddress) return _transactions[i];
+    }
+    return 0;
+}
+uint16_t I2CBus::getNackCount(uint8_t i2cAddress) {
+    for (uint8_t i = 0; i < _numDevices; i++) {
+        if (_addresses[i] == i2cAddress) return _nacks[i];
+    }
+    return 0;
+}
+
+
+void I2CBus::resetCounts(void) {
+    for (uint8_t i = 0; i < _numDevices; i++) {
+        _busTime_us[i]   = 0;
+        _transactions[i] = 0;
+        _nacks[i]        = 0;
+    }
+}
@@ -0,0 +1,243 @@
+/**
+ * @file I2CBus.h
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the I2CBus class, which starts a hardware I2C bus once per
+ * wake and keeps the clock speed and statistics of the devices on it.
+ */
+
+// Header Guards
+#ifndef SRC_I2CBUS_H_
+#define SRC_I2CBUS_H_
+
+// Debugging Statement
+// #define MS_I2CBUS_DEBUG
+
+#ifdef MS_I2CBUS_DEBUG
+#define MS_DEBUGGING_STD "I2CBus"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Arduino.h>
+#include <Wire.h>
+
+#ifndef MS_I2C_MAX_DEVICES
+/**
+ * @brief The number of device addresses each I2C bus keeps a clock speed and
+ * statistics for.
+ */
+#define MS_I2C_MAX_DEVICES 8
+#endif
+
+#ifndef MS_I2C_DEFAULT_CLOCK
+/**
+ * @brief The I2C clock speed, in Hz, for devices that haven't been given one;
+ * standard mode.
+ */
+#define MS_I2C_DEFAULT_CLOCK 100000L
+#endif
+
+/**
+ * @brief A hardware I2C bus and the devices on it.
+ *
+ * There is one bus for each TwoWire instance, made the first time it's asked
+ * for with I2CBus::getBus().  The logger starts the bus with begin() when it
+ * wakes and stops it with end() before it sleeps; sensors that need the bus
+ * call begin() too, which does nothing if the bus is already running.
+ *
+ * Sensors put each group of reads and writes to a device between
+ * beginTransaction() and endTransaction().  beginTransaction() switches the
+ * bus to the clock speed set for the device with setDeviceClock(), so devices
+ * that support fast mode can be run at 400 kHz.  endTransaction() always puts
+ * the bus back to #MS_I2C_DEFAULT_CLOCK, so anything else using the Wire
+ * library outside of a transaction (the RTC, or a library that talks to its
+ * device on its own) still gets the standard clock.  endTransaction() also
+ * adds the time the group took to the device's total bus time.
+ *
+ * A device that didn't acknowledge is only counted when the driver can
+ * actually tell, from the result of `endTransmission()` or `requestFrom()`.
+ * Drivers that go through a library that hides those results end their
+ * transactions without an acknowledgement, and their NACK count stays at 0.
+ *
+ * @note Every device on the bus sees the fast traffic to a fast device, even
+ * though it isn't addressed.  Only raise the clock for a device on a bus where
+ * every other device tolerates 400 kHz traffic.
+ */
+class I2CBus {
+ public:
+    /**
+     * @brief Get the bus for a TwoWire instance, creating it if needed.
+     *
+     * @param wire The TwoWire instance; the primary hardware I2C by default
+     * @return **I2CBus\*** The bus
+     */
+    static I2CBus* getBus(TwoWire* wire = &Wire);
+
+    /**
+     * @brief Start the bus, unless it is already running.
+     *
+     * This begins the Wire library (setting the pin levels and modes for I2C)
+     * and removes the stream timeout.
+     */
+    void begin(void);
+    /**
+     * @brief Stop the bus.
+     *
+     * This disables the two-wire pin functionality and turns off the internal
+     * pull-up resistors.
+     */
+    void end(void);
+
+    /**
+     * @brief Set the clock speed to use for a device.
+     *
+     * @param i2cAddress The I2C address of the device
+     * @param clock_Hz The clock speed in Hz; 100000 or 400000
+     */
+    void setDeviceClock(uint8_t i2cAddress, uint32_t clock_Hz);
+
+    /**
+     * @brief Start a group of reads and writes to a device.
+     *
+     * This makes sure the bus is running and at the device's clock speed.
+     *
+     * @param i2cAddress The I2C address of the device
+     */
+    void beginTransaction(uint8_t i2cAddress);
+    /**
+     * @brief Finish a group of reads and writes to a device.
+     *
+     * This puts the bus back to the default clock speed.
+     *
+     * @param acknowledged True if the device answered
+     */
+    void endTransaction(bool acknowledged);
+    /**
+     * @brief Finish a group of reads and writes to a device when the driver
+     * can't tell whether the device answered.
+     *
+     * The transaction is counted and timed, but never counted as a NACK.
+     * This puts the bus back to the default clock speed.
+     */
+    void endTransaction(void);
+    /**
+     * @brief Check whether a transaction has begun and not yet ended.
+     *
+     * Code that may run in the middle of another driver's work, like a
+     * yield() hook, checks this before using the bus.
+     *
+     * @return **bool** True if a transaction is in progress
+     */
+    bool inTransaction(void);
+
+    /**
+     * @brief Get the total time spent on transactions with a device since the
+     * counts were reset.
+     *
+     * @param i2cAddress The I2C address of the device
+     * @return **uint32_t** The bus time in microseconds
+     */
+    uint32_t getBusTime(uint8_t i2cAddress);
+    /**
+     * @brief Get the number of transactions with a device since the counts
+     * were reset.
+     *
+     * @param i2cAddress The I2C address of the device
+     * @return **uint16_t** The number of transactions
+     */
+    uint16_t getTransactionCount(uint8_t i2cAddress);
+    /**
+     * @brief Get the number of transactions a device didn't acknowledge since
+     * the counts were reset.
+     *
+     * This is always 0 for devices whose driver can't see acknowledgements.
+     *
+     * @param i2cAddress The I2C address of the device
+     * @return **uint16_t** The number of NACK'd transactions
+     */
+    uint16_t getNackCount(uint8_t i2cAddress);
+    /**
+     * @brief Reset the bus times and transaction counts of all devices.
+     */
+    void resetCounts(void);
+
+ protected:
+    /**
+     * @brief Construct a new I2C bus
+     *
+     * @param wire The TwoWire instance of the bus
+     */
+    explicit I2CBus(TwoWire* wire);
+
+    /**
+     * @brief Find the slot for a device, adding it if there's room.
+     *
+     * @param i2cAddress The I2C address of the device
+     * @return **int8_t** The slot, or -1 if the device isn't known and there
+     * is no room for it
+     */
+    int8_t findDevice(uint8_t i2cAddress);
+
+    /**
+     * @brief The TwoWire instance of the bus
+     */
+    TwoWire* _wire;
+    /**
+     * @brief True if the bus has been started since it was last stopped
+     */
+    bool _begun;
+    /**
+     * @brief The clock speed the bus was last set to
+     */
+    uint32_t _clock_Hz;
+    /**
+     * @brief The number of devices known on the bus
+     */
+    uint8_t _numDevices;
+    /**
+     * @brief The addresses of the devices
+     */
+    uint8_t _addresses[MS_I2C_MAX_DEVICES];
+    /**
+     * @brief The clock speed for each device
+     */
+    uint32_t _clocks[MS_I2C_MAX_DEVICES];
+    /**
+     * @brief The total time of the transactions with each device
+     */
+    uint32_t _busTime_us[MS_I2C_MAX_DEVICES];
+    /**
+     * @brief The number of transactions with each device
+     */
+    uint16_t _transactions[MS_I2C_MAX_DEVICES];
+    /**
+     * @brief The number of transactions each device didn't acknowledge
+     */
+    uint16_t _nacks[MS_I2C_MAX_DEVICES];
+    /**
+     * @brief The slot of the device in the current transaction, or -1
+     */
+    int8_t _current;
+    /**
+     * @brief True between beginTransaction() and endTransaction()
+     */
+    bool _inTransaction;
+    /**
+     * @brief The micros() at the start of the current transaction
+     */
+    uint32_t _transactionStart;
+    /**
+     * @brief The next bus in the list of all busses
+     */
+    I2CBus* _nextBus;
+    /**
+     * @brief The first bus in the list of all busses
+     */
+    static I2CBus* _firstBus;
+};
+
+#endif  // SRC_I2CBUS_H_
@@ -33,6 +33,20 @@ uint32_t Logger::markedEpochTimeUTC = 0;
 volatile bool Logger::isLoggingNow = false;
 volatile bool Logger::isTestingNow = false;
 volatile bool Logger::startTesting = false;
+// Initialize the wake counter
+uint32_t Logger::_wakeCount = 0;
+// Initialize the list of loggers
+Logger* Logger::_firstLogger = NULL;
+// Initialize the static clock drift model
+Logger::rtcDriftModel Logger::_rtcDrift = {0, 0, 0, 1, 0, 0, 0, 0};
+// Initialize the cached date and time zone strings
+uint32_t Logger::_cachedDay               = 0;
+char     Logger::_cachedDate[11]          = "";
+int8_t   Logger::_cachedTimeZone          = 0;
+char     Logger::_cachedTimeZoneString[7] = "";
+// Initialize the clock alarm time
+volatile uint32_t Logger::_alarmMillis = 0;
+volatile bool     Logger::_alarmFired  = false;
 
 // Initialize the RTC for the SAMD boards
 #if defined(ARDUINO_ARCH_SAMD)
@@ -75,6 +89,9 @@ Logger::Logger(const char* loggerID, uint16_t loggingIntervalMinutes,
         dataPublishers[i] = NULL;
     }
 
+    // Add to the list of loggers sharing the RTC alarm
+    addToLoggerList();
+
     // MS_DBG(F("Logger object created"));
 }
 Logger::Logger(const char* loggerID, uint16_t loggingIntervalMinutes,
@@ -110,6 +127,9 @@ Logger::Logger(const char* loggerID, uint16_t loggingIntervalMinutes,
         dataPublishers[i] = NULL;
     }
 
+    // Add to the list of loggers sharing the RTC alarm
+    addToLoggerList();
+
     // MS_DBG(F("Logger object created"));
 }
 Logger::Logger() {
@@ -134,15 +154,40 @@ Logger::Logger() {
     // Start with no modem attached
     _logModem = NULL;
 
+    // Start with no variable array
+    _internalArray = NULL;
+
     // Clear arrays
     for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
         dataPublishers[i] = NULL;
     }
 
+    // Add to the list of loggers sharing the RTC alarm
+    addToLoggerList();
+
     // MS_DBG(F("Logger object created"));
 }
 // Destructor
-Logger::~Logger() {}
+Logger::~Logger() {
+    // Take this logger out of the list of loggers
+    Logger** link = &_firstLogger;
+    while (*link != NULL) {
+        if (*link == this) {
+            *link = _nextLogger;
+            break;
+        }
+        link = &(*link)->_nextLogger;
+    }
+}
+
+
+void Logger::addToLoggerList(void) {
+    _nextLogger  = _firstLogger;
+    _firstLogger = this;
+    // All loggers share the one clock, so any of them can re-anchor the time
+    // base
+    LoggerClock::setAnchorFunction(reanchorTimeBase);
+}
 
 
 // ===================================================================== //
@@ -342,7 +387,7 @@ bool Logger::syncRTC() {
     // Power down the modem - but only if there will be more than 15 seconds
     // before the NEXT logging interval - it can take the modem that long to
     // shut down
-    if (Logger::getNowEpoch() % (_loggingIntervalMinutes * 60) > 15) {
+    if (Logger::getTimeBaseEpoch() % (_loggingIntervalMinutes * 60) > 15) {
         Serial.println(F("Putting modem to sleep"));
         _logModem->disconnectInternet();
         _logModem->modemSleepPowerDown();
@@ -474,6 +519,10 @@ uint32_t Logger::getNowEpoch(void) {
 }
 void Logger::setNowEpoch(uint32_t ts) {
     rtc.setEpoch(ts);
+    // Setting the clock starts a new second, so the time base is anchored
+    // to it exactly
+    if (isRTCSane(ts)) ts += ((uint32_t)_loggerRTCOffset) * 3600;
+    LoggerClock::setAnchor(ts, millis());
 }
 
 #elif defined ARDUINO_ARCH_SAMD
@@ -487,10 +536,49 @@ uint32_t Logger::getNowEpoch(void) {
 }
 void Logger::setNowEpoch(uint32_t ts) {
     zero_sleep_rtc.setEpoch(ts);
+    if (isRTCSane(ts)) ts += ((uint32_t)_loggerRTCOffset) * 3600;
+    LoggerClock::setAnchor(ts, millis());
 }
 
 #endif
 
+// This gets the current epoch time from millis(), as anchored to the RTC
+uint32_t Logger::getTimeBaseEpoch(void) {
+    return LoggerClock::getEpoch();
+}
+uint32_t Logger::getTimeBaseEpoch(uint16_t& milliseconds) {
+    return LoggerClock::getEpoch(milliseconds);
+}
+
+
+// This anchors the millis() time base to the RTC
+void Logger::anchorTimeBase(bool waitForTick) {
+    uint32_t nowEpoch  = getNowEpoch();
+    uint32_t nowMillis = millis();
+    if (_alarmFired) {
+        // The alarm fired on the tick of a second, so the clock has ticked
+        // once for every whole second since then
+        nowEpoch -= (nowMillis - _alarmMillis) / 1000;
+        nowMillis = _alarmMillis;
+    } else if (waitForTick) {
+        uint32_t start = millis();
+        while (millis() - start < 1100L) {
+            uint32_t tickEpoch = getNowEpoch();
+            if (tickEpoch != nowEpoch) {
+                nowMillis = millis();
+                nowEpoch  = tickEpoch;
+                break;
+            }
+        }
+    }
+    _alarmFired = false;
+    LoggerClock::setAnchor(nowEpoch, nowMillis);
+}
+void Logger::reanchorTimeBase(void) {
+    anchorTimeBase(true);
+}
+
+
 // This converts the current UNIX timestamp (ie, the number of seconds
 // from January 1, 1970 00:00:00 UTC) into a DateTime object
 // The DateTime object constructor requires the number of seconds from
@@ -504,26 +592,7 @@ DateTime Logger::dtFromEpoch(uint32_t epochTime) {
 // It assumes the supplied date/time is in the LOGGER's timezone and adds
 // the LOGGER's offset as the time zone offset in the string.
 String Logger::formatDateTime_ISO8601(DateTime& dt) {
-    // Set up an inital string
-    String dateTimeStr;
-    // Convert the DateTime object to a String
-    dt.addToString(dateTimeStr);
-    dateTimeStr.replace(" ", "T");
-    String tzString = String(_loggerTimeZone);
-    if (-24 <= _loggerTimeZone && _loggerTimeZone <= -10) {
-        tzString += F(":00");
-    } else if (-10 < _loggerTimeZone && _loggerTimeZone < 0) {
-        tzString = tzString.substring(0, 1) + '0' + tzString.substring(1, 2) +
-            F(":00");
-    } else if (_loggerTimeZone == 0) {
-        tzString = 'Z';
-    } else if (0 < _loggerTimeZone && _loggerTimeZone < 10) {
-        tzString = "+0" + tzString + F(":00");
-    } else if (10 <= _loggerTimeZone && _loggerTimeZone <= 24) {
-        tzString = "+" + tzString + F(":00");
-    }
-    dateTimeStr += tzString;
-    return dateTimeStr;
+    return formatDateTime_ISO8601(dt.getEpoch());
 }
 
 
@@ -531,9 +600,89 @@ String Logger::formatDateTime_ISO8601(DateTime& dt) {
 // It assumes the supplied date/time is in the LOGGER's timezone and adds
 // the LOGGER's offset as the time zone offset in the string.
 String Logger::formatDateTime_ISO8601(uint32_t epochTime) {
-    // Create a DateTime object from the epochTime
-    DateTime dt = dtFromEpoch(epochTime);
-    return formatDateTime_ISO8601(dt);
+    char dateTimeStr[ISO8601_BUFFER_SIZE];
+    formatDateTime(epochTime, dateTimeStr, 'T', true);
+    return String(dateTimeStr);
+}
+
+
+// These write the date and time into a character buffer
+void Logger::formatDateTime_ISO8601(uint32_t epochTime, char* buffer) {
+    formatDateTime(epochTime, buffer, 'T', true);
+}
+void Logger::formatDateTime_CSV(uint32_t epochTime, char* buffer) {
+    formatDateTime(epochTime, buffer, ' ', false);
+}
+
+
+// Protected helper function - this writes the date and time into a character
+// buffer.  Only the time of day is worked out each time; the date and time
+// zone are re-used from the last call unless they've changed.
+void Logger::formatDateTime(uint32_t epochTime, char* buffer, char separator,
+                            bool addTimeZone) {
+    // The DateTime class counts from 2000, so anything earlier doesn't follow
+    // the arithmetic below.  Let it do whatever it does with those.
+    if (epochTime < EPOCH_TIME_OFF) {
+        String dateTimeStr;
+        dtFromEpoch(epochTime).addToString(dateTimeStr);
+        dateTimeStr.replace(' ', separator);
+        dateTimeStr.toCharArray(buffer, 20);
+    } else {
+        uint32_t day = epochTime / 86400;
+        if (day != _cachedDay) {
+            DateTime dt   = dtFromEpoch(epochTime);
+            uint16_t year = dt.year();
+            _cachedDate[0] = '0' + year / 1000;
+            _cachedDate[1] = '0' + (year / 100) % 10;
+            _cachedDate[2] = '0' + (year / 10) % 10;
+            _cachedDate[3] = '0' + year % 10;
+            _cachedDate[4] = '-';
+            _cachedDate[5] = '0' + dt.month() / 10;
+            _cachedDate[6] = '0' + dt.month() % 10;
+            _cachedDate[7] = '-';
+            _cachedDate[8] = '0' + dt.date() / 10;
+            _cachedDate[9] = '0' + dt.date() % 10;
+            _cachedDate[10] = '\0';
+            _cachedDay      = day;
+        }
+        memcpy(buffer, _cachedDate, 10);
+
+        uint32_t secondOfDay = epochTime % 86400;
+        uint8_t  hour        = secondOfDay / 3600;
+        uint8_t  minute      = (secondOfDay / 60) % 60;
+        uint8_t  second      = secondOfDay % 60;
+        buffer[10]           = separator;
+        buffer[11]           = '0' + hour / 10;
+        buffer[12]           = '0' + hour % 10;
+        buffer[13]           = ':';
+        buffer[14]           = '0' + minute / 10;
+        buffer[15]           = '0' + minute % 10;
+        buffer[16]           = ':';
+        buffer[17]           = '0' + second / 10;
+        buffer[18]           = '0' + second % 10;
+        buffer[19]           = '\0';
+    }
+    if (!addTimeZone) return;
+
+    // An empty string means the time zone hasn't been cached yet
+    if (_cachedTimeZoneString[0] == '\0' ||
+        _cachedTimeZone != _loggerTimeZone) {
+        int8_t tz = _loggerTimeZone;
+        if (tz == 0) {
+            strcpy(_cachedTimeZoneString, "Z");
+        } else if (-24 <= tz && tz <= 24) {
+            uint8_t absTZ           = tz < 0 ? -tz : tz;
+            _cachedTimeZoneString[0] = tz < 0 ? '-' : '+';
+            _cachedTimeZoneString[1] = '0' + absTZ / 10;
+            _cachedTimeZoneString[2] = '0' + absTZ % 10;
+            strcpy(_cachedTimeZoneString + 3, ":00");
+        } else {
+            // Out of range offsets have always been printed as a bare number
+            itoa(tz, _cachedTimeZoneString, 10);
+        }
+        _cachedTimeZone = tz;
+    }
+    strcat(buffer, _cachedTimeZoneString);
 }
 
 
@@ -561,15 +710,182 @@ bool Logger::setRTClock(uint32_t UTCEpochSeconds) {
            formatDateTime_ISO8601(cur_logTZ));
     MS_DBG(F("    Offset between NIST and RTC:"), abs(set_logTZ - cur_logTZ));
 
+    // Use the offset to refine the estimate of how fast the clock drifts
+    updateRTCDrift(cur_logTZ - ((uint32_t)getTZOffset()) * 3600, set_rtcTZ);
+
     // If the RTC and NIST disagree by more than 5 seconds, set the clock
+    bool clockSet = false;
     if (abs(set_logTZ - cur_logTZ) > 5) {
         setNowEpoch(set_rtcTZ);
+        _rtcDrift.syncError = 0;
         PRINTOUT(F("Clock set!"));
-        return true;
+        clockSet = true;
     } else {
         PRINTOUT(F("Clock already within 5 seconds of time."));
-        return false;
     }
+    saveRTCDrift();
+    return clockSet;
+}
+
+
+// This updates the clock drift model with the offset found at a sync
+void Logger::updateRTCDrift(uint32_t rtcEpoch, uint32_t trueEpoch) {
+    int32_t error = static_cast<int32_t>(rtcEpoch - trueEpoch);
+
+    // A drift rate can only be measured against a previous sync, and only if
+    // the clock kept running (stayed sane) in between
+    if (_rtcDrift.lastSyncEpoch != 0 && isRTCSane(rtcEpoch) &&
+        trueEpoch > _rtcDrift.lastSyncEpoch &&
+        trueEpoch - _rtcDrift.lastSyncEpoch >= MS_RTC_DRIFT_MIN_BASELINE) {
+        float baseline = static_cast<float>(trueEpoch -
+                                            _rtcDrift.lastSyncEpoch);
+        // The drift of the bare clock is the error it has now, plus what has
+        // already been taken out by stepping it, less what it started with
+        float measuredPPM = static_cast<float>(error + _rtcDrift.stepsSinceSync -
+                                               _rtcDrift.syncError) *
+            1000000 / baseline;
+        // The error left over after stepping is how well the model is doing
+        float residualPPM = static_cast<float>(error - _rtcDrift.syncError) *
+            1000000 / baseline;
+        MS_DBG(F("Measured RTC drift:"), measuredPPM, F("ppm; residual:"),
+               residualPPM, F("ppm"));
+
+        // Anything this far off is a clock that was re-set by hand or lost
+        // power, not drift
+        if (fabs(measuredPPM) < 200) {
+            // Average in the new measurement, weighting the history more
+            // heavily as it builds up
+            uint8_t weight = _rtcDrift.driftSamples < 3
+                ? _rtcDrift.driftSamples
+                : 3;
+            _rtcDrift.driftPPM += (measuredPPM - _rtcDrift.driftPPM) /
+                (weight + 1);
+            if (_rtcDrift.driftSamples < 255) { _rtcDrift.driftSamples++; }
+
+            // Stretch the time between syncs to as many days as it would take
+            // the residual error to reach the allowed error
+            float residualPerDay = fabs(residualPPM) * 0.0864;
+            if (residualPerDay * MS_RTC_MAX_SYNC_DAYS <=
+                MS_RTC_MAX_DRIFT_ERROR) {
+                _rtcDrift.syncIntervalDays = MS_RTC_MAX_SYNC_DAYS;
+            } else {
+                _rtcDrift.syncIntervalDays = static_cast<uint8_t>(
+                    MS_RTC_MAX_DRIFT_ERROR / residualPerDay);
+                if (_rtcDrift.syncIntervalDays < 1) {
+                    _rtcDrift.syncIntervalDays = 1;
+                }
+            }
+            MS_DBG(F("RTC drift estimate is now"), _rtcDrift.driftPPM,
+                   F("ppm; syncing every"), _rtcDrift.syncIntervalDays,
+                   F("days"));
+        }
+    } else if (!isRTCSane(rtcEpoch)) {
+        // The clock lost time; go back to syncing daily until it's proven
+        _rtcDrift.syncIntervalDays = 1;
+    }
+
+    // This sync becomes the reference for the next one
+    _rtcDrift.lastSyncEpoch  = trueEpoch;
+    _rtcDrift.syncError      = error;
+    _rtcDrift.lastStepEpoch  = trueEpoch;
+    _rtcDrift.stepsSinceSync = 0;
+}
+
+
+// This steps the clock by the drift predicted since it was last set
+void Logger::disciplineRTC(void) {
+    if (_rtcDrift.driftSamples == 0 || _rtcDrift.lastStepEpoch == 0) return;
+
+    uint32_t nowEpoch = getNowEpoch();
+    if (!isRTCSane(nowEpoch)) return;
+    uint32_t nowRTC = nowEpoch - ((uint32_t)_loggerRTCOffset) * 3600;
+    if (nowRTC <= _rtcDrift.lastStepEpoch) return;
+
+    // Only whole seconds can be stepped; the remainder carries forward
+    float predicted = _rtcDrift.driftPPM *
+        static_cast<float>(nowRTC - _rtcDrift.lastStepEpoch) / 1000000;
+    int32_t step = static_cast<int32_t>(predicted);
+    if (step == 0) return;
+
+    // Don't step the clock back over an interval that was just logged or
+    // forward over one that is about to be
+    uint32_t intervalSecs = static_cast<uint32_t>(_loggingIntervalMinutes) *
+        60;
+    if (intervalSecs > 0) {
+        uint32_t sinceLast = nowEpoch % intervalSecs;
+        uint32_t untilNext = intervalSecs - sinceLast;
+        if (sinceLast <= static_cast<uint32_t>(abs(step)) ||
+            untilNext <= static_cast<uint32_t>(abs(step)) + 1) {
+            return;
+        }
+    }
+
+    // Wait for the clock to tick over so the fraction of the second isn't lost
+    // when the clock is set
+    uint32_t start = millis();
+    while (getNowEpoch() == nowEpoch && millis() - start < 1100L) {}
+    nowRTC++;
+
+    MS_DBG(F("Stepping RTC by"), -step, F("seconds for"), _rtcDrift.driftPPM,
+           F("ppm drift"));
+    setNowEpoch(nowRTC - step);
+    // Move the reference forward by the time it took to build up the step
+    _rtcDrift.lastStepEpoch += static_cast<uint32_t>(
+        static_cast<float>(step) * 1000000 / _rtcDrift.driftPPM);
+    _rtcDrift.lastStepEpoch -= step;
+    _rtcDrift.stepsSinceSync += step;
+    saveRTCDrift();
+}
+
+
+// This returns the drift rate in ppm
+float Logger::getRTCDrift(void) {
+    return _rtcDrift.driftPPM;
+}
+
+
+// This returns the days between syncs
+uint8_t Logger::getClockSyncInterval(void) {
+    return _rtcDrift.syncIntervalDays;
+}
+
+
+// This checks if the clock should be synced at the given time
+bool Logger::isClockSyncDue(uint32_t epochTime) {
+    // Always sync a clock that's obviously wrong
+    if (!isRTCSane(epochTime)) return true;
+    // Otherwise, only sync at noon
+    if (epochTime % 86400 != 43200) return false;
+    if (_rtcDrift.lastSyncEpoch == 0) return true;
+    // Allow an hour of slack so a sync done a little after noon doesn't push
+    // the next one back a full day
+    uint32_t lastSync = _rtcDrift.lastSyncEpoch +
+        ((uint32_t)_loggerRTCOffset) * 3600;
+    return epochTime + 3600 >=
+        lastSync + static_cast<uint32_t>(_rtcDrift.syncIntervalDays) * 86400;
+}
+
+
+// These keep the drift model through a restart, if there's somewhere to put it
+void Logger::loadRTCDrift(void) {
+#if defined(MS_RTC_DRIFT_EEPROM_ADDRESS) && \
+    (defined(ARDUINO_ARCH_AVR) || defined(__AVR__))
+    rtcDriftModel saved;
+    EEPROM.get(MS_RTC_DRIFT_EEPROM_ADDRESS, saved);
+    // 0x4D53 is "MS"; anything else is an empty or foreign EEPROM
+    if (saved.marker == 0x4D53) {
+        _rtcDrift = saved;
+        MS_DBG(F("Loaded RTC drift model:"), _rtcDrift.driftPPM, F("ppm"));
+    }
+#endif
+}
+void Logger::saveRTCDrift(void) {
+#if defined(MS_RTC_DRIFT_EEPROM_ADDRESS) && \
+    (defined(ARDUINO_ARCH_AVR) || defined(__AVR__))
+    _rtcDrift.marker = 0x4D53;
+    // put() only re-writes the bytes that changed
+    EEPROM.put(MS_RTC_DRIFT_EEPROM_ADDRESS, _rtcDrift);
+#endif
 }
 
 // This checks that the logger time is within a "sane" range
@@ -595,7 +911,7 @@ bool Logger::isRTCSane(uint32_t epochTime) {
 // sensor was updated, just a single marked time.  By custom, this should be
 // called before updating the sensors, not after.
 void Logger::markTime(void) {
-    Logger::markedEpochTime    = getNowEpoch();
+    Logger::markedEpochTime    = getTimeBaseEpoch();
     Logger::markedEpochTimeUTC = markedEpochTime -
         ((uint32_t)_loggerRTCOffset) * 3600;
 }
@@ -605,7 +921,7 @@ void Logger::markTime(void) {
 // rate
 bool Logger::checkInterval(void) {
     bool     retval;
-    uint32_t checkTime = getNowEpoch();
+    uint32_t checkTime = getTimeBaseEpoch();
     MS_DBG(F("Current Unix Timestamp:"), checkTime, F("->"),
            formatDateTime_ISO8601(checkTime));
     MS_DBG(F("Logging interval in seconds:"), (_loggingIntervalMinutes * 60));
@@ -703,6 +1019,28 @@ bool Logger::checkMarkedInterval(void) {
 // funcions.)
 void Logger::wakeISR(void) {
     // MS_DBG(F("\nClock interrupt!"));
+    _alarmMillis = millis();
+    _alarmFired  = true;
+}
+
+
+// Returns the number of times the processor has woken from sleep
+uint32_t Logger::getWakeCount(void) {
+    return Logger::_wakeCount;
+}
+
+
+// Finds the start of the earliest next logging interval of any logger
+uint32_t Logger::getNextIntervalEpoch(uint32_t nowEpoch) {
+    uint32_t nextInterval = 0;
+    for (Logger* l = _firstLogger; l != NULL; l = l->_nextLogger) {
+        uint32_t intervalSecs =
+            static_cast<uint32_t>(l->_loggingIntervalMinutes) * 60;
+        if (intervalSecs == 0) continue;
+        uint32_t next = nowEpoch - (nowEpoch % intervalSecs) + intervalSecs;
+        if (nextInterval == 0 || next < nextInterval) nextInterval = next;
+    }
+    return nextInterval;
 }
 
 
@@ -715,16 +1053,44 @@ void Logger::systemSleep(void) {
         return;
     }
 
+    // Take out any drift the clock has built up before working out the alarm
+    disciplineRTC();
+
+    // Find the start of the next logging interval so the alarm can be set for
+    // exactly that time.  Every logger shares the one alarm, so use the
+    // earliest next interval of all of them.  If the clock isn't sane, the
+    // interval math is meaningless, so leave the next interval as 0 and wake
+    // every minute.  Also wake every minute if the next interval is so close
+    // that it might pass before the alarm is set.
+    uint32_t nowEpoch     = getTimeBaseEpoch();
+    uint32_t nextInterval = 0;
+    if (isRTCSane(nowEpoch)) {
+        nextInterval = getNextIntervalEpoch(nowEpoch);
+        if (nextInterval != 0 && nextInterval - nowEpoch < 2) {
+            nextInterval = 0;
+        }
+    }
+
 #if defined MS_SAMD_DS3231 || not defined ARDUINO_ARCH_SAMD
 
-    // Unfortunately, because of the way the alarm on the DS3231 is set up, it
-    // cannot interrupt on any frequencies other than every second, minute,
-    // hour, day, or date.  We could set it to alarm hourly every 5 minutes past
-    // the hour, but not every 5 minutes.  This is why we set the alarm for
-    // every minute and use the checkInterval function.  This is a hardware
-    // limitation of the DS3231; it is not due to the libraries or software.
-    MS_DBG(F("Setting alarm on DS3231 RTC for every minute."));
-    rtc.enableInterrupts(EveryMinute);
+    // Because of the way the alarm on the DS3231 is set up, it cannot
+    // interrupt on any frequencies other than every second, minute, hour, day,
+    // or date.  We can't set it to alarm every 5 minutes, but we can set the
+    // daily alarm for the exact hour, minute, and second of the next logging
+    // interval and re-set it each time we go to sleep.  The every minute alarm
+    // and the checkInterval function are kept as a fall-back.
+    if (nextInterval != 0) {
+        // The alarm registers are in the RTC's time zone, not the logger's
+        DateTime nextAlarm = dtFromEpoch(nextInterval -
+                                         ((uint32_t)_loggerRTCOffset) * 3600);
+        MS_DBG(F("Setting alarm on DS3231 RTC for"),
+               formatDateTime_ISO8601(nextInterval));
+        rtc.enableInterrupts(nextAlarm.hour(), nextAlarm.minute(),
+                             nextAlarm.second());
+    } else {
+        MS_DBG(F("Setting alarm on DS3231 RTC for every minute."));
+        rtc.enableInterrupts(EveryMinute);
+    }
 
     // Clear the last interrupt flag in the RTC status register
     // The next timed interrupt will not be sent until this is cleared
@@ -741,17 +1107,38 @@ void Logger::systemSleep(void) {
     NVIC_SetPriority(RTC_IRQn, 0);  // highest priority
 
     // Alarms on the RTC built into the SAMD21 appear to be identical to those
-    // in the DS3231.  See more notes below.
-    // We're setting the alarm seconds to 59 and then seting it to go off
-    // whenever the seconds match the 59.  I'm using 59 instead of 00
-    // because there seems to be a bit of a wake-up delay
-    MS_DBG(F("Setting alarm on SAMD built-in RTC for every minute."));
+    // in the DS3231.  See more notes above.
+    // We're setting the alarm for one second before the next interval (or to
+    // the seconds matching 59 if we can't find the next interval).  I'm using
+    // 59 instead of 00 because there seems to be a bit of a wake-up delay
     zero_sleep_rtc.attachInterrupt(wakeISR);
-    zero_sleep_rtc.setAlarmSeconds(59);
-    zero_sleep_rtc.enableAlarm(zero_sleep_rtc.MATCH_SS);
+    if (nextInterval != 0) {
+        // The alarm registers are in the RTC's time zone, not the logger's
+        DateTime earlyAlarm = dtFromEpoch(
+            nextInterval - 1 - ((uint32_t)_loggerRTCOffset) * 3600);
+        MS_DBG(F("Setting alarm on SAMD built-in RTC for"),
+               formatDateTime_ISO8601(nextInterval - 1));
+        zero_sleep_rtc.setAlarmTime(earlyAlarm.hour(), earlyAlarm.minute(),
+                                    earlyAlarm.second());
+        zero_sleep_rtc.enableAlarm(zero_sleep_rtc.MATCH_HHMMSS);
+    } else {
+        MS_DBG(F("Setting alarm on SAMD built-in RTC for every minute."));
+        zero_sleep_rtc.setAlarmSeconds(59);
+        zero_sleep_rtc.enableAlarm(zero_sleep_rtc.MATCH_SS);
+    }
 
 #endif
 
+    // Forget any earlier alarm so the time base isn't anchored to it
+    _alarmFired = false;
+
+    // Events caught by interrupt are timed from millis(), which is about to
+    // stop, so stamp them while it still matches the time base
+    if (_internalArray != NULL) _internalArray->sensorsTimestampEvents();
+
+    // This has to be done while the I2C bus is still up
+    LoggerClock::markPhase(LOGGER_PHASE_SLEEP);
+
     // Send one last message before shutting down serial ports
     MS_DBG(F("Putting processor to sleep.  ZZzzz..."));
 
@@ -768,7 +1155,7 @@ void Logger::systemSleep(void) {
     // Stop any I2C connections
     // This function actually disables the two-wire pin functionality and
     // turns off the internal pull-up resistors.
-    Wire.end();
+    I2CBus::getBus()->end();
 // Now force the I2C pins to LOW
 // I2C devices have a nasty habit of stealing power from the SCL and SDA pins...
 // This will only work for the "main" I2C/TWI interface
@@ -863,16 +1250,8 @@ void Logger::systemSleep(void) {
     // -- The portion below this happens on wake up, after any wake ISR's --
 
 #if defined ARDUINO_ARCH_SAMD
-    // Reattach the USB after waking
     // Enable systick interrupt
     SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
-    if (restoreUSBDevice) {
-#ifndef USE_TINYUSB
-        USBDevice.attach();
-#endif
-        uint32_t startTimer = millis();
-        while (!SERIAL_PORT_USBVIRTUAL && ((millis() - startTimer) < 1000L)) {}
-    }
 #endif
 
 #if defined ARDUINO_ARCH_AVR
@@ -907,15 +1286,8 @@ void Logger::systemSleep(void) {
 #ifdef SCL
     pinMode(SCL, INPUT_PULLUP);
 #endif
-    Wire.begin();
-    // Eliminate any potential extra waits in the wire library
-    // These waits would be caused by a readBytes or parseX being called
-    // on wire after the Wire buffer has emptied.  The default stream
-    // functions - used by wire - wait a timeout period after reading the
-    // end of the buffer to see if an interrupt puts something into the
-    // buffer.  In the case of the Wire library, that will never happen and
-    // the timeout period is a useless delay.
-    Wire.setTimeout(0);
+    // This also removes the stream timeout from the Wire library
+    I2CBus::getBus()->begin();
 
 #if defined MS_SAMD_DS3231 || not defined ARDUINO_ARCH_SAMD
     // Stop the clock from sending out any interrupts while we're awake.
@@ -929,8 +1301,29 @@ void Logger::systemSleep(void) {
     zero_sleep_rtc.disableAlarm();
 #endif
 
+    // millis() stopped while we slept, so re-anchor the time base.  Do this
+    // before anything slow, so an alarm wake is paired with the second it
+    // fired on.  Any other wake waits for the next tick of the clock.
+    anchorTimeBase(true);
+    LoggerClock::markPhase(LOGGER_PHASE_AWAKE);
+
+#if defined ARDUINO_ARCH_SAMD
+    // Reattach the USB after waking
+    if (restoreUSBDevice) {
+#ifndef USE_TINYUSB
+        USBDevice.attach();
+#endif
+        uint32_t startTimer = millis();
+        while (!SERIAL_PORT_USBVIRTUAL && ((millis() - startTimer) < 1000L)) {}
+    }
+#endif
+
+    // Count the wake
+    Logger::_wakeCount++;
+
     // Wake-up message
-    MS_DBG(F("\n\n\n... zzzZZ Processor is now awake!"));
+    MS_DBG(F("\n\n\n... zzzZZ Processor is now awake!"), F("Wake number"),
+           Logger::_wakeCount);
 
     // The logger will now start the next function after the systemSleep
     // function in either the loop or setup
@@ -959,7 +1352,10 @@ void Logger::generateAutoFileName(void) {
     // Generate the file name from logger ID and date
     String fileName = String(_loggerID);
     fileName += "_";
-    fileName += formatDateTime_ISO8601(getNowEpoch()).substring(0, 10);
+    char dateTimeStr[ISO8601_BUFFER_SIZE];
+    formatDateTime_ISO8601(getNowEpoch(), dateTimeStr);
+    dateTimeStr[10] = '\0';
+    fileName += dateTimeStr;
     fileName += ".csv";
     setFileName(fileName);
     _fileName = fileName;
@@ -1027,10 +1423,10 @@ void Logger::printFileHeader(Stream* stream) {
 // This prints a comma separated list of volues of sensor data - including the
 // time -  out over an Arduino stream
 void Logger::printSensorDataCSV(Stream* stream) {
-    String csvString = "";
-    dtFromEpoch(Logger::markedEpochTime).addToString(csvString);
-    csvString += ',';
-    stream->print(csvString);
+    char dateTimeStr[ISO8601_BUFFER_SIZE];
+    formatDateTime_CSV(Logger::markedEpochTime, dateTimeStr);
+    stream->print(dateTimeStr);
+    stream->print(',');
     for (uint8_t i = 0; i < getArrayVarCount(); i++) {
         stream->print(getValueStringAtI(i));
         if (i + 1 != getArrayVarCount()) { stream->print(','); }
@@ -1063,11 +1459,10 @@ bool Logger::initializeSDCard(void) {
 
 // Protected helper function - This sets a timestamp on a file
 void Logger::setFileTimestamp(File fileToStamp, uint8_t stampFlag) {
-    fileToStamp.timestamp(
-        stampFlag, dtFromEpoch(getNowEpoch()).year(),
-        dtFromEpoch(getNowEpoch()).month(), dtFromEpoch(getNowEpoch()).date(),
-        dtFromEpoch(getNowEpoch()).hour(), dtFromEpoch(getNowEpoch()).minute(),
-        dtFromEpoch(getNowEpoch()).second());
+    DateTime stampTime = dtFromEpoch(getTimeBaseEpoch());
+    fileToStamp.timestamp(stampFlag, stampTime.year(), stampTime.month(),
+                          stampTime.date(), stampTime.hour(),
+                          stampTime.minute(), stampTime.second());
 }
 
 
@@ -1230,6 +1625,68 @@ bool Logger::logToSD(void) {
 }
 
 
+#ifdef MS_BURST_SAMPLING
+// This appends the most recent burst of each sensor to a binary file
+bool Logger::logBurstToSD(String& filename) {
+    if (_internalArray == NULL) return false;
+
+    // Create the file if needed, but don't write a csv header to it
+    if (!openFile(filename, true, false)) {
+        PRINTOUT(F("Unable to write to SD card!"));
+        return false;
+    }
+
+    uint8_t nVars = _internalArray->getVariableCount();
+    for (uint8_t i = 0; i < nVars; i++) {
+        Variable* var = _internalArray->arrayOfVars[i];
+        if (var->isCalculated) continue;
+        Sensor* sensor = var->parentSensor;
+        if (!sensor->isBurstEnabled() || sensor->getBurstSampleCount() == 0) {
+            continue;
+        }
+        // Only write each sensor once, at its first variable
+        bool seen = false;
+        for (uint8_t j = 0; j < i && !seen; j++) {
+            seen = !_internalArray->arrayOfVars[j]->isCalculated &&
+                _internalArray->arrayOfVars[j]->parentSensor == sensor;
+        }
+        if (seen) continue;
+
+        // Work back from the current time to the start of the burst
+        uint16_t milliseconds;
+        uint32_t burstEpoch = getTimeBaseEpoch(milliseconds);
+        uint32_t ago        = millis() - sensor->getBurstStartMillis();
+        burstEpoch -= ago / 1000;
+        ago %= 1000;
+        if (ago > milliseconds) {
+            burstEpoch--;
+            milliseconds += 1000;
+        }
+        milliseconds -= ago;
+
+        logFile.write(reinterpret_cast<const uint8_t*>(&burstEpoch),
+                      sizeof(burstEpoch));
+        logFile.write(reinterpret_cast<const uint8_t*>(&milliseconds),
+                      sizeof(milliseconds));
+        logFile.write(i);
+        sensor->writeBurst(&logFile);
+    }
+
+    // Set write/modification date time
+    setFileTimestamp(logFile, T_WRITE);
+    // Set access date time
+    setFileTimestamp(logFile, T_ACCESS);
+    // Close the file to save it
+    logFile.close();
+    return true;
+}
+bool Logger::logBurstToSD(void) {
+    String filename = String(_loggerID) + F("_burst.bin");
+    return logBurstToSD(filename);
+}
+#endif
+
+
 // ===================================================================== //
 // Public functions for a "sensor testing" mode
 // ===================================================================== //
@@ -1424,19 +1881,10 @@ void Logger::begin() {
 #ifdef SCL
     pinMode(SCL, INPUT_PULLUP);
 #endif
-    MS_DBG(F("Beginning wire (I2C)"));
-    Wire.begin();
+    // This also removes the stream timeout from the Wire library
+    I2CBus::getBus()->begin();
     watchDogTimer.resetWatchDog();
 
-    // Eliminate any potential extra waits in the wire library
-    // These waits would be caused by a readBytes or parseX being called
-    // on wire after the Wire buffer has emptied.  The default stream
-    // functions - used by wire - wait a timeout period after reading the
-    // end of the buffer to see if an interrupt puts something into the
-    // buffer.  In the case of the Wire library, that will never happen and
-    // the timeout period is a useless delay.
-    Wire.setTimeout(0);
-
 #if defined MS_SAMD_DS3231 || not defined ARDUINO_ARCH_SAMD
     if (_mcuWakePin < 0) {
         MS_DBG(F("Logger mcu will not sleep between readings!"));
@@ -1449,6 +1897,12 @@ void Logger::begin() {
 #endif
     watchDogTimer.resetWatchDog();
 
+    // Pick up the drift model from before the restart, if it was saved
+    loadRTCDrift();
+
+    // Start the millis() time base
+    anchorTimeBase(true);
+
     // Print out the current time
     PRINTOUT(F("Current RTC time is:"), formatDateTime_ISO8601(getNowEpoch()));
 
@@ -1497,13 +1951,16 @@ void Logger::logData(void) {
         // Do a complete sensor update
         MS_DBG(F("    Running a complete sensor update..."));
         watchDogTimer.resetWatchDog();
+        LoggerClock::markPhase(LOGGER_PHASE_SENSORS);
         _internalArray->completeUpdate();
         watchDogTimer.resetWatchDog();
 
         // Create a csv data record and save it to the log file
+        LoggerClock::markPhase(LOGGER_PHASE_SD_WRITE);
         logToSD();
         // Cut power from the SD card, waiting for housekeeping
         turnOffSDcard(true);
+        LoggerClock::markPhase(LOGGER_PHASE_AWAKE);
 
         // Turn off the LED
         alertOff();
@@ -1549,29 +2006,43 @@ void Logger::logDataAndPublish(void) {
         // to run if the sensor was not previously set up.
         MS_DBG(F("Running a complete sensor update..."));
         watchDogTimer.resetWatchDog();
+        LoggerClock::markPhase(LOGGER_PHASE_SENSORS);
         _internalArray->completeUpdate();
         watchDogTimer.resetWatchDog();
 
         // Create a csv data record and save it to the log file
+        LoggerClock::markPhase(LOGGER_PHASE_SD_WRITE);
         logToSD();
-
-        if (_logModem != NULL) {
+        LoggerClock::markPhase(LOGGER_PHASE_AWAKE);
+
+        // If recent connections have failed on a weak signal, don't waste
+        // power trying again now.  The data is already saved on the SD card.
+        // Always try if the clock needs to be set.
+        if (_logModem != NULL && isRTCSane(Logger::markedEpochTime) &&
+            !_logModem->shouldAttemptConnection()) {
+            MS_DBG(F("Skipping internet connection this interval."));
+        } else if (_logModem != NULL) {
             MS_DBG(F("Waking up"), _logModem->getModemName(), F("..."));
+            LoggerClock::markPhase(LOGGER_PHASE_MODEM_CONNECT);
             if (_logModem->modemWake()) {
                 // Connect to the network
                 watchDogTimer.resetWatchDog();
                 MS_DBG(F("Connecting to the Internet..."));
-                if (_logModem->connectInternet()) {
+                uint32_t connectStart = millis();
+                bool     connected    = _logModem->connectInternet(
+                    _logModem->getAdaptiveConnectionTime());
+                _logModem->recordConnectionAttempt(connected,
+                                                   millis() - connectStart);
+                if (connected) {
                     // Publish data to remotes
                     watchDogTimer.resetWatchDog();
+                    LoggerClock::markPhase(LOGGER_PHASE_PUBLISH);
                     publishDataToRemotes();
                     watchDogTimer.resetWatchDog();
 
-                    if ((Logger::markedEpochTime != 0 &&
-                         Logger::markedEpochTime % 86400 == 43200) ||
-                        !isRTCSane(Logger::markedEpochTime)) {
-                        // Sync the clock at noon
-                        MS_DBG(F("Running a daily clock sync..."));
+                    if (isClockSyncDue(Logger::markedEpochTime)) {
+                        // Sync the clock at noon, as often as the drift needs
+                        MS_DBG(F("Running a clock sync..."));
                         setRTClock(_logModem->getNISTTime());
                         watchDogTimer.resetWatchDog();
                     }
@@ -1587,9 +2058,13 @@ void Logger::logDataAndPublish(void) {
                     MS_DBG(F("Could not connect to the internet!"));
                     watchDogTimer.resetWatchDog();
                 }
+            } else {
+                // A modem that won't wake counts against connecting, too
+                _logModem->recordFailedWake();
             }
             // Turn the modem off
             _logModem->modemSleepPowerDown();
+            LoggerClock::markPhase(LOGGER_PHASE_AWAKE);
         }
 
 
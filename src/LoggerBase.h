@@ -26,6 +26,8 @@
 #undef MS_DEBUGGING_STD
 #include "VariableArray.h"
 #include "LoggerModem.h"
+#include "I2CBus.h"
+#include "LoggerClock.h"
 
 // Bring in the libraries to handle the processor sleep/standby modes
 // The SAMD library can also the built-in clock on those modules
@@ -51,6 +53,14 @@
  */
 #define EPOCH_TIME_OFF 946684800
 
+/**
+ * @brief The size of a character buffer needed to hold an ISO8601 formatted
+ * date and time, including the time zone and the terminating NULL.
+ *
+ * ie, `2020-01-01T12:00:00-05:00`
+ */
+#define ISO8601_BUFFER_SIZE 26
+
 #include <SdFat.h>  // To communicate with the SD card
 
 /**
@@ -58,6 +68,42 @@
  */
 #define MAX_NUMBER_SENDERS 4
 
+#ifndef MS_RTC_DRIFT_MIN_BASELINE
+/**
+ * @brief The shortest time (in seconds) between two clock syncs that will be
+ * used to estimate the drift rate of the real time clock.
+ *
+ * NIST only gives whole seconds, so shorter baselines give a drift estimate
+ * that is mostly rounding noise.  The default is 12 hours.
+ */
+#define MS_RTC_DRIFT_MIN_BASELINE 43200L
+#endif
+
+#ifndef MS_RTC_MAX_SYNC_DAYS
+/**
+ * @brief The most days that will be allowed to pass between clock syncs once
+ * the drift of the real time clock is well modeled.
+ */
+#define MS_RTC_MAX_SYNC_DAYS 7
+#endif
+
+#ifndef MS_RTC_MAX_DRIFT_ERROR
+/**
+ * @brief The largest error (in seconds) the disciplined clock is allowed to
+ * build up between clock syncs.
+ *
+ * This is used to stretch the interval between syncs as the drift model
+ * improves.
+ */
+#define MS_RTC_MAX_DRIFT_ERROR 2
+#endif
+
+#if defined(MS_RTC_DRIFT_EEPROM_ADDRESS) && \
+    (defined(ARDUINO_ARCH_AVR) || defined(__AVR__))
+// To keep the clock drift model through a restart
+#include <EEPROM.h>
+#endif
+
 
 class dataPublisher;  // Forward declaration
 
@@ -633,6 +679,49 @@ class Logger {
      */
     static void setNowEpoch(uint32_t ts);
 
+    /**
+     * @brief Get the current epoch time from the millis() time base, without
+     * reading the real time clock.
+     *
+     * The time base is anchored to the RTC each time the logger wakes from
+     * systemSleep() and whenever the clock is set, so the time is only an
+     * arithmetic lookup.  Use this instead of getNowEpoch() anywhere the time
+     * is needed often.  The time base itself is kept by LoggerClock, so
+     * sensors can read it with LoggerClock::getEpoch() without the logger.
+     *
+     * @note millis() does not run while the processor sleeps.  If the
+     * processor is put to sleep by anything other than systemSleep(), call
+     * anchorTimeBase() after it wakes.
+     *
+     * @return **uint32_t** The number of seconds from January 1, 1970 in the
+     * logging time zone.
+     */
+    static uint32_t getTimeBaseEpoch(void);
+    /**
+     * @brief Get the current epoch time and the milliseconds into the current
+     * second from the millis() time base.
+     *
+     * @param milliseconds Reference to a variable to hold the milliseconds
+     * past the returned second, 0-999.
+     * @return **uint32_t** The number of seconds from January 1, 1970 in the
+     * logging time zone.
+     */
+    static uint32_t getTimeBaseEpoch(uint16_t& milliseconds);
+    /**
+     * @brief Anchor the millis() time base to the real time clock.
+     *
+     * If the logger was just woken by the clock alarm, the millis() at the
+     * alarm is used, since the alarm fires on the tick of a second.  The
+     * clock is read as soon as possible after waking, so the whole seconds
+     * since the alarm are known.  Otherwise, the time base can only be placed
+     * within the second unless the function waits for the clock to tick over.
+     * systemSleep() waits after any wake that wasn't the alarm.
+     *
+     * @param waitForTick True to wait (up to a second) for the next tick of
+     * the clock to anchor the fraction of the second; default false.
+     */
+    static void anchorTimeBase(bool waitForTick = false);
+
     /**
      * @brief Convert the number of seconds from January 1, 1970 to a DateTime
      * object instance.
@@ -664,6 +753,32 @@ class Logger {
      */
     static String formatDateTime_ISO8601(uint32_t epochTime);
 
+    /**
+     * @brief Write an epoch time (unix time) into a character buffer as an
+     * ISO8601 formatted string.
+     *
+     * This assumes the supplied date/time is in the LOGGER's timezone and adds
+     * the LOGGER's offset as the time zone offset in the string.  The output
+     * is identical to that of the String version, but no String or DateTime
+     * is created unless the date has changed since the last call.
+     *
+     * @param epochTime The number of seconds since 1970.
+     * @param buffer A character buffer of at least #ISO8601_BUFFER_SIZE
+     * characters.
+     */
+    static void formatDateTime_ISO8601(uint32_t epochTime, char* buffer);
+    /**
+     * @brief Write an epoch time (unix time) into a character buffer as a
+     * date and time separated by a space, as used in the csv files.
+     *
+     * The output is identical to that of DateTime::addToString() - ie,
+     * `2020-01-01 12:00:00` - with no time zone.
+     *
+     * @param epochTime The number of seconds since 1970.
+     * @param buffer A character buffer of at least 20 characters.
+     */
+    static void formatDateTime_CSV(uint32_t epochTime, char* buffer);
+
     /**
      * @brief Veify that the input value is sane and if so sets the real time
      * clock to the given time.
@@ -728,6 +843,51 @@ class Logger {
      */
     bool checkMarkedInterval(void);
 
+    /**
+     * @brief Step the real time clock by the drift it is predicted to have
+     * built up since it was last set.
+     *
+     * The drift rate is estimated from the offsets found at successive clock
+     * syncs.  Rather than adding the predicted correction to every timestamp,
+     * the clock itself is stepped so that the RTC alarms and getNowEpoch()
+     * always agree.  The clock is only stepped when the predicted error is at
+     * least a whole second and the next logging interval is not close enough
+     * that the step could skip or repeat it.
+     *
+     * This is called by systemSleep() before setting the next alarm.
+     */
+    void disciplineRTC(void);
+
+    /**
+     * @brief Get the estimated drift rate of the real time clock.
+     *
+     * @return **float** The drift rate in parts per million; positive if the
+     * clock runs fast.  Returns 0 until there have been two clock syncs at
+     * least #MS_RTC_DRIFT_MIN_BASELINE seconds apart.
+     */
+    static float getRTCDrift(void);
+
+    /**
+     * @brief Get the number of days between clock syncs given the current
+     * drift model.
+     *
+     * @return **uint8_t** The number of days between syncs, between 1 and
+     * #MS_RTC_MAX_SYNC_DAYS.
+     */
+    static uint8_t getClockSyncInterval(void);
+
+    /**
+     * @brief Check if a clock sync is due at the given time.
+     *
+     * Syncs are done at noon, but only once the number of days from
+     * getClockSyncInterval() have passed since the last sync.  A sync is always
+     * due if the clock is not sane or has never been synced.
+     *
+     * @param epochTime The time to check, in the logger's time zone.
+     * @return **bool** True if the clock should be synced.
+     */
+    static bool isClockSyncDue(uint32_t epochTime);
+
  protected:
     /**
      * @brief The static timezone data is being logged in.
@@ -744,6 +904,88 @@ class Logger {
      * same offset.
      */
     static int8_t _loggerRTCOffset;
+
+    /**
+     * @brief Write the date and time into a character buffer, using the
+     * cached date and time zone if they haven't changed.
+     *
+     * @param epochTime The number of seconds since 1970.
+     * @param buffer The character buffer to write to.
+     * @param separator The character between the date and the time.
+     * @param addTimeZone True to add the time zone to the end.
+     */
+    static void formatDateTime(uint32_t epochTime, char* buffer,
+                               char separator, bool addTimeZone);
+    /**
+     * @brief The day (days since 1970) of the cached date string
+     */
+    static uint32_t _cachedDay;
+    /**
+     * @brief The cached date - `YYYY-MM-DD`
+     */
+    static char _cachedDate[11];
+    /**
+     * @brief The logger time zone of the cached time zone string
+     */
+    static int8_t _cachedTimeZone;
+    /**
+     * @brief The cached ISO8601 time zone string - ie `Z` or `-05:00`
+     */
+    static char _cachedTimeZoneString[7];
+
+    /**
+     * @brief The model of the real time clock drift, built up from the offset
+     * found at each clock sync.
+     *
+     * All times are in the timezone of the RTC.
+     */
+    typedef struct {
+        uint16_t marker;  ///< Marks a saved model as valid
+        float    driftPPM;  ///< The drift rate, ppm, positive if running fast
+        uint8_t  driftSamples;      ///< The number of drift measurements
+        uint8_t  syncIntervalDays;  ///< The days between syncs
+        uint32_t lastSyncEpoch;     ///< The time of the last sync
+        int32_t  syncError;  ///< The seconds the RTC was ahead after the sync
+        uint32_t lastStepEpoch;   ///< The time the RTC was last set or stepped
+        int32_t  stepsSinceSync;  ///< The seconds stepped back since the sync
+    } rtcDriftModel;
+    /**
+     * @brief The static clock drift model
+     *
+     * @note All logger objects, if multiple are used, share one clock.
+     */
+    static rtcDriftModel _rtcDrift;
+
+    /**
+     * @brief The millis() when the clock alarm last fired
+     */
+    static volatile uint32_t _alarmMillis;
+    /**
+     * @brief True if the clock alarm has fired since the logger was last put
+     * to sleep
+     */
+    static volatile bool _alarmFired;
+    /**
+     * @brief Update the drift model with the offset found at a clock sync.
+     *
+     * @param rtcEpoch The time on the RTC, in the RTC's time zone.
+     * @param trueEpoch The time from NIST, in the RTC's time zone.
+     */
+    static void updateRTCDrift(uint32_t rtcEpoch, uint32_t trueEpoch);
+    /**
+     * @brief Read a saved drift model from the EEPROM, if one was saved there.
+     *
+     * This does nothing unless #MS_RTC_DRIFT_EEPROM_ADDRESS is defined and the
+     * board is an AVR.
+     */
+    static void loadRTCDrift(void);
+    /**
+     * @brief Save the drift model to the EEPROM.
+     *
+     * This does nothing unless #MS_RTC_DRIFT_EEPROM_ADDRESS is defined and the
+     * board is an AVR.
+     */
+    static void saveRTCDrift(void);
     /**@}*/
 
     // ===================================================================== //
@@ -759,7 +1001,8 @@ class Logger {
     /**
      * @brief Set up the Interrupt Service Request for waking
      *
-     * In this case, we're doing nothing, we just want the processor to wake.
+     * All this does is note the millis() of the alarm so the time base can be
+     * anchored to it; we just want the processor to wake.
      * This must be a static function (which means it can only call other static
      * funcions.)
      */
@@ -769,10 +1012,26 @@ class Logger {
      * @brief Put the mcu to sleep to conserve battery life and handle
      * post-interrupt wake actions
      *
+     * The RTC alarm is set for the start of the next logging interval of
+     * any logger, so the processor is not woken until there is something to
+     * do.  If the clock is not sane, the alarm is set for every minute
+     * instead.
+     *
      * @note This DOES NOT sleep or wake the sensors!!
      */
     void systemSleep(void);
 
+    /**
+     * @brief Get the number of times the processor has been woken from
+     * systemSleep() since the program started.
+     *
+     * This counts every wake, whether it was from the clock alarm or from
+     * another interrupt, like the testing button.
+     *
+     * @return **uint32_t** The number of wakes
+     */
+    static uint32_t getWakeCount(void);
+
 #if defined(ARDUINO_ARCH_SAMD)
     /**
      * @brief A watch-dog implementation to use to reboot the system in case of
@@ -786,6 +1045,44 @@ class Logger {
      */
     extendedWatchDogAVR watchDogTimer;
 #endif
+
+ protected:
+    /**
+     * @brief The number of times the processor has been woken from
+     * systemSleep() since the program started.
+     */
+    static uint32_t _wakeCount;
+    /**
+     * @brief The first of all of the loggers that exist.
+     *
+     * All loggers share the one RTC alarm, so systemSleep() sets it for the
+     * earliest next interval of any of them.
+     */
+    static Logger* _firstLogger;
+    /**
+     * @brief The next logger after this one in the list of all loggers.
+     */
+    Logger* _nextLogger;
+    /**
+     * @brief Add this logger to the list of all loggers.
+     */
+    void addToLoggerList(void);
+    /**
+     * @brief Re-anchor the time base, waiting for the clock to tick.
+     *
+     * This is given to LoggerClock::setAnchorFunction() so the time base can
+     * be re-anchored when it gets old.
+     */
+    static void reanchorTimeBase(void);
+    /**
+     * @brief Get the start of the earliest next logging interval of all of
+     * the loggers.
+     *
+     * @param nowEpoch The current epoch time in the logger's time zone
+     * @return **uint32_t** The start of the next logging interval, or 0 if
+     * there isn't one.
+     */
+    static uint32_t getNextIntervalEpoch(uint32_t nowEpoch);
     /**@}*/
 
     // ===================================================================== //
@@ -921,6 +1218,32 @@ class Logger {
      */
     bool logToSD(void);
 
+#ifdef MS_BURST_SAMPLING
+    /**
+     * @brief Append the raw results of the most recent burst of each sensor
+     * with burst sampling on to a binary file on the SD card.
+     *
+     * Each sensor's record starts with the time of the first sample of the
+     * burst as a uint32_t epoch time in the logger time zone, the uint16_t
+     * milliseconds past that second, and the uint8_t position in the variable
+     * array of the sensor's first variable.  The rest of the record is as
+     * written by Sensor::writeBurst().
+     *
+     * @param filename The name of the file to write to
+     * @return **bool** True if the file was successfully accessed or created
+     * _and_ the burst appended to it.
+     */
+    bool logBurstToSD(String& filename);
+    /**
+     * @brief Append the raw results of the most recent burst of each sensor
+     * to a binary file named with the logger ID and "_burst.bin".
+     *
+     * @return **bool** True if the file was successfully accessed or created
+     * _and_ the burst appended to it.
+     */
+    bool logBurstToSD(void);
+#endif
+
  protected:
     // The SD card and file
     /**
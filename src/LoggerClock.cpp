@@ -0,0 +1,85 @@
+/**
+ * @file LoggerClock.cpp
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the LoggerClock class.
+ */
+
+#include "LoggerClock.h"
+
+// Initialize the time base
+uint32_t             LoggerClock::_anchorEpoch    = 0;
+uint32_t             LoggerClock::_anchorMillis   = 0;
+loggerAnchorFunction LoggerClock::_anchorFunction = NULL;
+// Initialize the phase timing
+loggerPhaseCallback LoggerClock::_phaseCallback    = NULL;
+uint8_t             LoggerClock::_phase            = LOGGER_PHASE_AWAKE;
+uint32_t            LoggerClock::_phaseStartMillis = 0;
+uint32_t            LoggerClock::_phaseStartEpoch  = 0;
+uint16_t            LoggerClock::_phaseStartMs     = 0;
+
+
+// This gets the current epoch time from millis(), as anchored to the RTC
+uint32_t LoggerClock::getEpoch(void) {
+    uint16_t milliseconds;
+    return getEpoch(milliseconds);
+}
+uint32_t LoggerClock::getEpoch(uint16_t& milliseconds) {
+    if (_anchorFunction != NULL &&
+        (_anchorEpoch == 0 ||
+         millis() - _anchorMillis > MS_TIME_BASE_MAX_AGE)) {
+        _anchorFunction();
+    }
+    uint32_t elapsed = millis() - _anchorMillis;
+    milliseconds     = elapsed % 1000;
+    return _anchorEpoch + elapsed / 1000;
+}
+
+
+void LoggerClock::setAnchor(uint32_t epoch, uint32_t anchorMillis) {
+    _anchorEpoch  = epoch;
+    _anchorMillis = anchorMillis;
+    MS_DBG(F("Time base anchored at"), epoch, F("to millis"), anchorMillis);
+}
+
+
+void LoggerClock::setAnchorFunction(loggerAnchorFunction anchorFunction) {
+    _anchorFunction = anchorFunction;
+}
+
+
+// This sets a function to be told about each phase of the logging cycle
+void LoggerClock::setPhaseCallback(loggerPhaseCallback callback) {
+    _phaseCallback    = callback;
+    _phase            = LOGGER_PHASE_AWAKE;
+    _phaseStartMillis = millis();
+    _phaseStartEpoch  = getEpoch(_phaseStartMs);
+}
+
+
+// This tells the phase callback how long the last phase took
+void LoggerClock::markPhase(uint8_t phase) {
+    if (_phaseCallback == NULL || phase == _phase) return;
+
+    uint32_t nowMillis = millis();
+    uint16_t nowMs;
+    uint32_t nowEpoch = getEpoch(nowMs);
+
+    uint32_t phaseTime_ms;
+    if (_phase == LOGGER_PHASE_SLEEP) {
+        // millis() stopped while asleep, so use the re-anchored time base
+        phaseTime_ms = (nowEpoch - _phaseStartEpoch) * 1000L + nowMs -
+            _phaseStartMs;
+    } else {
+        // The time base could jump if the clock was set in the phase
+        phaseTime_ms = nowMillis - _phaseStartMillis;
+    }
+
+    _phase            = phase;
+    _phaseStartMillis = nowMillis;
+    _phaseStartEpoch  = nowEpoch;
+    _phaseStartMs     = nowMs;
+    _phaseCallback(phase, phaseTime_ms);
+}
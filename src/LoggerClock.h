@@ -0,0 +1,180 @@
+/**
+ * @file LoggerClock.h
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the LoggerClock class, which keeps the millis() time base
+ * the logger anchors to its real time clock and times the phases of the
+ * logging cycle.
+ */
+
+// Header Guards
+#ifndef SRC_LOGGERCLOCK_H_
+#define SRC_LOGGERCLOCK_H_
+
+// Debugging Statement
+// #define MS_LOGGERCLOCK_DEBUG
+
+#ifdef MS_LOGGERCLOCK_DEBUG
+#define MS_DEBUGGING_STD "LoggerClock"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Arduino.h>
+
+#ifndef MS_TIME_BASE_MAX_AGE
+/**
+ * @brief The longest time (in milliseconds) the millis() time base will be
+ * used before it is re-anchored to the real time clock.
+ *
+ * The time base is re-anchored at every wake from Logger::systemSleep(), so
+ * this only matters for loggers that stay awake.  The default is one hour.
+ */
+#define MS_TIME_BASE_MAX_AGE 3600000L
+#endif
+
+/**
+ * @brief A function that re-anchors the time base to a real time clock.
+ */
+typedef void (*loggerAnchorFunction)(void);
+
+/**
+ * @brief The phases of a logging cycle, as reported to the function set with
+ * LoggerClock::setPhaseCallback().
+ */
+typedef enum loggerPhase {
+    LOGGER_PHASE_AWAKE = 0,      ///< Awake, but not in any other phase
+    LOGGER_PHASE_SENSORS,        ///< Powering, waking, and reading the sensors
+    LOGGER_PHASE_SD_WRITE,       ///< Writing the data to the SD card
+    LOGGER_PHASE_MODEM_CONNECT,  ///< Waking the modem and connecting
+    LOGGER_PHASE_PUBLISH,        ///< Sending data to the remotes
+    LOGGER_PHASE_SLEEP,          ///< Asleep
+    LOGGER_NUM_PHASES            ///< The number of phases
+} loggerPhase;
+
+/**
+ * @brief A function to be told each time the logger moves to a new phase of
+ * the logging cycle.
+ *
+ * The first argument is the #loggerPhase being entered and the second is the
+ * time in milliseconds the logger spent in the phase it is leaving.
+ */
+typedef void (*loggerPhaseCallback)(uint8_t, uint32_t);
+
+/**
+ * @brief The millis() time base shared by the logger and the sensors.
+ *
+ * The Logger owns the real time clock, but sensors that keep time between
+ * wakes (a brush period, a tip log) only need to know what time it is.  They
+ * get it from here, so they don't depend on the Logger.
+ *
+ * The Logger anchors the time base with setAnchor() each time it wakes and
+ * whenever its clock is set, and gives setAnchorFunction() a way to re-anchor
+ * it once it is older than #MS_TIME_BASE_MAX_AGE.  Until a logger has
+ * anchored it, the time base counts seconds from the processor start, which
+ * is still good for timing intervals.
+ *
+ * The logger also marks each phase of its logging cycle here with
+ * markPhase(), so a power profiler can be told about them with
+ * setPhaseCallback() without depending on the Logger either.
+ */
+class LoggerClock {
+ public:
+    /**
+     * @brief Get the current epoch time from the millis() time base, without
+     * reading the real time clock.
+     *
+     * @note millis() does not run while the processor sleeps.  If the
+     * processor is put to sleep by anything other than Logger::systemSleep(),
+     * call Logger::anchorTimeBase() after it wakes.
+     *
+     * @return **uint32_t** The number of seconds from January 1, 1970 in the
+     * logging time zone.
+     */
+    static uint32_t getEpoch(void);
+    /**
+     * @brief Get the current epoch time and the milliseconds into the current
+     * second from the millis() time base.
+     *
+     * @param milliseconds Reference to a variable to hold the milliseconds
+     * past the returned second, 0-999.
+     * @return **uint32_t** The number of seconds from January 1, 1970 in the
+     * logging time zone.
+     */
+    static uint32_t getEpoch(uint16_t& milliseconds);
+    /**
+     * @brief Anchor the time base.
+     *
+     * @param epoch The epoch time, in the logging time zone, of the anchor
+     * @param anchorMillis The millis() at the tick of that second
+     */
+    static void setAnchor(uint32_t epoch, uint32_t anchorMillis);
+    /**
+     * @brief Set the function to call when the time base needs to be
+     * re-anchored.
+     *
+     * @param anchorFunction The function, or NULL for none
+     */
+    static void setAnchorFunction(loggerAnchorFunction anchorFunction);
+
+    /**
+     * @brief Set a function to be called each time the logger moves to a new
+     * phase of the logging cycle.
+     *
+     * This is meant for profiling the power used by the logger;
+     * TIINA219::beginProfiling() sets it.  The time spent asleep is measured
+     * with the time base, because millis() stops while the processor sleeps.
+     *
+     * @param callback The function to call, or NULL to stop calling it.
+     */
+    static void setPhaseCallback(loggerPhaseCallback callback);
+    /**
+     * @brief Tell the phase callback, if there is one, that the logger is
+     * moving to a new phase.
+     *
+     * @param phase The #loggerPhase being entered
+     */
+    static void markPhase(uint8_t phase);
+
+ protected:
+    /**
+     * @brief The epoch time, in the logging time zone, of the anchor
+     */
+    static uint32_t _anchorEpoch;
+    /**
+     * @brief The millis() at the tick of the second #_anchorEpoch
+     */
+    static uint32_t _anchorMillis;
+    /**
+     * @brief The function to re-anchor the time base
+     */
+    static loggerAnchorFunction _anchorFunction;
+
+    /**
+     * @brief The function to call at each change of phase
+     */
+    static loggerPhaseCallback _phaseCallback;
+    /**
+     * @brief The phase the logger is in
+     */
+    static uint8_t _phase;
+    /**
+     * @brief The millis() at the start of the current phase
+     */
+    static uint32_t _phaseStartMillis;
+    /**
+     * @brief The time base epoch at the start of the current phase; used to
+     * time sleeps
+     */
+    static uint32_t _phaseStartEpoch;
+    /**
+     * @brief The milliseconds into the second at the start of the current
+     * phase
+     */
+    static uint16_t _phaseStartMs;
+};
+
+#endif  // SRC_LOGGERCLOCK_H_
@@ -16,8 +16,10 @@ float   loggerModem::_priorModemTemp      = -9999;
 float   loggerModem::_priorBatteryState   = -9999;
 float   loggerModem::_priorBatteryPercent = -9999;
 float   loggerModem::_priorBatteryVoltage = -9999;
-// float loggerModem::_priorActivationDuration = -9999;
-// float loggerModem::_priorPoweredDuration = -9999;
+#ifdef MS_CHECK_MODEM_TIMING
+float loggerModem::_priorActivationDuration = -9999;
+float loggerModem::_priorPoweredDuration    = -9999;
+#endif
 
 // Constructor
 loggerModem::loggerModem(int8_t powerPin, int8_t statusPin, bool statusLevel,
@@ -37,7 +39,12 @@ loggerModem::loggerModem(int8_t powerPin, int8_t statusPin, bool statusLevel,
       _wakeDelayTime_ms(wakeDelayTime_ms),
       _max_atresponse_time_ms(max_atresponse_time_ms), _modemLEDPin(-1),
       _millisPowerOn(0), _lastNISTrequest(0), _hasBeenSetup(false),
-      _pinModesSet(false), _modemName("unspecified modem") {}
+      _pinModesSet(false), _historyLatest(0), _historyCount(0),
+      _deferredConnections(0), _modemName("unspecified modem") {
+#ifdef MS_CHECK_MODEM_TIMING
+    _millisActive = 0;
+#endif
+}
 
 
 // Destructor
@@ -85,10 +92,12 @@ void loggerModem::modemPowerUp(void) {
 
 void loggerModem::modemPowerDown(void) {
     if (_powerPin >= 0) {
-        // loggerModem::_priorPoweredDuration =
-        //     (static_cast<float>(millis() - _millisPowerOn)) / 1000;
-        // MS_DBG(F("Total modem power-on time (s):"),
-        //        String(loggerModem::_priorPoweredDuration, 3));
+#ifdef MS_CHECK_MODEM_TIMING
+        loggerModem::_priorPoweredDuration =
+            (static_cast<float>(millis() - _millisPowerOn)) / 1000;
+        MS_DBG(F("Total modem power-on time (s):"),
+               String(loggerModem::_priorPoweredDuration, 3));
+#endif
 
         MS_DBG(F("Turning off power to"), getModemName(), F("with pin"),
                _powerPin);
@@ -96,6 +105,9 @@ void loggerModem::modemPowerDown(void) {
         // Unset the power-on time
         _millisPowerOn = 0;
     } else {
+#ifdef MS_CHECK_MODEM_TIMING
+        loggerModem::_priorPoweredDuration = static_cast<float>(-9999);
+#endif
         MS_DBG(F("Power to"), getModemName(),
                F("is not controlled by this library."));
         // Unset the power-on time
@@ -182,12 +194,20 @@ bool loggerModem::modemSleep(void) {
     if (!isModemAwake()) {
         MS_DBG(getModemName(),
                F("is already off!  Will not run sleep function."));
-        // loggerModem::_priorActivationDuration = 0;
+#ifdef MS_CHECK_MODEM_TIMING
+        loggerModem::_priorActivationDuration = 0;
+#endif
     } else {
         // Run the sleep function
         MS_DBG(F("Running given sleep function for"), getModemName());
         success &= modemSleepFxn();
         modemLEDOff();
+#ifdef MS_CHECK_MODEM_TIMING
+        loggerModem::_priorActivationDuration =
+            (static_cast<float>(millis() - _millisActive)) / 1000;
+        MS_DBG(F("Total modem active time (s):"),
+               String(loggerModem::_priorActivationDuration, 3));
+#endif
     }
     return success;
 }
@@ -224,10 +244,12 @@ bool loggerModem::modemSleepPowerDown(void) {
             while (millis() - start < _disconnetTime_ms) {}
         }
 
-        // loggerModem::_priorPoweredDuration =
-        //     (static_cast<float>(millis() - _millisPowerOn)) / 1000;
-        // MS_DBG(F("Total modem power-on time (s):"),
-        //        String(loggerModem::_priorPoweredDuration, 3));
+#ifdef MS_CHECK_MODEM_TIMING
+        loggerModem::_priorPoweredDuration =
+            (static_cast<float>(millis() - _millisPowerOn)) / 1000;
+        MS_DBG(F("Total modem power-on time (s):"),
+               String(loggerModem::_priorPoweredDuration, 3));
+#endif
 
         MS_DBG(F("Turning off power to"), getModemName(), F("with pin"),
                _powerPin);
@@ -235,7 +257,9 @@ bool loggerModem::modemSleepPowerDown(void) {
         // Unset the power-on time
         _millisPowerOn = 0;
     } else {
-        // loggerModem::_priorPoweredDuration = static_cast<float>(-9999);
+#ifdef MS_CHECK_MODEM_TIMING
+        loggerModem::_priorPoweredDuration = static_cast<float>(-9999);
+#endif
 
         // If we're not going to power the modem down, there's no reason to hold
         // up the main processor while waiting for the modem to shut down.
@@ -368,6 +392,98 @@ bool loggerModem::updateModemMetadata(void) {
     return success;
 }
 
+
+void loggerModem::recordConnectionAttempt(bool success,
+                                          uint32_t connectionTime_ms) {
+    // Get the signal the attempt was made on
+    int16_t rssi    = -9999;
+    int16_t percent = -9999;
+    getModemSignalQuality(rssi, percent);
+
+    _historyLatest = (_historyLatest + 1) % MS_MODEM_HISTORY_LENGTH;
+    if (_historyCount < MS_MODEM_HISTORY_LENGTH) _historyCount++;
+    _rssiHistory[_historyLatest]              = rssi;
+    _connectionTimeHistory[_historyLatest]    = connectionTime_ms;
+    _connectionSuccessHistory[_historyLatest] = success;
+
+    MS_DBG(F("Recorded"), success ? F("successful") : F("failed"),
+           F("connection attempt taking"), connectionTime_ms,
+           F("ms with RSSI"), rssi);
+}
+
+void loggerModem::recordFailedWake(void) {
+    _historyLatest = (_historyLatest + 1) % MS_MODEM_HISTORY_LENGTH;
+    if (_historyCount < MS_MODEM_HISTORY_LENGTH) _historyCount++;
+    _rssiHistory[_historyLatest]              = -9999;
+    _connectionTimeHistory[_historyLatest]    = 0;
+    _connectionSuccessHistory[_historyLatest] = false;
+
+    MS_DBG(F("Recorded failed connection attempt;"), getModemName(),
+           F("did not wake"));
+}
+
+bool loggerModem::shouldAttemptConnection(void) {
+    // Count the failures since the last success that happened on a weak or
+    // absent signal.  A failure on a good signal means something other than
+    // the radio conditions is wrong, so it breaks the count.
+    uint8_t weakFailures = 0;
+    for (uint8_t i = 0; i < _historyCount; i++) {
+        uint8_t pos = (_historyLatest + MS_MODEM_HISTORY_LENGTH - i) %
+            MS_MODEM_HISTORY_LENGTH;
+        if (_connectionSuccessHistory[pos]) break;
+        int16_t rssi = _rssiHistory[pos];
+        if (rssi != 0 && rssi != -9999 && rssi > MS_MODEM_WEAK_RSSI) break;
+        weakFailures++;
+    }
+
+    if (weakFailures < 2) {
+        _deferredConnections = 0;
+        return true;
+    }
+
+    // Skip 1, 3, 7, ... attempts for 2, 3, 4, ... failures
+    uint8_t  shift        = weakFailures - 1 > 15 ? 15 : weakFailures - 1;
+    uint16_t allowedSkips = (1U << shift) - 1;
+    if (allowedSkips > MS_MODEM_MAX_DEFERRALS) {
+        allowedSkips = MS_MODEM_MAX_DEFERRALS;
+    }
+    if (_deferredConnections < allowedSkips) {
+        _deferredConnections++;
+        MS_DBG(weakFailures, F("connection attempts in a row failed on a weak"
+                               " signal; skipping attempt"),
+               _deferredConnections, F("of"), allowedSkips);
+        return false;
+    }
+    _deferredConnections = 0;
+    return true;
+}
+
+uint32_t loggerModem::getAdaptiveConnectionTime(uint32_t maxConnectionTime) {
+    // Give the full time if there's nothing to go on or the last try failed
+    if (_historyCount == 0 || !_connectionSuccessHistory[_historyLatest]) {
+        return maxConnectionTime;
+    }
+
+    uint32_t longestSuccess = 0;
+    for (uint8_t i = 0; i < _historyCount; i++) {
+        uint8_t pos = (_historyLatest + MS_MODEM_HISTORY_LENGTH - i) %
+            MS_MODEM_HISTORY_LENGTH;
+        if (_connectionSuccessHistory[pos] &&
+            _connectionTimeHistory[pos] > longestSuccess) {
+            longestSuccess = _connectionTimeHistory[pos];
+        }
+    }
+
+    uint32_t adaptedTime = 2 * longestSuccess;
+    if (adaptedTime < MS_MODEM_MIN_CONNECTION_TIME) {
+        adaptedTime = MS_MODEM_MIN_CONNECTION_TIME;
+    }
+    if (adaptedTime > maxConnectionTime) { adaptedTime = maxConnectionTime; }
+    MS_DBG(F("Allowing"), adaptedTime,
+           F("ms for the connection based on recent connection times."));
+    return adaptedTime;
+}
+
 float loggerModem::getModemRSSI() {
     float retVal = loggerModem::_priorRSSI;
     // MS_DBG(F("PRIOR RSSI:"), retVal);
@@ -398,18 +514,18 @@ float loggerModem::getModemTemperature() {
     // MS_DBG(F("PRIOR Modem Chip Temperature:"), retVal);
     return retVal;
 }
-// template <class Derived, typename modemType, typename modemClientType>
-// float loggerModem::getModemActivationDuration()
-// {
-//     float retVal = loggerModem::_priorActivationDuration;
-//     return retVal;
-// }
-// template <class Derived, typename modemType, typename modemClientType>
-// float loggerModem::getModemPoweredDuration()
-// {
-//     float retVal = loggerModem::_priorPoweredDuration;
-//     return retVal;
-// }
+#ifdef MS_CHECK_MODEM_TIMING
+float loggerModem::getModemActivationDuration() {
+    float retVal = loggerModem::_priorActivationDuration;
+    // MS_DBG(F("PRIOR Modem Active Time:"), retVal);
+    return retVal;
+}
+float loggerModem::getModemPoweredDuration() {
+    float retVal = loggerModem::_priorPoweredDuration;
+    // MS_DBG(F("PRIOR Modem Powered Time:"), retVal);
+    return retVal;
+}
+#endif
 
 // Helper to get approximate RSSI from CSQ (assuming no noise)
 int16_t loggerModem::getRSSIFromCSQ(int16_t csq) {
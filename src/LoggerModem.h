@@ -37,6 +37,67 @@
 #include <Arduino.h>
 
 
+/**
+ * @def MS_MODEM_HISTORY_LENGTH
+ * @brief The number of past connection attempts the modem remembers.
+ *
+ * The signal strength, time taken, and success of this many past attempts to
+ * connect to the internet are used to decide whether it is worth waking the
+ * modem at all and how long to wait for a connection.  Each remembered attempt
+ * costs 7 bytes of RAM.
+ *
+ * This can be changed by setting the build flag MS_MODEM_HISTORY_LENGTH when
+ * compiling.
+ *
+ * @ingroup the_modems
+ */
+#ifndef MS_MODEM_HISTORY_LENGTH
+#define MS_MODEM_HISTORY_LENGTH 8
+#endif
+
+/**
+ * @def MS_MODEM_WEAK_RSSI
+ * @brief The RSSI (in dBm) at or below which the signal is considered too
+ * weak to keep trying to connect on every logging interval.
+ *
+ * This can be changed by setting the build flag MS_MODEM_WEAK_RSSI when
+ * compiling.
+ *
+ * @ingroup the_modems
+ */
+#ifndef MS_MODEM_WEAK_RSSI
+#define MS_MODEM_WEAK_RSSI -105
+#endif
+
+/**
+ * @def MS_MODEM_MAX_DEFERRALS
+ * @brief The largest number of consecutive logging intervals on which a
+ * connection attempt will be skipped after repeated failures on a weak signal.
+ *
+ * This can be changed by setting the build flag MS_MODEM_MAX_DEFERRALS when
+ * compiling.  Set it to 0 to always attempt to connect.
+ *
+ * @ingroup the_modems
+ */
+#ifndef MS_MODEM_MAX_DEFERRALS
+#define MS_MODEM_MAX_DEFERRALS 8
+#endif
+
+/**
+ * @def MS_MODEM_MIN_CONNECTION_TIME
+ * @brief The shortest time, in milliseconds, that will be allowed for an
+ * internet connection when the timeout is adapted to recent connection times.
+ *
+ * This can be changed by setting the build flag MS_MODEM_MIN_CONNECTION_TIME
+ * when compiling.
+ *
+ * @ingroup the_modems
+ */
+#ifndef MS_MODEM_MIN_CONNECTION_TIME
+#define MS_MODEM_MIN_CONNECTION_TIME 15000L
+#endif
+
+
 /**
  * @defgroup modem_measured_variables Modem Variables
  *
@@ -582,6 +643,65 @@ class loggerModem {
     virtual bool updateModemMetadata(void);
     /**@}*/
 
+    /**
+     * @anchor modem_connection_history
+     * @name Connection history
+     * Functions to remember past internet connection attempts and use them to
+     * avoid wasting power on connections that are unlikely to succeed.
+     */
+    /**@{*/
+    /**
+     * @brief Record the outcome of an attempt to connect to the internet.
+     *
+     * This also asks the modem for the current signal strength so that both
+     * successful and failed attempts are remembered with the signal they were
+     * made on.  The modem must be awake when this is called.
+     *
+     * @param success True if the connection was established.
+     * @param connectionTime_ms The time taken by connectInternet(uint32_t
+     * maxConnectionTime), in milliseconds.
+     */
+    void recordConnectionAttempt(bool success, uint32_t connectionTime_ms);
+    /**
+     * @brief Record an attempt to connect to the internet that failed
+     * because the modem wouldn't wake.
+     *
+     * No signal strength can be read from a modem that isn't awake, so the
+     * attempt is remembered as a failure with no signal, the same as a
+     * failure with no service.
+     */
+    void recordFailedWake(void);
+    /**
+     * @brief Decide whether it is worth attempting to connect to the internet
+     * this time.
+     *
+     * After two or more consecutive failed connections where the modem
+     * reported a weak or absent signal, or didn't wake at all, connection
+     * attempts are skipped on an exponentially growing number of calls (1, 3,
+     * 7, ...), never more than #MS_MODEM_MAX_DEFERRALS in a row.  Failures on
+     * a good signal are not blamed on the radio conditions and do not cause
+     * any skips.
+     *
+     * @note Each call that returns false counts as one skipped attempt.
+     *
+     * @return **bool** True if a connection should be attempted.
+     */
+    bool shouldAttemptConnection(void);
+    /**
+     * @brief Get a connection timeout adapted to recent connection times.
+     *
+     * This is twice the longest successful connection time remembered,
+     * bounded by #MS_MODEM_MIN_CONNECTION_TIME and the given maximum.  If the
+     * last attempt failed or there is no successful attempt remembered, the
+     * full maximum is given.
+     *
+     * @param maxConnectionTime The longest connection time to allow, in
+     * milliseconds; optional with a default value of 50000L.
+     * @return **uint32_t** The connection timeout to use, in milliseconds.
+     */
+    uint32_t getAdaptiveConnectionTime(uint32_t maxConnectionTime = 50000L);
+    /**@}*/
+
     /**
      * @anchor modem_static_functions
      * @name Functions to return the current value of static member variables
@@ -647,8 +767,29 @@ class loggerModem {
      */
     static float getModemTemperature();
 
-    // static float getModemActivationDuration();
-    // static float getModemPoweredDuration();
+#ifdef MS_CHECK_MODEM_TIMING
+    /**
+     * @brief Get the time the modem was active for the last time it was woken.
+     *
+     * The active time runs from the start of modemWake() until the modem is
+     * put back to sleep.
+     *
+     * @note Does NOT query the modem for a new value.
+     *
+     * @return **float** The stored active time in seconds
+     */
+    static float getModemActivationDuration();
+    /**
+     * @brief Get the time the modem was powered for the last time it was
+     * powered on.
+     *
+     * @note Does NOT query the modem for a new value.
+     *
+     * @return **float** The stored powered time in seconds; -9999 if the power
+     * to the modem is not controlled by this library.
+     */
+    static float getModemPoweredDuration();
+#endif
     /**@}*/
 
  protected:
@@ -906,6 +1047,15 @@ class loggerModem {
      * function.  It is un-set in the modemSleepPowerDown() function.
      */
     uint32_t _millisPowerOn;
+#ifdef MS_CHECK_MODEM_TIMING
+    /**
+     * @brief The processor elapsed time when the modem was last woken.
+     *
+     * The #_millisActive value is set at the start of modemWake().  It is used
+     * to calculate #_priorActivationDuration when the modem is put to sleep.
+     */
+    uint32_t _millisActive;
+#endif
 
     /**
      * @brief The processor elapsed time when the a connection to the NIST time
@@ -927,6 +1077,45 @@ class loggerModem {
     bool _pinModesSet;
     /**@}*/
 
+    /**
+     * @anchor modem_history_variables
+     * @name Member variables used to hold the connection history
+     */
+    /**@{*/
+    /**
+     * @brief The RSSI reported after each remembered connection attempt.
+     *
+     * Set by recordConnectionAttempt().
+     */
+    int16_t _rssiHistory[MS_MODEM_HISTORY_LENGTH];
+    /**
+     * @brief The time in milliseconds taken by each remembered connection
+     * attempt.
+     *
+     * Set by recordConnectionAttempt().
+     */
+    uint32_t _connectionTimeHistory[MS_MODEM_HISTORY_LENGTH];
+    /**
+     * @brief The success of each remembered connection attempt.
+     *
+     * Set by recordConnectionAttempt().
+     */
+    bool _connectionSuccessHistory[MS_MODEM_HISTORY_LENGTH];
+    /**
+     * @brief The position in the history arrays of the most recent attempt.
+     */
+    uint8_t _historyLatest;
+    /**
+     * @brief The number of attempts in the history arrays.
+     */
+    uint8_t _historyCount;
+    /**
+     * @brief The number of connection attempts skipped in a row by
+     * shouldAttemptConnection().
+     */
+    uint8_t _deferredConnections;
+    /**@}*/
+
     // NOTE:  These must be static so that the modem variables can call the
     // member functions that return them.  (Non-static member functions cannot
     // be called without an object.)
@@ -977,8 +1166,22 @@ class loggerModem {
      * Returned by #getModemBatteryVoltage().
      */
     static float _priorBatteryVoltage;
-    // static float _priorActivationDuration;
-    // static float _priorPoweredDuration;
+#ifdef MS_CHECK_MODEM_TIMING
+    /**
+     * @brief The last stored modem active time
+     *
+     * Set by modemSleep().
+     * Returned by #getModemActivationDuration().
+     */
+    static float _priorActivationDuration;
+    /**
+     * @brief The last stored modem powered time
+     *
+     * Set by modemPowerDown() or modemSleepPowerDown().
+     * Returned by #getModemPoweredDuration().
+     */
+    static float _priorPoweredDuration;
+#endif
     /**@}*/
 
     /**
@@ -1204,9 +1407,26 @@ class Modem_Temp : public Variable {
 
 
 #ifdef MS_CHECK_MODEM_TIMING
-// Defines a diagnostic variable for how long the modem was last active
+/**
+ * @brief The Variable sub-class used for the
+ * [active time output](@ref modem_activation) from a
+ * [modem](@ref the_modems).
+ *
+ * @note This is only a testing/development diagnostic.
+ *
+ * @ingroup modem_measured_variables
+ */
 class Modem_ActivationDuration : public Variable {
  public:
+    /**
+     * @brief Construct a new Modem_ActivationDuration object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemActiveSec".
+     */
     explicit Modem_ActivationDuration(
         loggerModem* parentModem, const char* uuid = "",
         const char* varCode = MODEM_ACTIVATION_DEFAULT_CODE)
@@ -1214,19 +1434,42 @@ class Modem_ActivationDuration : public Variable {
                    (uint8_t)MODEM_ACTIVATION_RESOLUTION,
                    &*MODEM_ACTIVATION_VAR_NAME, &*MODEM_ACTIVATION_UNIT_NAME,
                    varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_ActivationDuration object - no action needed.
+     */
     ~Modem_ActivationDuration() {}
 };
 
 
-// Defines a diagnostic variable for how long the modem was last active
+/**
+ * @brief The Variable sub-class used for the
+ * [powered time output](@ref modem_power) from a
+ * [modem](@ref the_modems).
+ *
+ * @note This is only a testing/development diagnostic.
+ *
+ * @ingroup modem_measured_variables
+ */
 class Modem_PoweredDuration : public Variable {
  public:
+    /**
+     * @brief Construct a new Modem_PoweredDuration object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemPoweredSec".
+     */
     explicit Modem_PoweredDuration(
         loggerModem* parentModem, const char* uuid = "",
         const char* varCode = MODEM_POWERED_DEFAULT_CODE)
         : Variable(&parentModem->getModemPoweredDuration,
                    (uint8_t)MODEM_POWERED_RESOLUTION, &*MODEM_POWERED_VAR_NAME,
                    &*MODEM_POWERED_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_PoweredDuration object - no action needed.
+     */
     ~Modem_PoweredDuration() {}
 };
 #endif
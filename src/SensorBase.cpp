@@ -50,20 +50,55 @@ Sensor::Sensor(const char* sensorName, const uint8_t numReturnedVars,
     _measurementTime_ms         = measurementTime_ms;
     _millisMeasurementRequested = 0;
 
+#ifdef MS_ROBUST_AVERAGING
+    _averagingMode = MEAN_AVERAGE;
+    _resultSamples = NULL;
+#endif
+#ifdef MS_BURST_SAMPLING
+    _burstRate_Hz     = 0;
+    _burstWindow_ms   = 0;
+    _burstVarNum      = 0;
+    _burstBuffer      = NULL;
+    _burstHead        = 0;
+    _burstKept        = 0;
+    _burstTaken       = 0;
+    _burstOverruns    = 0;
+    _burstPeriod_us   = 0;
+    _burstStartMillis = 0;
+    _burstCapturing   = false;
+#endif
+
     // Clear arrays
     for (uint8_t i = 0; i < MAX_NUMBER_VARS; i++) {
         variables[i]                  = NULL;
         sensorValues[i]               = -9999;
         numberGoodMeasurementsMade[i] = 0;
+#ifdef MS_SENSOR_STATISTICS
+        numberBadMeasurementsMade[i] = 0;
+        _resultM2[i]                 = 0;
+        _resultMin[i]                = -9999;
+        _resultMax[i]                = -9999;
+#endif
     }
 
     // Reset the sensor status
     _sensorStatus = 0;
 
+    // No failures yet
+    _consecutiveFailures = 0;
+    _backoffCycles       = 0;
+
     // MS_DBG(F("Sensor object created"));
 }
 // Destructor
-Sensor::~Sensor() {}
+Sensor::~Sensor() {
+#ifdef MS_ROBUST_AVERAGING
+    delete[] _resultSamples;
+#endif
+#ifdef MS_BURST_SAMPLING
+    delete[] _burstBuffer;
+#endif
+}
 
 
 // This gets the place the sensor is installed ON THE MAYFLY (ie, pin number)
@@ -102,6 +137,30 @@ uint8_t Sensor::getNumberMeasurementsToAverage(void) {
 }
 
 
+#ifdef MS_ROBUST_AVERAGING
+// These set and get how the results are reduced
+void Sensor::setAveragingMode(averagingMode mode) {
+    _averagingMode = mode;
+    if (mode == MEAN_AVERAGE) {
+        // The running mean doesn't need the individual results
+        delete[] _resultSamples;
+        _resultSamples = NULL;
+    } else if (_resultSamples == NULL) {
+        _resultSamples =
+            new float[_numReturnedValues * MS_MAX_AVERAGING_SAMPLES];
+        if (_resultSamples == NULL) {
+            MS_DBG(F("No room to keep results for"),
+                   getSensorNameAndLocation(), F("; using the mean."));
+            _averagingMode = MEAN_AVERAGE;
+        }
+    }
+}
+averagingMode Sensor::getAveragingMode(void) {
+    return _averagingMode;
+}
+#endif
+
+
 // This returns the 8-bit code for the current status of the sensor.
 // Bit 0 - 0=Has NOT been set up, 1=Has been setup
 // Bit 1 - 0=No attempt made to power sensor, 1=Attempt made to power sensor
@@ -214,6 +273,16 @@ bool Sensor::wake(void) {
 }
 
 
+// Most sensors don't need any upkeep
+bool Sensor::runMaintenance(void) {
+    return false;
+}
+
+
+// Most sensors don't keep any events
+void Sensor::timestampEvents(void) {}
+
+
 // The function to put a sensor to sleep
 // Does NOT power down the sensor!
 bool Sensor::sleep(void) {
@@ -322,40 +391,92 @@ void Sensor::clearValues(void) {
     for (uint8_t i = 0; i < _numReturnedValues; i++) {
         sensorValues[i]               = -9999;
         numberGoodMeasurementsMade[i] = 0;
+#ifdef MS_SENSOR_STATISTICS
+        numberBadMeasurementsMade[i] = 0;
+        _resultM2[i]                 = 0;
+        _resultMin[i]                = -9999;
+        _resultMax[i]                = -9999;
+#endif
     }
 }
 
 
 // This verifies that a measurement is good before adding it to the values to be
 // averaged
+// The result array holds the running mean of the good values, rather than their
+// sum, so large numbers of readings don't lose precision to a big float total.
 void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
                                            float   resultValue) {
     // If the new result is good and there was were only bad results, set the
     // result value as the new result and add 1 to the good result total
-    if (sensorValues[resultNumber] == -9999 && resultValue != -9999) {
+    if (numberGoodMeasurementsMade[resultNumber] == 0 && resultValue != -9999) {
         MS_DBG(F("Putting"), resultValue, F("in result array for variable"),
                resultNumber, F("from"), getSensorNameAndLocation());
         sensorValues[resultNumber] = resultValue;
         numberGoodMeasurementsMade[resultNumber] += 1;
-    } else if (sensorValues[resultNumber] != -9999 && resultValue != -9999) {
+#ifdef MS_ROBUST_AVERAGING
+        if (_resultSamples != NULL) {
+            _resultSamples[resultNumber * MS_MAX_AVERAGING_SAMPLES] =
+                resultValue;
+        }
+#endif
+#ifdef MS_SENSOR_STATISTICS
+        _resultM2[resultNumber]  = 0;
+        _resultMin[resultNumber] = resultValue;
+        _resultMax[resultNumber] = resultValue;
+#endif
+    } else if (numberGoodMeasurementsMade[resultNumber] > 0 &&
+               resultValue != -9999) {
         // If the new result is good and there were already good results in
-        // place add the new results to the total and add 1 to the good result
-        // total
+        // place, move the mean toward the new result and add 1 to the good
+        // result total
         MS_DBG(F("Adding"), resultValue, F("to result array for variable"),
                resultNumber, F("from"), getSensorNameAndLocation());
-        sensorValues[resultNumber] += resultValue;
         numberGoodMeasurementsMade[resultNumber] += 1;
-    } else if (sensorValues[resultNumber] == -9999 && resultValue == -9999) {
+        float delta = resultValue - sensorValues[resultNumber];
+        sensorValues[resultNumber] += delta /
+            numberGoodMeasurementsMade[resultNumber];
+#ifdef MS_ROBUST_AVERAGING
+        uint16_t sampleNumber = numberGoodMeasurementsMade[resultNumber] - 1;
+        if (_resultSamples != NULL &&
+            sampleNumber < MS_MAX_AVERAGING_SAMPLES) {
+            _resultSamples[resultNumber * MS_MAX_AVERAGING_SAMPLES +
+                           sampleNumber] = resultValue;
+        }
+#endif
+#ifdef MS_SENSOR_STATISTICS
+        _resultM2[resultNumber] += delta *
+            (resultValue - sensorValues[resultNumber]);
+        if (resultValue < _resultMin[resultNumber]) {
+            _resultMin[resultNumber] = resultValue;
+        }
+        if (resultValue > _resultMax[resultNumber]) {
+            _resultMax[resultNumber] = resultValue;
+        }
+#endif
+    } else if (numberGoodMeasurementsMade[resultNumber] == 0) {
         // If the new result is bad and there were only bad results, do nothing
         MS_DBG(F("Ignoring bad result for variable"), resultNumber, F("from"),
                getSensorNameAndLocation(), F("; no good results yet."));
-    } else if (sensorValues[resultNumber] != -9999 && resultValue == -9999) {
+    } else {
         // If the new result is bad and there were already good results, do
         // nothing
         MS_DBG(F("Ignoring bad result for variable"), resultNumber, F("from"),
                getSensorNameAndLocation(),
                F("; good results already in array."));
     }
+#ifdef MS_SENSOR_STATISTICS
+    if (resultValue == -9999) { numberBadMeasurementsMade[resultNumber] += 1; }
+#endif
+#ifdef MS_BURST_SAMPLING
+    // Keep the raw result, good or bad, if this is the variable being captured
+    if (_burstCapturing && _burstBuffer != NULL &&
+        resultNumber == _burstVarNum) {
+        _burstBuffer[_burstHead] = resultValue;
+        _burstHead               = (_burstHead + 1) % MS_BURST_BUFFER_SIZE;
+        if (_burstKept < MS_BURST_BUFFER_SIZE) { _burstKept++; }
+    }
+#endif
 }
 void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
                                            int16_t resultValue) {
@@ -364,17 +485,305 @@ void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
 }
 
 
+bool Sensor::isQuarantined(void) {
+    return _backoffCycles > 0;
+}
+uint8_t Sensor::getConsecutiveFailures(void) {
+    return _consecutiveFailures;
+}
+
+
+// This counts failed updates and works out how many updates to skip
+void Sensor::recordUpdateOutcome(bool skipped) {
+    if (skipped) {
+        _backoffCycles--;
+        return;
+    }
+
+    bool gotResult = false;
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
+        if (numberGoodMeasurementsMade[i] > 0) gotResult = true;
+    }
+
+    if (gotResult) {
+        if (MS_SENSOR_FAILURES_BEFORE_BACKOFF > 0 &&
+            _consecutiveFailures >= MS_SENSOR_FAILURES_BEFORE_BACKOFF) {
+            MS_DBG(getSensorNameAndLocation(), F("is responding again"));
+        }
+        _consecutiveFailures = 0;
+        return;
+    }
+
+    if (_consecutiveFailures < 255) _consecutiveFailures++;
+    if (MS_SENSOR_FAILURES_BEFORE_BACKOFF == 0 ||
+        _consecutiveFailures < MS_SENSOR_FAILURES_BEFORE_BACKOFF) {
+        return;
+    }
+
+    // Skip one update after the first failure past the limit and double the
+    // skips with each failure after that
+    uint8_t doublings = _consecutiveFailures -
+        MS_SENSOR_FAILURES_BEFORE_BACKOFF;
+    uint16_t cycles = MS_SENSOR_MAX_BACKOFF_CYCLES;
+    if (doublings < 16) { cycles = static_cast<uint16_t>(1) << doublings; }
+    if (cycles > MS_SENSOR_MAX_BACKOFF_CYCLES) {
+        cycles = MS_SENSOR_MAX_BACKOFF_CYCLES;
+    }
+    _backoffCycles = cycles;
+    MS_DBG(getSensorNameAndLocation(), F("has failed"), _consecutiveFailures,
+           F("updates in a row and will be skipped for the next"),
+           _backoffCycles);
+}
+
+
+void Sensor::clearQuarantine(void) {
+    _consecutiveFailures = 0;
+    _backoffCycles       = 0;
+}
+
+
 void Sensor::averageMeasurements(void) {
     MS_DBG(F("Averaging results from"), getSensorNameAndLocation(), F("over"),
            _measurementsToAverage, F("reading[s]"));
     for (uint8_t i = 0; i < _numReturnedValues; i++) {
-        if (numberGoodMeasurementsMade[i] > 0)
-            sensorValues[i] /= numberGoodMeasurementsMade[i];
-        MS_DBG(F("    ->Result #"), i, ':', sensorValues[i]);
+#ifdef MS_ROBUST_AVERAGING
+        // Swap the running mean for a more robust value if there are enough
+        // results - and not too many - to do it
+        if (_averagingMode != MEAN_AVERAGE &&
+            numberGoodMeasurementsMade[i] >= 3 &&
+            numberGoodMeasurementsMade[i] <= MS_MAX_AVERAGING_SAMPLES) {
+            MS_DBG(F("    ->Mean #"), i, ':', sensorValues[i]);
+            sensorValues[i] = reduceValues(
+                _resultSamples + i * MS_MAX_AVERAGING_SAMPLES,
+                numberGoodMeasurementsMade[i], _averagingMode);
+        } else if (_averagingMode != MEAN_AVERAGE) {
+            MS_DBG(F("    ->Using the mean for result #"), i, F("from"),
+                   numberGoodMeasurementsMade[i],
+                   F("good reading[s]; the averaging mode needs 3 to"),
+                   MS_MAX_AVERAGING_SAMPLES);
+        }
+#endif
+        MS_DBG(F("    ->Result #"), i, ':', sensorValues[i], F("from"),
+               numberGoodMeasurementsMade[i], F("good reading[s]"));
     }
 }
 
 
+#ifdef MS_ROBUST_AVERAGING
+// This reduces an array of values to one using the given method
+// Insertion sort is used because the arrays are tiny and it needs no extra
+// memory or recursion.
+float Sensor::reduceValues(float* values, uint8_t count, averagingMode mode) {
+    if (count == 0) return -9999;
+
+    for (uint8_t i = 1; i < count; i++) {
+        float   v = values[i];
+        uint8_t j = i;
+        while (j > 0 && values[j - 1] > v) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = v;
+    }
+
+    float median = (count % 2)
+        ? values[count / 2]
+        : (values[count / 2 - 1] + values[count / 2]) / 2;
+
+    switch (mode) {
+        case MEDIAN_AVERAGE: {
+            return median;
+        }
+        case TRIMMED_MEAN_AVERAGE: {
+            // Drop 20% from each end, but always at least one value
+            uint8_t trim = count / 5;
+            if (trim == 0 && count >= 3) trim = 1;
+            float sum = 0;
+            for (uint8_t i = trim; i < count - trim; i++) { sum += values[i]; }
+            return sum / (count - 2 * trim);
+        }
+        case SPIKE_REJECTED_AVERAGE: {
+            // The median absolute deviation, scaled by 1.4826, estimates the
+            // standard deviation without being thrown off by the spikes
+            if (count > MS_MAX_AVERAGING_SAMPLES) {
+                count = MS_MAX_AVERAGING_SAMPLES;
+            }
+            float deviations[MS_MAX_AVERAGING_SAMPLES];
+            for (uint8_t i = 0; i < count; i++) {
+                deviations[i] = fabs(values[i] - median);
+            }
+            float limit = 3 * 1.4826 *
+                reduceValues(deviations, count, MEDIAN_AVERAGE);
+            float   sum  = 0;
+            uint8_t kept = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                if (fabs(values[i] - median) <= limit) {
+                    sum += values[i];
+                    kept++;
+                }
+            }
+            return sum / kept;
+        }
+        case MEAN_AVERAGE:
+        default: {
+            float sum = 0;
+            for (uint8_t i = 0; i < count; i++) { sum += values[i]; }
+            return sum / count;
+        }
+    }
+}
+#endif
+
+
+#ifdef MS_BURST_SAMPLING
+// This sets up burst sampling
+void Sensor::setBurstMode(uint16_t rate_Hz, uint16_t window_ms,
+                          uint8_t captureVarNum) {
+    _burstRate_Hz   = rate_Hz;
+    _burstWindow_ms = window_ms;
+    _burstVarNum    = captureVarNum;
+    _burstTaken     = 0;
+    _burstKept      = 0;
+    if (!isBurstEnabled()) {
+        delete[] _burstBuffer;
+        _burstBuffer = NULL;
+    } else if (_burstBuffer == NULL) {
+        _burstBuffer = new float[MS_BURST_BUFFER_SIZE];
+        if (_burstBuffer == NULL) {
+            MS_DBG(F("No room to keep the raw burst results of"),
+                   getSensorNameAndLocation());
+        }
+    }
+}
+bool Sensor::isBurstEnabled(void) {
+    return _burstRate_Hz > 0 && _burstWindow_ms > 0;
+}
+
+
+// This samples the sensor at a fixed rate for the burst window
+// The deadlines are kept on micros() rather than a timer interrupt so that
+// the sensor can be read with its usual (possibly I2C) functions.
+bool Sensor::takeBurst(void) {
+    uint32_t period_us = 1000000L / _burstRate_Hz;
+    uint32_t window_us = static_cast<uint32_t>(_burstWindow_ms) * 1000;
+    // A sample can't be taken faster than the sensor can measure
+    if (period_us < _measurementTime_ms * 1000) {
+        MS_DBG(F("Slowing the burst to one sample per measurement time of"),
+               _measurementTime_ms, F("ms"));
+        period_us = _measurementTime_ms * 1000;
+    }
+    MS_DBG(F("Taking a"), _burstWindow_ms, F("ms burst at"),
+           1000000L / period_us, F("Hz from"), getSensorNameAndLocation());
+
+    _burstHead        = 0;
+    _burstKept        = 0;
+    _burstTaken       = 0;
+    _burstOverruns    = 0;
+    _burstPeriod_us   = period_us;
+    _burstCapturing   = true;
+    _burstStartMillis = millis();
+
+    bool     success = true;
+    uint32_t start   = micros();
+    uint32_t next    = start;
+    while (micros() - start < window_us) {
+        // Wait for the deadline of the next sample
+        while (static_cast<int32_t>(micros() - next) < 0) {}
+        success &= startSingleMeasurement();
+        waitForMeasurementCompletion();
+        success &= addSingleMeasurementResult();
+        _burstTaken++;
+        next += period_us;
+        // If the sample ran past the next deadline, carry on from now rather
+        // than rushing to catch up
+        if (static_cast<int32_t>(micros() - next) > 0) {
+            _burstOverruns++;
+            next = micros();
+        }
+    }
+    _burstCapturing = false;
+
+    MS_DBG(F("Burst complete:"), _burstTaken, F("samples with"),
+           _burstOverruns, F("missed deadlines"));
+    return success;
+}
+
+
+// These return information about the most recent burst
+uint16_t Sensor::getBurstSampleCount(void) {
+    return _burstTaken;
+}
+uint16_t Sensor::getBurstOverruns(void) {
+    return _burstOverruns;
+}
+uint32_t Sensor::getBurstStartMillis(void) {
+    return _burstStartMillis;
+}
+
+
+// This writes the raw results of the most recent burst out in binary
+size_t Sensor::writeBurst(Print* stream) {
+    size_t written = 0;
+    written += stream->write(reinterpret_cast<const uint8_t*>(&_burstPeriod_us),
+                             sizeof(_burstPeriod_us));
+    written += stream->write(reinterpret_cast<const uint8_t*>(&_burstTaken),
+                             sizeof(_burstTaken));
+    written += stream->write(reinterpret_cast<const uint8_t*>(&_burstKept),
+                             sizeof(_burstKept));
+    written += stream->write(reinterpret_cast<const uint8_t*>(&_burstOverruns),
+                             sizeof(_burstOverruns));
+    written += stream->write(_burstVarNum);
+    if (_burstBuffer == NULL) return written;
+
+    // The oldest kept sample is at the head once the buffer has wrapped
+    uint16_t first = _burstKept < MS_BURST_BUFFER_SIZE ? 0 : _burstHead;
+    uint16_t tail  = MS_BURST_BUFFER_SIZE - first;
+    if (tail > _burstKept) tail = _burstKept;
+    written += stream->write(
+        reinterpret_cast<const uint8_t*>(&_burstBuffer[first]),
+        tail * sizeof(float));
+    written += stream->write(reinterpret_cast<const uint8_t*>(_burstBuffer),
+                             (_burstKept - tail) * sizeof(float));
+    return written;
+}
+#endif
+
+
+// This returns the number of good results for a variable
+uint16_t Sensor::getGoodMeasurementCount(uint8_t resultNumber) {
+    return numberGoodMeasurementsMade[resultNumber];
+}
+
+
+// By default, a sensor has no diagnostics
+float Sensor::getDiagnosticValue(uint8_t diagnosticNumber) {
+    return -9999;
+}
+
+
+#ifdef MS_SENSOR_STATISTICS
+// These return the statistics of the results averaged for a variable
+uint16_t Sensor::getBadMeasurementCount(uint8_t resultNumber) {
+    return numberBadMeasurementsMade[resultNumber];
+}
+float Sensor::getResultMinimum(uint8_t resultNumber) {
+    return _resultMin[resultNumber];
+}
+float Sensor::getResultMaximum(uint8_t resultNumber) {
+    return _resultMax[resultNumber];
+}
+float Sensor::getResultVariance(uint8_t resultNumber) {
+    if (numberGoodMeasurementsMade[resultNumber] < 2) return -9999;
+    return _resultM2[resultNumber] /
+        (numberGoodMeasurementsMade[resultNumber] - 1);
+}
+float Sensor::getResultStandardDeviation(uint8_t resultNumber) {
+    if (numberGoodMeasurementsMade[resultNumber] < 2) return -9999;
+    return sqrt(getResultVariance(resultNumber));
+}
+#endif
+
+
 // This updates a sensor value by checking it's power, waking it, taking as many
 // readings as requested, then putting the sensor to sleep and powering down.
 bool Sensor::update(void) {
@@ -391,6 +800,7 @@ bool Sensor::update(void) {
         // wait for the sensor to have been powered for long enough to respond
         waitForWarmUp();
         ret_val &= wake();
+        if (ret_val) runMaintenance();
     }
     // bail if the wake failed
     if (!ret_val) return ret_val;
@@ -401,8 +811,17 @@ bool Sensor::update(void) {
     // Wait for the sensor to stabilize
     waitForStability();
 
+    uint8_t nMeasurements = _measurementsToAverage;
+#ifdef MS_BURST_SAMPLING
+    // A burst takes the place of the measurements to average
+    if (isBurstEnabled()) {
+        ret_val += takeBurst();
+        nMeasurements = 0;
+    }
+#endif
+
     // loop through as many measurements as requested
-    for (uint8_t j = 0; j < _measurementsToAverage; j++) {
+    for (uint8_t j = 0; j < nMeasurements; j++) {
         // start a measurement
         ret_val += startSingleMeasurement();
         // wait for the measurement to finish
@@ -40,6 +40,64 @@
  */
 #define MAX_NUMBER_VARS 8
 
+#ifndef MS_MAX_AVERAGING_SAMPLES
+/**
+ * @brief The most individual results kept for each variable of a sensor for a
+ * median, trimmed, or spike-rejecting average.
+ *
+ * The buffer for these is only created if `MS_ROBUST_AVERAGING` is defined.
+ * It takes 4 x #MAX_NUMBER_VARS x #MS_MAX_AVERAGING_SAMPLES bytes for *every*
+ * sensor, so keep this as small as the largest number of measurements any
+ * sensor averages.
+ */
+#define MS_MAX_AVERAGING_SAMPLES 10
+#endif
+
+#ifndef MS_SENSOR_FAILURES_BEFORE_BACKOFF
+/**
+ * @brief The number of complete updates in a row a sensor can fail to return
+ * any good result before VariableArray::completeUpdate() starts skipping it.
+ *
+ * Set this to 0 to never skip a failing sensor.
+ */
+#define MS_SENSOR_FAILURES_BEFORE_BACKOFF 3
+#endif
+
+#ifndef MS_SENSOR_MAX_BACKOFF_CYCLES
+/**
+ * @brief The most complete updates in a row a failing sensor will be skipped
+ * before it is tried again.
+ */
+#define MS_SENSOR_MAX_BACKOFF_CYCLES 64
+#endif
+
+#ifndef MS_BURST_BUFFER_SIZE
+/**
+ * @brief The number of raw results kept from the most recent burst of each
+ * sensor.
+ *
+ * Each sensor with burst sampling turned on gets its own buffer of
+ * 4 x #MS_BURST_BUFFER_SIZE bytes from the heap.  If a burst takes more
+ * samples than this, only the last are kept.
+ */
+#define MS_BURST_BUFFER_SIZE 128
+#endif
+
+/**
+ * @brief The ways the individual results of a sensor can be reduced to a
+ * single value.
+ *
+ * Anything other than the mean requires `MS_ROBUST_AVERAGING` to be defined.
+ */
+typedef enum averagingMode {
+    MEAN_AVERAGE = 0,      ///< The arithmetic mean (default)
+    MEDIAN_AVERAGE,        ///< The median
+    TRIMMED_MEAN_AVERAGE,  ///< The mean without the top and bottom 20%
+    SPIKE_REJECTED_AVERAGE  ///< The mean after dropping values more than 3
+                            ///< scaled median absolute deviations from the
+                            ///< median
+} averagingMode;
+
 
 class Variable;  // Forward declaration
 
@@ -273,6 +331,29 @@ class Sensor {
      * @return **bool** True if the wake function completed successfully.
      */
     virtual bool wake(void);
+    /**
+     * @brief Run any upkeep the sensor needs before measuring, like cleaning
+     * its optics, if that upkeep is due.
+     *
+     * The variable array calls this as soon as a sensor is awake, while the
+     * other sensors are still warming up, so the upkeep doesn't add to the
+     * time the update takes.  Sensors with upkeep override this; by default
+     * it does nothing.
+     *
+     * @return **bool** True if any upkeep was done.
+     */
+    virtual bool runMaintenance(void);
+    /**
+     * @brief Put a time stamp on any events the sensor has caught with an
+     * interrupt since this was last called.
+     *
+     * An interrupt can only note the millis() of an event, and millis() stops
+     * while the processor sleeps.  The logger calls this for every sensor
+     * before it puts the processor to sleep, while the logger time base still
+     * matches millis(), so each event can be given its real time.  Sensors
+     * that keep events override this; by default it does nothing.
+     */
+    virtual void timestampEvents(void);
     /**
      * @brief Puts the sensor to sleep, if necessary.
      *
@@ -344,11 +425,243 @@ class Sensor {
     void verifyAndAddMeasurementResult(uint8_t resultNumber,
                                        int16_t resultValue);
     /**
-     * @brief Average the results of all measurements by dividing the sum of
-     * all measurements by the number of measurements taken.
+     * @brief Finish averaging the results of all measurements.
+     *
+     * The result array holds a running mean, which is updated as each result
+     * is added, so there is nothing left to divide.  This only reports the
+     * results.
      */
     void averageMeasurements(void);
 
+    /**
+     * @brief Get the number of good (ie, not -9999) results added to a place
+     * in the result array since the values were last cleared.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **uint16_t** The number of good results
+     */
+    uint16_t getGoodMeasurementCount(uint8_t resultNumber);
+
+    /**
+     * @brief Get one of the diagnostic values kept by the sensor, like a count
+     * of communication errors.
+     *
+     * Diagnostics are not part of the result array; they are reported by a
+     * Variable created with the #SENSOR_DIAGNOSTIC source.  Sensors with
+     * diagnostics override this.
+     *
+     * @param diagnosticNumber The number of the diagnostic, as defined by the
+     * specific sensor.
+     * @return **float** The diagnostic value; -9999 if the sensor has no such
+     * diagnostic.
+     */
+    virtual float getDiagnosticValue(uint8_t diagnosticNumber);
+
+    /**
+     * @brief Check if the sensor is being skipped because it has been
+     * failing.
+     *
+     * After #MS_SENSOR_FAILURES_BEFORE_BACKOFF complete updates in a row
+     * without a single good result, the sensor is skipped for one update, then
+     * tried again.  Each further failure doubles the number of updates it is
+     * skipped for, up to #MS_SENSOR_MAX_BACKOFF_CYCLES.  A skipped sensor is
+     * not powered or woken and its values are left at -9999.  The back-off is
+     * kept apart from the status bits, so the error bit (bit 7) is left alone.
+     *
+     * @return **bool** True if the next complete update will skip the sensor.
+     */
+    bool isQuarantined(void);
+    /**
+     * @brief Get the number of complete updates in a row the sensor has failed
+     * to return any good result.
+     *
+     * @return **uint8_t** The number of failed updates
+     */
+    uint8_t getConsecutiveFailures(void);
+    /**
+     * @brief Record the outcome of a complete update for the failure back-off.
+     *
+     * This is called by VariableArray::completeUpdate() after the results have
+     * been averaged.
+     *
+     * @param skipped True if the sensor was skipped in the update.
+     */
+    void recordUpdateOutcome(bool skipped);
+    /**
+     * @brief Forget any failures and try the sensor again in the next update.
+     */
+    void clearQuarantine(void);
+
+#ifdef MS_ROBUST_AVERAGING
+    /**
+     * @brief Set how the individual results are reduced to a single value.
+     *
+     * Spiky sensors, like turbidity, sonar, and analog conductivity, are
+     * better served by a median, trimmed mean, or spike-rejecting mean than
+     * by the plain mean.  Each needs at least 3 good results; with fewer, or
+     * with more than #MS_MAX_AVERAGING_SAMPLES, the plain mean is used.
+     *
+     * Any mode but the mean allocates room for #MS_MAX_AVERAGING_SAMPLES
+     * results per value from the heap, so call this once, in setup.
+     *
+     * @param mode The averaging mode to use.
+     */
+    void setAveragingMode(averagingMode mode);
+    /**
+     * @brief Get how the individual results are reduced to a single value.
+     *
+     * @return **averagingMode** The averaging mode in use.
+     */
+    averagingMode getAveragingMode(void);
+    /**
+     * @brief Reduce an array of values to a single value.
+     *
+     * This sorts the input array in place.
+     *
+     * @param values The array of values; it will be sorted.
+     * @param count The number of values in the array; at most
+     * #MS_MAX_AVERAGING_SAMPLES for the spike-rejecting average.
+     * @param mode The reduction to use.
+     * @return **float** The reduced value.
+     */
+    static float reduceValues(float* values, uint8_t count, averagingMode mode);
+#endif
+
+#ifdef MS_BURST_SAMPLING
+    /**
+     * @brief Sample the sensor at a fixed rate for a window of time in place
+     * of the usual measurements to average.
+     *
+     * The samples are timed by a deadline loop on micros() and every one of
+     * them is averaged into the result - and into the result statistics, if
+     * `MS_SENSOR_STATISTICS` is defined.  The raw results of one variable are
+     * also kept in a ring buffer so they can be saved with
+     * Logger::logBurstToSD().
+     *
+     * @note Bursts are only meant for sensors that return a result almost as
+     * soon as they are asked for it, like those read through an ADC.  The
+     * measurement time of the sensor is waited for in each sample, so the
+     * rate is limited to one sample per measurement time.
+     *
+     * @note The processor is busy for the whole window, so keep it well under
+     * the watch-dog timeout.
+     *
+     * @param rate_Hz The number of samples to take per second.  Use 0 to turn
+     * burst sampling off and free the buffer.
+     * @param window_ms The length of the burst in milliseconds.
+     * @param captureVarNum The position in the result array of the variable
+     * whose raw results should be kept; default 0.
+     */
+    void setBurstMode(uint16_t rate_Hz, uint16_t window_ms,
+                      uint8_t captureVarNum = 0);
+    /**
+     * @brief Check if burst sampling is turned on for this sensor.
+     *
+     * @return **bool** True if the sensor will be sampled in bursts
+     */
+    bool isBurstEnabled(void);
+    /**
+     * @brief Take a burst of samples from the sensor.
+     *
+     * The sensor must already be awake and stable.  This is called by
+     * update() and VariableArray::completeUpdate() in place of the usual
+     * measurements for any sensor with burst sampling on.
+     *
+     * @return **bool** True if every sample was started and returned
+     * successfully.
+     */
+    bool takeBurst(void);
+
+    /**
+     * @brief Get the number of samples taken in the most recent burst.
+     *
+     * @return **uint16_t** The number of samples taken; 0 if no burst has
+     * been taken.
+     */
+    uint16_t getBurstSampleCount(void);
+    /**
+     * @brief Get the number of times the most recent burst fell behind its
+     * sample schedule.
+     *
+     * @return **uint16_t** The number of missed sample deadlines
+     */
+    uint16_t getBurstOverruns(void);
+    /**
+     * @brief Get the millis() at the start of the most recent burst.
+     *
+     * @return **uint32_t** The processor time at the first sample
+     */
+    uint32_t getBurstStartMillis(void);
+    /**
+     * @brief Write the raw results kept from the most recent burst out to a
+     * stream in binary.
+     *
+     * This writes the sample period (uint32_t microseconds), the number of
+     * samples taken (uint16_t), the number of samples kept (uint16_t), the
+     * number of missed deadlines (uint16_t), and the position of the captured
+     * variable in the result array (uint8_t), followed by the kept samples as
+     * 4-byte floats, oldest first.  Everything is in the byte order of the
+     * processor (little endian for AVR and SAMD).  If more samples were taken
+     * than were kept, the kept ones are the last.
+     *
+     * @param stream The stream to write to
+     * @return **size_t** The number of bytes written
+     */
+    size_t writeBurst(Print* stream);
+#endif
+
+#ifdef MS_SENSOR_STATISTICS
+    // Statistics of the individual results averaged into each value.  These
+    // are accumulated as each result is added (Welford's method) so no
+    // individual results are stored and the memory used is fixed.  They are
+    // reset when the values are cleared at the start of each update and hold
+    // until the next one.  To log one, create a ResultStdDev, ResultMinimum,
+    // ResultMaximum or ResultCount variable for it, ie:
+    //     Variable* ds18TempSD = new ResultStdDev(&ds18, DS18_TEMP_VAR_NUM, 3,
+    //                                             "temperature",
+    //                                             "degreeCelsius", "DS18SD");
+    /**
+     * @brief Get the number of bad (-9999) results returned for a place in the
+     * result array since the values were last cleared.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **uint16_t** The number of bad results
+     */
+    uint16_t getBadMeasurementCount(uint8_t resultNumber);
+    /**
+     * @brief Get the smallest good result added to a place in the result array
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The minimum, or -9999 if there were no good results.
+     */
+    float getResultMinimum(uint8_t resultNumber);
+    /**
+     * @brief Get the largest good result added to a place in the result array
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The maximum, or -9999 if there were no good results.
+     */
+    float getResultMaximum(uint8_t resultNumber);
+    /**
+     * @brief Get the sample variance of the good results added to a place in
+     * the result array.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The variance, or -9999 if there were fewer than two
+     * good results.
+     */
+    float getResultVariance(uint8_t resultNumber);
+    /**
+     * @brief Get the sample standard deviation of the good results added to a
+     * place in the result array.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The standard deviation, or -9999 if there were fewer
+     * than two good results.
+     */
+    float getResultStandardDeviation(uint8_t resultNumber);
+#endif
+
     /**
      * @brief Register a variable object to a sensor.
      *
@@ -465,7 +778,92 @@ class Sensor {
      * @brief Array with the number of valid measurement values taken by the
      * sensor in the current update cycle.
      */
-    uint8_t numberGoodMeasurementsMade[MAX_NUMBER_VARS];
+    uint16_t numberGoodMeasurementsMade[MAX_NUMBER_VARS];
+#ifdef MS_ROBUST_AVERAGING
+    /**
+     * @brief How the individual results are reduced to a single value.
+     */
+    averagingMode _averagingMode;
+    /**
+     * @brief The individual good results of the current update cycle for each
+     * variable, kept for the median or trimmed averages.
+     *
+     * This holds #MS_MAX_AVERAGING_SAMPLES results for each returned value.
+     * It is only allocated by setAveragingMode() for a mode other than the
+     * mean, so sensors using the mean don't pay for it; NULL otherwise.
+     */
+    float* _resultSamples;
+#endif
+#ifdef MS_BURST_SAMPLING
+    /**
+     * @brief The number of samples per second to take in a burst; 0 if this
+     * sensor doesn't use burst sampling.
+     */
+    uint16_t _burstRate_Hz;
+    /**
+     * @brief The length of a burst in milliseconds.
+     */
+    uint16_t _burstWindow_ms;
+    /**
+     * @brief The position in the result array of the variable whose raw burst
+     * results are kept.
+     */
+    uint8_t _burstVarNum;
+
+    /**
+     * @brief The ring buffer of raw results from the most recent burst; NULL
+     * unless burst sampling is on.
+     */
+    float* _burstBuffer;
+    /**
+     * @brief The position in the ring buffer for the next raw result.
+     */
+    uint16_t _burstHead;
+    /**
+     * @brief The number of raw results in the ring buffer.
+     */
+    uint16_t _burstKept;
+    /**
+     * @brief The number of samples taken in the most recent burst.
+     */
+    uint16_t _burstTaken;
+    /**
+     * @brief The number of missed sample deadlines in the most recent burst.
+     */
+    uint16_t _burstOverruns;
+    /**
+     * @brief The time between samples of the most recent burst.
+     */
+    uint32_t _burstPeriod_us;
+    /**
+     * @brief The millis() at the start of the most recent burst.
+     */
+    uint32_t _burstStartMillis;
+    /**
+     * @brief True while a burst is being taken.
+     */
+    bool _burstCapturing;
+#endif
+#ifdef MS_SENSOR_STATISTICS
+    /**
+     * @brief Array with the number of bad (-9999) measurement values returned
+     * by the sensor in the current update cycle.
+     */
+    uint16_t numberBadMeasurementsMade[MAX_NUMBER_VARS];
+    /**
+     * @brief Array with the running sum of squared differences from the mean
+     * of the good values in the current update cycle.
+     */
+    float _resultM2[MAX_NUMBER_VARS];
+    /**
+     * @brief Array with the smallest good value in the current update cycle.
+     */
+    float _resultMin[MAX_NUMBER_VARS];
+    /**
+     * @brief Array with the largest good value in the current update cycle.
+     */
+    float _resultMax[MAX_NUMBER_VARS];
+#endif
 
     /**
      * @brief The time needed from the when a sensor has power until it's ready
@@ -516,6 +914,15 @@ class Sensor {
      */
     uint8_t _sensorStatus;
 
+    /**
+     * @brief The number of complete updates in a row with no good results
+     */
+    uint8_t _consecutiveFailures;
+    /**
+     * @brief The number of complete updates still to skip the sensor for
+     */
+    uint16_t _backoffCycles;
+
     /**
      * @brief An array for each sensor containing the variable objects tied to
      * that sensor.  The #MAX_NUMBER_VARS cannot be determined on a per-sensor
@@ -260,6 +260,8 @@ bool VariableArray::sensorsWake(void) {
 
                         if (sensorSuccess) {
                             MS_DBG(F("        ... wake up succeeded."));
+                            // Do any upkeep while the others warm up
+                            arrayOfVars[i]->parentSensor->runMaintenance();
                         } else {
                             MS_DBG(F("        ... wake up failed!"));
                         }
@@ -318,6 +320,16 @@ void VariableArray::sensorsPowerDown(void) {
 }
 
 
+// This is a wrapper for the timestampEvents function of each sensor
+void VariableArray::sensorsTimestampEvents(void) {
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (isLastVarFromSensor(i)) {  // Skip non-unique sensors
+            arrayOfVars[i]->parentSensor->timestampEvents();
+        }
+    }
+}
+
+
 // This function updates the values for any connected sensors.
 // Please note that this does NOT run the update functions, it instead uses
 // the startSingleMeasurement and addSingleMeasurementResult functions to
@@ -426,8 +438,21 @@ bool VariableArray::updateAllSensors(void) {
             // Only do checks on sensors that still have measurements to finish
             if (lastSensorVariable[i] &&
                 nMeasurementsToAverage[i] > nMeasurementsCompleted[i]) {
+#ifdef MS_BURST_SAMPLING
+                // If the sensor samples in bursts, take the whole burst at
+                // once in place of the measurements to average
+                if (arrayOfVars[i]->parentSensor->isBurstEnabled() &&
+                    arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
+                    MS_DBG(i, F("--->> Taking burst from"),
+                           arrayOfVars[i]->getParentSensorNameAndLocation(),
+                           F("..."));
+                    success &= arrayOfVars[i]->parentSensor->takeBurst();
+                    nMeasurementsCompleted[i] = nMeasurementsToAverage[i];
+                }
+#endif
                 // first, make sure the sensor is stable
-                if (arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
+                if (nMeasurementsCompleted[i] < nMeasurementsToAverage[i] &&
+                    arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
                     // now, if the sensor is not currently measuring...
                     if (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 5) ==
                         0) {  // NO attempt yet to start a measurement
@@ -541,6 +566,14 @@ bool VariableArray::completeUpdate(void) {
         lastSensorVariable[i] = isLastVarFromSensor(i);
     }
 
+    // Create an array of the sensors being skipped because they've been
+    // failing
+    bool skipSensor[_variableCount];
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        skipSensor[i] = lastSensorVariable[i] &&
+            arrayOfVars[i]->parentSensor->isQuarantined();
+    }
+
     // Create an array for the number of measurements already completed and set
     // all to zero
     MS_DBG(F("Creating an array for the number of completed measurements.."));
@@ -663,9 +696,26 @@ bool VariableArray::completeUpdate(void) {
     }
     MS_DBG(F("   ... Complete. <<-----"));
 
-    // power up all of the sensors together
+    // Mark any skipped sensors as already finished, leaving their values at
+    // -9999
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (skipSensor[i]) {
+            MS_DBG(i, F("--->> Skipping failing sensor"),
+                   arrayOfVars[i]->getParentSensorNameAndLocation(),
+                   F("<<---"));
+            nMeasurementsCompleted[i] = nMeasurementsToAverage[i];
+            nCompletedOnPin[powerPinIndex[i]] += nMeasurementsToAverage[i];
+            nSensorsCompleted++;
+        }
+    }
+
+    // power up all of the sensors together, except those being skipped
     MS_DBG(F("----->> Powering up all sensors together. ..."));
-    sensorsPowerUp();
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (lastSensorVariable[i] && !skipSensor[i]) {
+            arrayOfVars[i]->parentSensor->powerUp();
+        }
+    }
     MS_DBG(F("   ... Complete. <<-----"));
 
     while (nSensorsCompleted < _sensorCount) {
@@ -722,6 +772,8 @@ bool VariableArray::completeUpdate(void) {
 
                         if (sensorSuccess_wake) {
                             MS_DBG(F("   ... wake up uccess. <<---"), i);
+                            // Do any upkeep while the others warm up
+                            arrayOfVars[i]->parentSensor->runMaintenance();
                         } else {
                             MS_DBG(F("   ... wake up failed! <<---"), i);
                         }
@@ -750,10 +802,29 @@ bool VariableArray::completeUpdate(void) {
                         nMeasurementsToAverage[i];
                 }
 
+#ifdef MS_BURST_SAMPLING
+                // If the sensor samples in bursts, take the whole burst at
+                // once in place of the measurements to average
+                if (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 4) ==
+                        1 &&
+                    nMeasurementsCompleted[i] < nMeasurementsToAverage[i] &&
+                    arrayOfVars[i]->parentSensor->isBurstEnabled() &&
+                    arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
+                    MS_DBG(i, F("--->> Taking burst from"),
+                           arrayOfVars[i]->getParentSensorNameAndLocation(),
+                           F("..."));
+                    success &= arrayOfVars[i]->parentSensor->takeBurst();
+                    nCompletedOnPin[powerPinIndex[i]] +=
+                        nMeasurementsToAverage[i] - nMeasurementsCompleted[i];
+                    nMeasurementsCompleted[i] = nMeasurementsToAverage[i];
+                }
+#endif
+
                 // If the sensor was successfully awoken/activated...
                 // .. make sure the sensor is stable
                 if (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 4) ==
                         1 &&
+                    nMeasurementsCompleted[i] < nMeasurementsToAverage[i] &&
                     arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
                     // If no attempt has yet been made to start a measurement,
                     // start one
@@ -867,6 +938,7 @@ bool VariableArray::completeUpdate(void) {
             MS_DBG(F("--- Averaging results from"),
                    arrayOfVars[i]->getParentSensorNameAndLocation(), F("---"));
             arrayOfVars[i]->parentSensor->averageMeasurements();
+            arrayOfVars[i]->parentSensor->recordUpdateOutcome(skipSensor[i]);
             MS_DBG(F("--- Notifying variables from"),
                    arrayOfVars[i]->getParentSensorNameAndLocation(), F("---"));
             arrayOfVars[i]->parentSensor->notifyVariables();
@@ -230,6 +230,13 @@ class VariableArray {
      */
     void sensorsPowerDown(void);
 
+    /**
+     * @brief Time stamp the events all sensors have caught by interrupt.
+     *
+     * Runs the timestampEvents sensor function for each unique sensor.
+     */
+    void sensorsTimestampEvents(void);
+
     /**
      * @brief Update the values for all connected sensors.
      *
@@ -251,6 +258,9 @@ class VariableArray {
      * values.  Repeatedly checks each sensor's readiness state to optimize
      * timing.
      *
+     * Sensors that have been failing are skipped with an exponential
+     * back-off; see Sensor::isQuarantined().
+     *
      * @return **bool** True if all steps of the update succeeded.
      */
     bool completeUpdate(void);
@@ -101,6 +101,28 @@ Variable::Variable(float (*calcFxn)(), uint8_t decimalResolution,
     // MS_DBG(F("Calculated Variable object created"));
 }
 
+// The constructor for a statistic of the results of a measured variable or for
+// a sensor diagnostic
+Variable::Variable(Sensor* parentSense, const uint8_t sensorVarNum,
+                   resultStatistic statistic, uint8_t decimalResolution,
+                   const char* varName, const char* varUnit,
+                   const char* varCode, const char* uuid)
+    : _sensorVarNum(sensorVarNum), _statistic(statistic) {
+    setVarUUID(uuid);
+    setVarCode(varCode);
+    setVarUnit(varUnit);
+    setVarName(varName);
+    setResolution(decimalResolution);
+
+    isCalculated = false;
+    _calcFxn     = NULL;
+    attachSensor(parentSense);
+
+    // When we create the variable, we also want to initialize it with a current
+    // value of -9999 (ie, a bad result).
+    _currentValue = -9999;
+}
+
 // constructor with no arguments
 Variable::Variable() : _sensorVarNum(0), _decimalResolution(0) {
     _varName = NULL;
@@ -170,6 +192,9 @@ void Variable::attachSensor(Sensor* parentSense) {
                F("as variable number"), _sensorVarNum, F("to"),
                parentSensor->getSensorName(), F("attached at"),
                parentSensor->getSensorLocation(), F("..."));*/
+        // Only the mean is pushed to the variable by the sensor; statistics
+        // and diagnostics are read from the sensor when they're asked for
+        if (_statistic != RESULT_MEAN) return;
         parentSensor->registerVariable(_sensorVarNum, this);
     }
     // else
@@ -190,6 +215,11 @@ void Variable::onSensorUpdate(Sensor* parentSense) {
 }
 
 
+resultStatistic Variable::getStatistic(void) {
+    return _statistic;
+}
+
+
 // This is a helper - it returns the name of the parent sensor, if applicable
 // This is needed for dealing with variables in arrays
 String Variable::getParentSensorName(void) {
@@ -348,6 +378,22 @@ float Variable::getValue(bool updateValue) {
         return _calcFxn();
     } else {
         if (updateValue) parentSensor->update();
+        switch (_statistic) {
+#ifdef MS_SENSOR_STATISTICS
+            case RESULT_STD_DEV:
+                return parentSensor->getResultStandardDeviation(_sensorVarNum);
+            case RESULT_MINIMUM:
+                return parentSensor->getResultMinimum(_sensorVarNum);
+            case RESULT_MAXIMUM:
+                return parentSensor->getResultMaximum(_sensorVarNum);
+#endif
+            case RESULT_GOOD_COUNT:
+                return parentSensor->getGoodMeasurementCount(_sensorVarNum);
+            case SENSOR_DIAGNOSTIC:
+                return parentSensor->getDiagnosticValue(_sensorVarNum);
+            case RESULT_MEAN:
+            default: break;
+        }
         return _currentValue;
     }
 }
@@ -27,6 +27,21 @@ class Sensor;
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
 
+/**
+ * @brief The statistic of a sensor's results that a variable reports.
+ *
+ * Only the mean, the good result count, and sensor diagnostics are reported
+ * unless `MS_SENSOR_STATISTICS` is defined.
+ */
+typedef enum resultStatistic {
+    RESULT_MEAN = 0,     ///< The mean of the good results (the usual value)
+    RESULT_STD_DEV,      ///< The sample standard deviation of the good results
+    RESULT_MINIMUM,      ///< The smallest good result
+    RESULT_MAXIMUM,      ///< The largest good result
+    RESULT_GOOD_COUNT,   ///< The number of good results
+    SENSOR_DIAGNOSTIC,   ///< A value from Sensor::getDiagnosticValue()
+} resultStatistic;
+
 /**
  * @brief The variable class for a value and related metadata.
  *
@@ -365,6 +380,38 @@ class Variable {
      */
     bool isCalculated;
 
+    /**
+     * @brief Construct a new Variable object for a statistic of the results
+     * of a measured variable or for a sensor diagnostic.
+     *
+     * These variables are not registered with the parent sensor, so they do
+     * not displace the variable for the mean.  Their value is read from the
+     * parent sensor whenever it is asked for.
+     *
+     * @param parentSense The Sensor object supplying values.
+     * @param sensorVarNum The position in the sensor's value array of the
+     * variable to report the statistic of, or the number of the diagnostic.
+     * @param statistic The statistic to report, or #SENSOR_DIAGNOSTIC.
+     * @param decimalResolution The resolution (in decimal places) of the value.
+     * @param varName The name of the variable per the [ODM2 variable name
+     * controlled vocabulary](http://vocabulary.odm2.org/variablename/)
+     * @param varUnit The unit of the variable per the [ODM2 unit controlled
+     * vocabulary](http://vocabulary.odm2.org/units/)
+     * @param varCode A custom code for the variable.  This can be any short
+     * text helping to identify the variable in files.
+     * @param uuid A universally unique identifier for the variable.
+     */
+    Variable(Sensor* parentSense, const uint8_t sensorVarNum,
+             resultStatistic statistic, uint8_t decimalResolution,
+             const char* varName, const char* varUnit, const char* varCode,
+             const char* uuid);
+    /**
+     * @brief Get the statistic of the sensor results this variable reports.
+     *
+     * @return **resultStatistic** The statistic
+     */
+    resultStatistic getStatistic(void);
+
  protected:
     /**
      * @brief The current data value
@@ -376,6 +423,7 @@ class Variable {
 
     const uint8_t _sensorVarNum;
     uint8_t       _decimalResolution;
+    resultStatistic _statistic = RESULT_MEAN;
 
     const char* _varName;
     const char* _varUnit;
@@ -383,4 +431,154 @@ class Variable {
     const char* _uuid;
 };
 
+
+#ifdef MS_SENSOR_STATISTICS
+/**
+ * @brief The Variable sub-class for the sample standard deviation of the
+ * results averaged into one of a sensor's values.
+ *
+ * The standard deviation is in the same units as the value itself.  It is
+ * -9999 if fewer than two good results were averaged.
+ *
+ * @ingroup base_classes
+ */
+class ResultStdDev : public Variable {
+ public:
+    /**
+     * @brief Construct a new ResultStdDev object.
+     *
+     * @param parentSense The Sensor object supplying values.
+     * @param sensorVarNum The position in the sensor's value array of the
+     * variable to report the standard deviation of.
+     * @param decimalResolution The resolution (in decimal places) of the value.
+     * @param varName The name of the variable per the ODM2 variable name
+     * controlled vocabulary; usually the same as for the value itself.
+     * @param varUnit The unit of the variable per the ODM2 unit controlled
+     * vocabulary; the same as for the value itself.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "ResultStdDev".
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     */
+    ResultStdDev(Sensor* parentSense, const uint8_t sensorVarNum,
+                 uint8_t decimalResolution, const char* varName,
+                 const char* varUnit, const char* varCode = "ResultStdDev",
+                 const char* uuid = "")
+        : Variable(parentSense, sensorVarNum, RESULT_STD_DEV,
+                   decimalResolution, varName, varUnit, varCode, uuid) {}
+    /**
+     * @brief Destroy the ResultStdDev object - no action needed.
+     */
+    ~ResultStdDev() {}
+};
+
+
+/**
+ * @brief The Variable sub-class for the smallest of the results averaged into
+ * one of a sensor's values.
+ *
+ * @ingroup base_classes
+ */
+class ResultMinimum : public Variable {
+ public:
+    /**
+     * @brief Construct a new ResultMinimum object.
+     *
+     * @param parentSense The Sensor object supplying values.
+     * @param sensorVarNum The position in the sensor's value array of the
+     * variable to report the minimum of.
+     * @param decimalResolution The resolution (in decimal places) of the value.
+     * @param varName The name of the variable per the ODM2 variable name
+     * controlled vocabulary; usually the same as for the value itself.
+     * @param varUnit The unit of the variable per the ODM2 unit controlled
+     * vocabulary; the same as for the value itself.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "ResultMinimum".
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     */
+    ResultMinimum(Sensor* parentSense, const uint8_t sensorVarNum,
+                  uint8_t decimalResolution, const char* varName,
+                  const char* varUnit, const char* varCode = "ResultMinimum",
+                  const char* uuid = "")
+        : Variable(parentSense, sensorVarNum, RESULT_MINIMUM,
+                   decimalResolution, varName, varUnit, varCode, uuid) {}
+    /**
+     * @brief Destroy the ResultMinimum object - no action needed.
+     */
+    ~ResultMinimum() {}
+};
+
+
+/**
+ * @brief The Variable sub-class for the largest of the results averaged into
+ * one of a sensor's values.
+ *
+ * @ingroup base_classes
+ */
+class ResultMaximum : public Variable {
+ public:
+    /**
+     * @brief Construct a new ResultMaximum object.
+     *
+     * @param parentSense The Sensor object supplying values.
+     * @param sensorVarNum The position in the sensor's value array of the
+     * variable to report the maximum of.
+     * @param decimalResolution The resolution (in decimal places) of the value.
+     * @param varName The name of the variable per the ODM2 variable name
+     * controlled vocabulary; usually the same as for the value itself.
+     * @param varUnit The unit of the variable per the ODM2 unit controlled
+     * vocabulary; the same as for the value itself.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "ResultMaximum".
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     */
+    ResultMaximum(Sensor* parentSense, const uint8_t sensorVarNum,
+                  uint8_t decimalResolution, const char* varName,
+                  const char* varUnit, const char* varCode = "ResultMaximum",
+                  const char* uuid = "")
+        : Variable(parentSense, sensorVarNum, RESULT_MAXIMUM,
+                   decimalResolution, varName, varUnit, varCode, uuid) {}
+    /**
+     * @brief Destroy the ResultMaximum object - no action needed.
+     */
+    ~ResultMaximum() {}
+};
+
+
+/**
+ * @brief The Variable sub-class for the number of good results averaged into
+ * one of a sensor's values.
+ *
+ * The count is reported with the variable name "count" and the unit
+ * "count".
+ *
+ * @ingroup base_classes
+ */
+class ResultCount : public Variable {
+ public:
+    /**
+     * @brief Construct a new ResultCount object.
+     *
+     * @param parentSense The Sensor object supplying values.
+     * @param sensorVarNum The position in the sensor's value array of the
+     * variable to report the number of good results for.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "ResultCount".
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     */
+    explicit ResultCount(Sensor* parentSense, const uint8_t sensorVarNum,
+                         const char* varCode = "ResultCount",
+                         const char* uuid    = "")
+        : Variable(parentSense, sensorVarNum, RESULT_GOOD_COUNT, 0, "count",
+                   "count", varCode, uuid) {}
+    /**
+     * @brief Destroy the ResultCount object - no action needed.
+     */
+    ~ResultCount() {}
+};
+#endif
+
 #endif  // SRC_VARIABLEBASE_H_
@@ -14,7 +14,6 @@
 #ifndef SRC_MODEMS_LOGGERMODEMMACROS_H_
 #define SRC_MODEMS_LOGGERMODEMMACROS_H_
 
-
 /**
  * @brief Creates an extraModemSetup() function for a specific modem subclass.
  *
@@ -38,6 +37,9 @@
 /**
  * @brief Creates an isModemAwake() function for a specific modem subclass.
  *
+ * The wake style is read from #loggerModem::_wakePulse_ms, which is set once
+ * by the modem's constructor.
+ *
  * @param specificModem The modem subclass
  *
  * @return The text of an isModemAwake() function specific to a single modem
@@ -60,11 +62,9 @@
                we're going to check the level of the held pin as the           \
                indication of whether attempts were made to wake the modem      \
                before entering the setup function. */                          \
-            int8_t sleepRqBitNumber =                                          \
-                log(digitalPinToBitMask(_modemSleepRqPin)) / log(2);           \
-            bool currentRqPinState = bitRead(                                  \
-                *portInputRegister(digitalPinToPort(_modemSleepRqPin)),        \
-                sleepRqBitNumber);                                             \
+            bool currentRqPinState =                                           \
+                (*portInputRegister(digitalPinToPort(_modemSleepRqPin)) &      \
+                 digitalPinToBitMask(_modemSleepRqPin)) != 0;                  \
             MS_DBG(F("Current state of sleep request pin"), _modemSleepRqPin,  \
                    '=', currentRqPinState ? F("HIGH") : F("LOW"),              \
                    F("meaning"), getModemName(), F("should be"),               \
@@ -93,9 +93,27 @@
     }
 
 
+/**
+ * @def MS_MODEM_START_ACTIVE_TIMER
+ * @brief Creates a text string to mark the time the modem was woken, used to
+ * calculate the modem active time.
+ *
+ * This is an empty string unless MS_CHECK_MODEM_TIMING is defined.
+ *
+ * @return Text string marking the start of the active time.
+ */
+#ifdef MS_CHECK_MODEM_TIMING
+#define MS_MODEM_START_ACTIVE_TIMER _millisActive = millis();
+#else
+#define MS_MODEM_START_ACTIVE_TIMER
+#endif
+
 /**
  * @brief Creates a modemWake() function for a specific modem subclass.
  *
+ * The warm-up and AT response times are read from
+ * #loggerModem::_wakeDelayTime_ms and #loggerModem::_max_atresponse_time_ms.
+ *
  * @param specificModem The modem subclass
  *
  * @return The text of a modemWake() function specific to a single modem
@@ -103,6 +121,7 @@
  */
 #define MS_MODEM_WAKE(specificModem)                                           \
     bool specificModem::modemWake(void) {                                      \
+        MS_MODEM_START_ACTIVE_TIMER                                            \
         /* Power up */                                                         \
         if (_millisPowerOn == 0) { modemPowerUp(); }                           \
                                                                                \
@@ -111,9 +130,11 @@
           the pin modes in the wake function. */                               \
         setModemPinModes();                                                    \
                                                                                \
-        MS_DBG(F("Wait"), _wakeDelayTime_ms - (millis() - _millisPowerOn),     \
-               F("ms longer for warm-up"));                                    \
-        while (millis() - _millisPowerOn < _wakeDelayTime_ms) {}               \
+        if (_wakeDelayTime_ms > 0) {                                           \
+            MS_DBG(F("Wait"), _wakeDelayTime_ms - (millis() - _millisPowerOn), \
+                   F("ms longer for warm-up"));                                \
+            while (millis() - _millisPowerOn < _wakeDelayTime_ms) {}           \
+        }                                                                      \
                                                                                \
         if (isModemAwake()) {                                                  \
             MS_DBG(getModemName(),                                             \
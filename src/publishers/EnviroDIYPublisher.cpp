@@ -122,7 +122,9 @@ void EnviroDIYPublisher::printSensorDataJSON(Stream* stream) {
     stream->print(samplingFeatureTag);
     stream->print(_baseLogger->getSamplingFeatureUUID());
     stream->print(timestampTag);
-    stream->print(_baseLogger->formatDateTime_ISO8601(Logger::markedEpochTime));
+    char dateTimeStr[ISO8601_BUFFER_SIZE];
+    _baseLogger->formatDateTime_ISO8601(Logger::markedEpochTime, dateTimeStr);
+    stream->print(dateTimeStr);
     stream->print(F("\","));
 
     for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
@@ -233,8 +235,8 @@ int16_t EnviroDIYPublisher::publishData(Client* outClient) {
 
         if (bufferFree() < 42) printTxBuffer(outClient);
         strcat(txBuffer, timestampTag);
-        _baseLogger->formatDateTime_ISO8601(Logger::markedEpochTime)
-            .toCharArray(tempBuffer, 37);
+        _baseLogger->formatDateTime_ISO8601(Logger::markedEpochTime,
+                                            tempBuffer);
         strcat(txBuffer, tempBuffer);
         txBuffer[strlen(txBuffer)] = '"';
         txBuffer[strlen(txBuffer)] = ',';
@@ -146,8 +146,7 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient) {
 
     emptyTxBuffer();
 
-    _baseLogger->formatDateTime_ISO8601(Logger::markedEpochTime)
-        .toCharArray(tempBuffer, 26);
+    _baseLogger->formatDateTime_ISO8601(Logger::markedEpochTime, tempBuffer);
     strcat(txBuffer, "created_at=");
     strcat(txBuffer, tempBuffer);
     txBuffer[strlen(txBuffer)] = '&';
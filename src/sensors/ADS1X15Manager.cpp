@@ -0,0 +1,261 @@
+/**
+ * @file ADS1X15Manager.cpp
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the ADS1X15Manager class.
+ */
+
+
+#include "ADS1X15Manager.h"
+
+// The ADS1x15 registers
+#define ADS1X15_REG_CONVERSION 0x00
+#define ADS1X15_REG_CONFIG 0x01
+
+// The configuration for a single-ended single-shot conversion, less the
+// channel:
+//  - OS = 1 to start a conversion
+//  - PGA = 001 for a gain of one, +/- 4.096V
+//  - MODE = 1 for single-shot
+//  - DR = 100 for 128 samples/s on the ADS1115 or 1600 on the ADS1015
+//  - COMP_QUE = 11 to disable the comparator
+#define ADS1X15_CONFIG_SINGLE_SHOT 0x8383
+// The MUX setting for a single-ended reading on channel 0 (AIN0 vs GND)
+#define ADS1X15_MUX_SINGLE_0 0x4000
+// The OS bit reads as 1 when no conversion is in progress
+#define ADS1X15_CONFIG_OS_IDLE 0x8000
+
+// The manager objects
+ADS1X15Manager ADS1X15Manager::_managers[ADS1X15_NUM_ADDRESSES];
+
+
+// This returns the manager for an ADC address
+ADS1X15Manager* ADS1X15Manager::getManager(uint8_t i2cAddress) {
+    if (i2cAddress < ADS1X15_BASE_ADDRESS ||
+        i2cAddress >= ADS1X15_BASE_ADDRESS + ADS1X15_NUM_ADDRESSES) {
+        MS_DBG(F("There is no ADS1x15 at 0x"), String(i2cAddress, HEX));
+        return NULL;
+    }
+    ADS1X15Manager* manager =
+        &_managers[i2cAddress - ADS1X15_BASE_ADDRESS];
+
+    // Set up the manager the first time it's asked for
+    if (manager->_i2cAddress == 0) {
+        MS_DBG(F("Setting up the manager for the ADS1x15 at 0x"),
+               String(i2cAddress, HEX));
+        I2CBus::getBus()->begin();
+        manager->_i2cAddress = i2cAddress;
+        manager->_pending    = 0;
+        manager->_ready      = 0;
+        manager->_failed     = 0;
+        manager->_converting = -1;
+    }
+    return manager;
+}
+
+
+// This queues a conversion on a channel
+bool ADS1X15Manager::requestConversion(uint8_t channel) {
+    if (channel >= ADS1X15_NUM_CHANNELS) return false;
+
+    // Any earlier result on the channel is now stale
+    bitClear(_ready, channel);
+    bitClear(_failed, channel);
+    if (_converting != channel) { bitSet(_pending, channel); }
+
+    // Start the conversion now if the ADC isn't busy
+    service();
+    return true;
+}
+
+
+// This returns the result of a conversion, waiting for it if needed
+float ADS1X15Manager::getVoltage(uint8_t channel) {
+    if (channel >= ADS1X15_NUM_CHANNELS) return -9999;
+
+    uint32_t start = millis();
+    while (!bitRead(_ready, channel) &&
+           (bitRead(_pending, channel) || _converting == channel) &&
+           millis() - start < ADS1X15_MAX_WAIT_MS) {
+        service();
+    }
+
+    if (!bitRead(_ready, channel) || bitRead(_failed, channel)) {
+        MS_DBG(F("No conversion result for channel"), channel, F("of 0x"),
+               String(_i2cAddress, HEX));
+        return -9999;
+    }
+
+#ifndef MS_USE_ADS1015
+    // 16-bit result, 0.125mV per bit at a gain of one
+    return _results[channel] * 0.000125;
+#else
+    // 12-bit result left aligned in the register, 2mV per bit
+    return (_results[channel] >> 4) * 0.002;
+#endif
+}
+
+
+// This collects a finished conversion and starts the next
+void ADS1X15Manager::service(void) {
+    if (_converting >= 0) {
+        // Don't bother the ADC until the conversion should be done
+        if (micros() - _conversionStart < ADS1X15_CONVERSION_TIME_US) return;
+
+        uint16_t config;
+        if (!readRegister(ADS1X15_REG_CONFIG, config)) {
+            bitSet(_failed, _converting);
+            bitSet(_ready, _converting);
+            _converting = -1;
+        } else if (config & ADS1X15_CONFIG_OS_IDLE) {
+            uint16_t result;
+            if (readRegister(ADS1X15_REG_CONVERSION, result)) {
+                _results[_converting] = static_cast<int16_t>(result);
+            } else {
+                bitSet(_failed, _converting);
+            }
+            bitSet(_ready, _converting);
+            MS_DBG(F("Finished conversion on channel"), _converting, F("of 0x"),
+                   String(_i2cAddress, HEX), F("in"),
+                   micros() - _conversionStart, F("µs"));
+            _converting = -1;
+        } else {
+            // Still converting
+            return;
+        }
+    }
+
+    // Start the lowest queued channel
+    for (uint8_t channel = 0; channel < ADS1X15_NUM_CHANNELS; channel++) {
+        if (bitRead(_pending, channel)) {
+            bitClear(_pending, channel);
+            if (startConversion(channel)) {
+                _converting      = channel;
+                _conversionStart = micros();
+            } else {
+                bitSet(_failed, channel);
+                bitSet(_ready, channel);
+            }
+            return;
+        }
+    }
+}
+
+
+bool ADS1X15Manager::startConversion(uint8_t channel) {
+    MS_DBG(F("Starting conversion on channel"), channel, F("of 0x"),
+           String(_i2cAddress, HEX));
+    uint16_t config = ADS1X15_CONFIG_SINGLE_SHOT | ADS1X15_MUX_SINGLE_0 |
+        (static_cast<uint16_t>(channel) << 12);
+    return writeRegister(ADS1X15_REG_CONFIG, config);
+}
+
+
+bool ADS1X15Manager::writeRegister(uint8_t reg, uint16_t value) {
+    I2CBus* bus = I2CBus::getBus();
+    bus->beginTransaction(_i2cAddress);
+    Wire.beginTransmission(_i2cAddress);
+    Wire.write(reg);
+    Wire.write(static_cast<uint8_t>(value >> 8));
+    Wire.write(static_cast<uint8_t>(value & 0xFF));
+    bool success = Wire.endTransmission() == 0;
+    bus->endTransaction(success);
+    return success;
+}
+
+
+bool ADS1X15Manager::readRegister(uint8_t reg, uint16_t& value) {
+    I2CBus* bus = I2CBus::getBus();
+    bus->beginTransaction(_i2cAddress);
+    Wire.beginTransmission(_i2cAddress);
+    Wire.write(reg);
+    bool success = Wire.endTransmission() == 0 &&
+        Wire.requestFrom(_i2cAddress, static_cast<uint8_t>(2)) == 2;
+    if (success) {
+        value = static_cast<uint16_t>(Wire.read()) << 8;
+        value |= static_cast<uint8_t>(Wire.read());
+    }
+    bus->endTransaction(success);
+    return success;
+}
+
+
+// The constructor - need the power pin, the channel, and the ADC address
+ADS1X15Sensor::ADS1X15Sensor(const char* sensorName,
+                             const uint8_t numReturnedVars,
+                             uint32_t warmUpTime_ms,
+                             uint32_t stabilizationTime_ms,
+                             uint32_t measurementTime_ms, int8_t powerPin,
+                             uint8_t adsChannel, uint8_t i2cAddress,
+                             uint8_t measurementsToAverage)
+    : Sensor(sensorName, numReturnedVars, warmUpTime_ms, stabilizationTime_ms,
+             measurementTime_ms, powerPin, -1, measurementsToAverage) {
+    _adsChannel = adsChannel;
+    _i2cAddress = i2cAddress;
+}
+// Destructor
+ADS1X15Sensor::~ADS1X15Sensor() {}
+
+
+String ADS1X15Sensor::getSensorLocation(void) {
+#ifndef MS_USE_ADS1015
+    String sensorLocation = F("ADS1115_0x");
+#else
+    String sensorLocation = F("ADS1015_0x");
+#endif
+    sensorLocation += String(_i2cAddress, HEX);
+    sensorLocation += F("_Channel");
+    sensorLocation += String(_adsChannel);
+    return sensorLocation;
+}
+
+
+bool ADS1X15Sensor::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+
+    // Queue a conversion on the ADC; it will be started as soon as any
+    // conversions on other channels are finished
+    ADS1X15Manager* ads = ADS1X15Manager::getManager(_i2cAddress);
+    bool success = ads != NULL && ads->requestConversion(_adsChannel);
+
+    if (!success) {
+        // Make sure that the measurement start time and success bit (bit 6)
+        // are unset
+        MS_DBG(getSensorNameAndLocation(),
+               F("did not successfully start a measurement."));
+        _millisMeasurementRequested = 0;
+        _sensorStatus &= 0b10111111;
+    }
+
+    return success;
+}
+
+
+bool ADS1X15Sensor::isMeasurementComplete(bool debug) {
+    // Give the ADC a chance to move on to the next queued conversion
+    ADS1X15Manager* ads = ADS1X15Manager::getManager(_i2cAddress);
+    if (ads != NULL) { ads->service(); }
+    return Sensor::isMeasurementComplete(debug);
+}
+
+
+float ADS1X15Sensor::getADSVoltage(void) {
+    float adcVoltage = -9999;
+
+    ADS1X15Manager* ads = ADS1X15Manager::getManager(_i2cAddress);
+    if (ads != NULL) { adcVoltage = ads->getVoltage(_adsChannel); }
+    MS_DBG(F("  ADS1X15Manager::getVoltage("), _adsChannel, F("):"),
+           adcVoltage);
+
+    // Skip results out of range
+    if (adcVoltage < 3.6 && adcVoltage > -0.3) {
+        return adcVoltage;
+    } else {
+        return -9999;
+    }
+}
@@ -0,0 +1,278 @@
+/**
+ * @file ADS1X15Manager.h
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the ADS1X15Manager class, which shares a TI ADS1115 (or
+ * ADS1015) between all of the sensors attached to its channels, and the
+ * ADS1X15Sensor class those sensors are built on.
+ *
+ * The manager talks to the ADC directly over the primary hardware I2C
+ * instance.  Conversions are queued by channel and run back to back so a
+ * sensor only waits on the ADC if its result isn't ready when it asks for it.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_ADS1X15MANAGER_H_
+#define SRC_SENSORS_ADS1X15MANAGER_H_
+
+// Debugging Statement
+// #define MS_ADS1X15MANAGER_DEBUG
+
+#ifdef MS_ADS1X15MANAGER_DEBUG
+#define MS_DEBUGGING_STD "ADS1X15Manager"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "I2CBus.h"
+#include "SensorBase.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+/** @ingroup analog_group */
+/**@{*/
+
+/// @brief The number of single-ended channels on an ADS1x15
+#define ADS1X15_NUM_CHANNELS 4
+/// @brief The number of ADS1x15's that can share an I2C bus - 0x48 to 0x4B
+#define ADS1X15_NUM_ADDRESSES 4
+/// @brief The lowest I2C address of an ADS1x15, 1001 000 (ADDR = GND)
+#define ADS1X15_BASE_ADDRESS 0x48
+
+#ifndef MS_USE_ADS1015
+/**
+ * @brief The time for a single conversion in microseconds; the ADS1115 is run
+ * at 128 samples per second, so a conversion takes 7.8ms.
+ */
+#define ADS1X15_CONVERSION_TIME_US 8000
+#else
+/**
+ * @brief The time for a single conversion in microseconds; the ADS1015 is run
+ * at 1600 samples per second, so a conversion takes 625µs.
+ */
+#define ADS1X15_CONVERSION_TIME_US 700
+#endif
+
+/**
+ * @brief The longest time to wait for a queued conversion to come back, in
+ * milliseconds.
+ *
+ * This is long enough for every channel to be converted ahead of the one being
+ * waited for.
+ */
+#define ADS1X15_MAX_WAIT_MS 50
+/**@}*/
+
+/**
+ * @brief Shares a TI ADS1x15 analog-to-digital converter between all of the
+ * sensors on its channels.
+ *
+ * There is one manager for each of the four possible ADC addresses; sensors
+ * get theirs with ADS1X15Manager::getManager().  A sensor asks for a
+ * conversion when it starts a measurement and picks up the result when it
+ * collects the measurement.  The ADC can only convert one channel at a time,
+ * so requests are queued and each conversion is started as soon as the one
+ * before it finishes.  When the sensors on an ADC are measured together, most
+ * results are already waiting when they're collected.
+ *
+ * The ADC is always run single-shot, at a gain of one (+/- 4.096V), at 128
+ * samples per second for the ADS1115 or 1600 for the ADS1015.  Because every
+ * conversion writes its own configuration there's nothing else to set up.
+ *
+ * @ingroup analog_group
+ */
+class ADS1X15Manager {
+ public:
+    /**
+     * @brief Get the manager for the ADC at an I2C address.
+     *
+     * @param i2cAddress The I2C address of the ADS 1x15 (0x48-0x4B)
+     * @return **ADS1X15Manager\*** The manager, or NULL if the address isn't
+     * one an ADS1x15 can have.
+     */
+    static ADS1X15Manager* getManager(uint8_t i2cAddress);
+
+    /**
+     * @brief Queue a single-ended conversion on a channel.
+     *
+     * If the ADC is idle the conversion is started right away.  If a
+     * conversion on the channel is already queued, this does nothing; both
+     * requests will get the same result.
+     *
+     * @param channel The channel to convert (0-3)
+     * @return **bool** True if the conversion was queued or started
+     */
+    bool requestConversion(uint8_t channel);
+
+    /**
+     * @brief Get the voltage from the most recently requested conversion on a
+     * channel, waiting for it if it isn't finished yet.
+     *
+     * @param channel The channel to get the result of (0-3)
+     * @return **float** The voltage, or -9999 if the conversion failed or was
+     * never requested.
+     */
+    float getVoltage(uint8_t channel);
+
+    /**
+     * @brief Collect a finished conversion and start the next queued one.
+     *
+     * This is called by getVoltage() while it waits, but may be called at any
+     * time to keep the queue moving.
+     */
+    void service(void);
+
+ protected:
+    /**
+     * @brief Start a single-shot conversion on a channel
+     *
+     * @param channel The channel to convert (0-3)
+     * @return **bool** True if the configuration was written to the ADC
+     */
+    bool startConversion(uint8_t channel);
+    /**
+     * @brief Write a 16-bit register of the ADC
+     *
+     * @param reg The register to write
+     * @param value The value to write to it
+     * @return **bool** True if the ADC acknowledged the write
+     */
+    bool writeRegister(uint8_t reg, uint16_t value);
+    /**
+     * @brief Read a 16-bit register of the ADC
+     *
+     * @param reg The register to read
+     * @param value The value read
+     * @return **bool** True if the ADC returned both bytes
+     */
+    bool readRegister(uint8_t reg, uint16_t& value);
+
+    /**
+     * @brief The I2C address of the ADC; 0 until the manager is first used
+     */
+    uint8_t _i2cAddress;
+    /**
+     * @brief A bit mask of the channels waiting for a conversion to start
+     */
+    uint8_t _pending;
+    /**
+     * @brief A bit mask of the channels with a finished conversion
+     */
+    uint8_t _ready;
+    /**
+     * @brief A bit mask of the channels whose last conversion failed
+     */
+    uint8_t _failed;
+    /**
+     * @brief The channel being converted, or -1 if the ADC is idle
+     */
+    int8_t _converting;
+    /**
+     * @brief The micros() when the current conversion was started
+     */
+    uint32_t _conversionStart;
+    /**
+     * @brief The raw result of the last conversion on each channel
+     */
+    int16_t _results[ADS1X15_NUM_CHANNELS];
+
+    /**
+     * @brief The managers for each possible ADC address
+     */
+    static ADS1X15Manager _managers[ADS1X15_NUM_ADDRESSES];
+};
+
+
+
+/**
+ * @brief The base class for the analog sensors read through a channel of a TI
+ * ADS1x15.
+ *
+ * This queues a conversion with the ADS1X15Manager when a measurement is
+ * started and keeps the queue moving while the measurement is waited for.  A
+ * sub-class only needs to convert the voltage from getADSVoltage() into its
+ * results in addSingleMeasurementResult().
+ *
+ * @ingroup analog_group
+ */
+class ADS1X15Sensor : public Sensor {
+ public:
+    /**
+     * @brief Construct a new ADS1X15Sensor object.
+     *
+     * @param sensorName The name of the sensor.
+     * @param numReturnedVars The number of variable results returned by the
+     * sensor.
+     * @param warmUpTime_ms The time needed from the when a sensor has power
+     * until it's ready to talk (_warmUpTime_ms).
+     * @param stabilizationTime_ms The time needed from the when a sensor is
+     * activated until the readings are stable (_stabilizationTime_ms).
+     * @param measurementTime_ms The time needed from the when a sensor is told
+     * to take a single reading until that reading is expected to be complete
+     * (_measurementTime_ms)
+     * @param powerPin The pin on the mcu controlling power to the sensor.
+     * Use -1 if it is continuously powered.
+     * @param adsChannel The analog data channel _on the TI ADS1x15_ that the
+     * sensor is connected to (0-3).
+     * @param i2cAddress The I2C address of the ADS 1x15
+     * @param measurementsToAverage The number of measurements to take and
+     * average before giving a "final" result from the sensor.
+     */
+    ADS1X15Sensor(const char* sensorName, const uint8_t numReturnedVars,
+                  uint32_t warmUpTime_ms, uint32_t stabilizationTime_ms,
+                  uint32_t measurementTime_ms, int8_t powerPin,
+                  uint8_t adsChannel, uint8_t i2cAddress,
+                  uint8_t measurementsToAverage);
+    /**
+     * @brief Destroy the ADS1X15Sensor object - no action needed
+     */
+    virtual ~ADS1X15Sensor();
+
+    /**
+     * @brief Report the I2C address of the ADS and the channel that the sensor
+     * is attached to.
+     *
+     * @return **String** Text describing how the sensor is attached to the mcu.
+     */
+    String getSensorLocation(void) override;
+
+    /**
+     * @brief Do the same as Sensor::startSingleMeasurement() and queue a
+     * conversion on the ADS1x15 channel.
+     *
+     * @return **bool** True if the measurement was started successfully.
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @copydoc Sensor::isMeasurementComplete(bool debug)
+     *
+     * This also keeps the queue of conversions on the ADS1x15 moving.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+
+ protected:
+    /**
+     * @brief Get the voltage from the conversion queued when the measurement
+     * was started.
+     *
+     * This only waits if the conversion isn't finished yet.
+     *
+     * @return **float** The voltage, or -9999 if the conversion failed or the
+     * voltage is outside of the range the ADC can read when powered at 3.3V.
+     */
+    float getADSVoltage(void);
+
+    /**
+     * @brief The channel on the ADS1x15 the sensor is attached to
+     */
+    uint8_t _adsChannel;
+    /**
+     * @brief The I2C address of the ADS1x15
+     */
+    uint8_t _i2cAddress;
+};
+
+#endif  // SRC_SENSORS_ADS1X15MANAGER_H_
@@ -34,15 +34,8 @@ String AOSongAM2315::getSensorLocation(void) {
 
 
 bool AOSongAM2315::setup(void) {
-    Wire.begin();  // Start the wire library (sensor power not required)
-    // Eliminate any potential extra waits in the wire library
-    // These waits would be caused by a readBytes or parseX being called
-    // on wire after the Wire buffer has emptied.  The default stream
-    // functions - used by wire - wait a timeout period after reading the
-    // end of the buffer to see if an interrupt puts something into the
-    // buffer.  In the case of the Wire library, that will never happen and
-    // the timeout period is a useless delay.
-    Wire.setTimeout(0);
+    // Start the wire library, if it isn't already (sensor power not required)
+    I2CBus::getBus(_i2c)->begin();
     return Sensor::setup();  // this will set pin modes and the setup status bit
 }
 
@@ -59,7 +52,10 @@ bool AOSongAM2315::addSingleMeasurementResult(void) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         Adafruit_AM2315 am2315(_i2c);  // create a sensor object
+        I2CBus*         bus = I2CBus::getBus(_i2c);
+        bus->beginTransaction(AM2315_I2C_ADDRESS);
         ret_val = am2315.readTemperatureAndHumidity(&temp_val, &humid_val);
+        bus->endTransaction(ret_val);
 
         if (!ret_val || isnan(temp_val)) temp_val = -9999;
         if (!ret_val || isnan(humid_val)) humid_val = -9999;
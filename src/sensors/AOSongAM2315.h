@@ -67,6 +67,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <Adafruit_AM2315.h>
 
 // Sensor Specific Defines
@@ -75,6 +76,8 @@
 
 /// @brief Sensor::_numReturnedValues; the AM2315 can report 2 values.
 #define AM2315_NUM_VARIABLES 2
+/// @brief The 7-bit I2C address of the AM2315 (0xB8 for writes).
+#define AM2315_I2C_ADDRESS 0x5C
 
 /**
  * @anchor sensor_am2315_timing
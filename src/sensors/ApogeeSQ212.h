@@ -12,7 +12,7 @@
  *
  * These are used for the Apogee SQ-212 quantum light sensor.
  *
- * This depends on the soligen2010 fork of the Adafruit ADS1015 library.
+ * The ADS1x15 is shared with any other analog sensors by the ADS1X15Manager.
  */
 /* clang-format off */
 /**
@@ -87,6 +87,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "sensors/ADS1X15Manager.h"
 
 // Sensor Specific Defines
 /** @ingroup sensor_sq212 */
@@ -213,7 +214,7 @@
  *
  * @ingroup sensor_sq212
  */
-class ApogeeSQ212 : public Sensor {
+class ApogeeSQ212 : public ADS1X15Sensor {
  public:
     /**
      * @brief Construct a new Apogee SQ-212 object - need the power pin and the
@@ -246,22 +247,10 @@ class ApogeeSQ212 : public Sensor {
      */
     ~ApogeeSQ212();
 
-    /**
-     * @brief Report the I1C address of the ADS and the channel that the SQ-212
-     * is attached to.
-     *
-     * @return **String** Text describing how the sensor is attached to the mcu.
-     */
-    String getSensorLocation(void) override;
-
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
-
- private:
-    uint8_t _adsChannel;
-    uint8_t _i2cAddress;
 };
 
 
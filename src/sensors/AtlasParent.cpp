@@ -24,6 +24,9 @@ AtlasParent::AtlasParent(SoftwareWire* theI2C, int8_t powerPin,
     _i2cAddressHex      = i2cAddressHex;
     _i2c                = theI2C;
     createdSoftwareWire = false;
+    _readingReady       = false;
+    _lastPoll           = 0;
+    _readingTime_ms     = 0;
 }
 AtlasParent::AtlasParent(int8_t powerPin, int8_t dataPin, int8_t clockPin,
                          uint8_t i2cAddressHex, uint8_t measurementsToAverage,
@@ -35,6 +38,9 @@ AtlasParent::AtlasParent(int8_t powerPin, int8_t dataPin, int8_t clockPin,
     _i2cAddressHex      = i2cAddressHex;
     _i2c                = new SoftwareWire(dataPin, clockPin);
     createdSoftwareWire = true;
+    _readingReady       = false;
+    _lastPoll           = 0;
+    _readingTime_ms     = 0;
 }
 #else
 AtlasParent::AtlasParent(TwoWire* theI2C, int8_t powerPin,
@@ -44,8 +50,11 @@ AtlasParent::AtlasParent(TwoWire* theI2C, int8_t powerPin,
                          uint32_t measurementTime_ms)
     : Sensor(sensorName, numReturnedVars, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, -1, measurementsToAverage) {
-    _i2cAddressHex = i2cAddressHex;
-    _i2c           = theI2C;
+    _i2cAddressHex  = i2cAddressHex;
+    _i2c            = theI2C;
+    _readingReady   = false;
+    _lastPoll       = 0;
+    _readingTime_ms = 0;
 }
 AtlasParent::AtlasParent(int8_t powerPin, uint8_t i2cAddressHex,
                          uint8_t measurementsToAverage, const char* sensorName,
@@ -54,8 +63,11 @@ AtlasParent::AtlasParent(int8_t powerPin, uint8_t i2cAddressHex,
                          uint32_t measurementTime_ms)
     : Sensor(sensorName, numReturnedVars, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, -1, measurementsToAverage) {
-    _i2cAddressHex = i2cAddressHex;
-    _i2c           = &Wire;
+    _i2cAddressHex  = i2cAddressHex;
+    _i2c            = &Wire;
+    _readingReady   = false;
+    _lastPoll       = 0;
+    _readingTime_ms = 0;
 }
 #endif
 
@@ -86,6 +98,10 @@ String      AtlasParent::getSensorLocation(void) {
 
 
 bool AtlasParent::setup(void) {
+#if !defined(MS_ATLAS_SOFTWAREWIRE)
+    // Start the hardware bus, unless it's already running
+    I2CBus::getBus(_i2c)->begin();
+#else
     _i2c->begin();  // Start the wire library (sensor power not required)
     // Eliminate any potential extra waits in the wire library
     // These waits would be caused by a readBytes or parseX being called
@@ -95,6 +111,7 @@ bool AtlasParent::setup(void) {
     // buffer.  In the case of the Wire library, that will never happen and
     // the timeout period is a useless delay.
     _i2c->setTimeout(0);
+#endif
     return Sensor::setup();  // this will set pin modes and the setup status bit
 }
 
@@ -111,11 +128,8 @@ bool AtlasParent::sleep(void) {
     bool success = true;
     MS_DBG(F("Putting"), getSensorNameAndLocation(), F("to sleep"));
 
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write((const uint8_t*)"Sleep",
-                           5);  // Write "Sleep" to put it in low power mode
-    success &= !_i2c->endTransmission();
-    // NOTE: The return of 0 from endTransmission indicates success
+    // Write "Sleep" to put it in low power mode
+    success &= sendCommand("Sleep");
 
     if (success) {
         // Unset the activation time
@@ -146,16 +160,14 @@ bool AtlasParent::startSingleMeasurement(void) {
     bool success = true;
     MS_DBG(F("Starting measurement on"), getSensorNameAndLocation());
 
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write('r');  // Write "R" to start a reading
-    int I2Cstatus = _i2c->endTransmission();
-    MS_DBG(F("I2Cstatus:"), I2Cstatus);
-    success &= !I2Cstatus;
-    // NOTE: The return of 0 from endTransmission indicates success
+    success &= sendCommand("r");  // Write "R" to start a reading
 
     if (success) {
         // Update the time that a measurement was requested
         _millisMeasurementRequested = millis();
+        // Any reading kept from before is now stale
+        _readingReady = false;
+        _lastPoll     = 0;
     } else {
         // Otherwise, make sure that the measurement start time and success bit
         // (bit 6) are unset
@@ -169,16 +181,68 @@ bool AtlasParent::startSingleMeasurement(void) {
 }
 
 
+// This checks the circuit for a finished reading instead of waiting out the
+// worst case measurement time
+bool AtlasParent::isMeasurementComplete(bool debug) {
+    // If the measurement didn't start, or is finished, there's nothing to do
+    if (!bitRead(_sensorStatus, 6) || _readingReady) return true;
+
+    uint32_t elapsed = millis() - _millisMeasurementRequested;
+    // Once the full measurement time has passed the result is read anyway
+    if (elapsed > _measurementTime_ms) {
+        return Sensor::isMeasurementComplete(debug);
+    }
+
+    // Don't start checking until most of the time the last reading took has
+    // passed, and then don't check too often
+    if (elapsed < _readingTime_ms - _readingTime_ms / 8) return false;
+    if (_lastPoll != 0 && millis() - _lastPoll < MS_ATLAS_POLL_INTERVAL_MS) {
+        return false;
+    }
+    _lastPoll = millis();
+
+    if (readReading() == 1) {
+        _readingTime_ms = elapsed;
+        if (debug) {
+            MS_DBG(getSensorNameAndLocation(), F("finished its reading in"),
+                   elapsed, F("ms"));
+        }
+        return true;
+    }
+    return false;
+}
+
+
+// This reads the response to a reading and keeps the values if there are any
+uint8_t AtlasParent::readReading(void) {
+    // call the circuit and request 40 bytes (this may be more than we need)
+    requestResponse(ATLAS_RESPONSE_SIZE);
+    // the first byte is the response code, we read this separately.
+    uint8_t code = _i2c->read();
+
+    // If the response code is successful, parse the remaining results
+    if (code == 1) {
+        for (uint8_t i = 0; i < _numReturnedValues; i++) {
+            float result = _i2c->parseFloat();
+            if (isnan(result)) result = -9999;
+            if (result < -1020) result = -9999;
+            _readingValues[i] = result;
+        }
+        _readingReady = true;
+    }
+    return code;
+}
+
+
 bool AtlasParent::addSingleMeasurementResult(void) {
     bool success = false;
 
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
     if (bitRead(_sensorStatus, 6)) {
-        // call the circuit and request 40 bytes (this may be more than we need)
-        _i2c->requestFrom((int)_i2cAddressHex, 40, 1);
-        // the first byte is the response code, we read this separately.
-        uint8_t code = _i2c->read();
+        // Ask for the reading unless it was already picked up while checking
+        // whether the measurement was complete
+        uint8_t code = _readingReady ? 1 : readReading();
 
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
         // Parse the response code
@@ -200,16 +264,14 @@ bool AtlasParent::addSingleMeasurementResult(void) {
                 MS_DBG(F("  No Data"));
                 break;
         }
-        // If the response code is successful, parse the remaining results
+        // If the response code is successful, add the kept results
         if (success) {
             for (uint8_t i = 0; i < _numReturnedValues; i++) {
-                float result = _i2c->parseFloat();
-                if (isnan(result)) result = -9999;
-                if (result < -1020) result = -9999;
-                MS_DBG(F("  Result #"), i, ':', result);
-                verifyAndAddMeasurementResult(i, result);
+                MS_DBG(F("  Result #"), i, ':', _readingValues[i]);
+                verifyAndAddMeasurementResult(i, _readingValues[i]);
             }
         }
+        _readingReady = false;
     } else {
         // If there's no measurement, need to make sure we send over all
         // of the "failed" result values
@@ -237,9 +299,41 @@ bool AtlasParent::waitForProcessing(uint32_t timeout) {
     bool     processed = false;
     uint32_t start     = millis();
     while (!processed && millis() - start < timeout) {
-        _i2c->requestFrom((int)_i2cAddressHex, 1, 1);
+        requestResponse(1);
         uint8_t code = _i2c->read();
         if (code == 1) processed = true;
     }
     return processed;
 }
+
+
+// With hardware I2C each command and request is a transaction on the bus
+bool AtlasParent::sendCommand(const char* command) {
+#if !defined(MS_ATLAS_SOFTWAREWIRE)
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->beginTransaction(_i2cAddressHex);
+#endif
+    _i2c->beginTransmission(_i2cAddressHex);
+    bool success = _i2c->write((const uint8_t*)command, strlen(command));
+    int  status  = _i2c->endTransmission();
+    // NOTE: The return of 0 from endTransmission indicates success
+    MS_DBG(F("I2Cstatus:"), status);
+    success &= status == 0;
+#if !defined(MS_ATLAS_SOFTWAREWIRE)
+    bus->endTransaction(status == 0);
+#endif
+    return success;
+}
+
+
+uint8_t AtlasParent::requestResponse(uint8_t length) {
+#if !defined(MS_ATLAS_SOFTWAREWIRE)
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->beginTransaction(_i2cAddressHex);
+#endif
+    uint8_t received = _i2c->requestFrom((int)_i2cAddressHex, (int)length, 1);
+#if !defined(MS_ATLAS_SOFTWAREWIRE)
+    bus->endTransaction(received > 0);
+#endif
+    return received;
+}
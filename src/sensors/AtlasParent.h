@@ -71,6 +71,8 @@
  *
  * - `-D MS_ATLAS_SOFTWAREWIRE`
  *      - switches from using hardware I2C to software I2C
+ * - `-D MS_ATLAS_POLL_INTERVAL_MS=x`
+ *      - the time between checks of a circuit for a finished reading
  *
  * @warning Either all or none of the Atlas sensors can be using software I2C.
  * Using some Altas sensors with software I2C and others with hardware I2C is
@@ -100,12 +102,34 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <Wire.h>
 
 #if defined MS_ATLAS_SOFTWAREWIRE | defined DOXYGEN
 #include <SoftwareWire.h>  // Testato's SoftwareWire
 #endif
 
+/** @ingroup atlas_group */
+/**@{*/
+
+#ifndef MS_ATLAS_POLL_INTERVAL_MS
+/**
+ * @brief The time between checks of an Atlas circuit for a finished reading,
+ * in milliseconds.
+ *
+ * Each check reads the whole response from the circuit, so this shouldn't be
+ * much shorter than the time that takes.
+ */
+#define MS_ATLAS_POLL_INTERVAL_MS 25
+#endif
+
+/**
+ * @brief The number of bytes to request from an Atlas circuit for a reading;
+ * this is more than the response code and the longest reading.
+ */
+#define ATLAS_RESPONSE_SIZE 40
+/**@}*/
+
 /**
  * @brief A parent class for Atlas EZO circuits and sensors
  *
@@ -294,6 +318,23 @@ class AtlasParent : public Sensor {
      * successfully.
      */
     bool startSingleMeasurement(void) override;
+    /**
+     * @brief Check whether the circuit has finished its reading.
+     *
+     * The fixed measurement time for each circuit is the worst case from its
+     * datasheet.  Instead of always waiting that out, this asks the circuit
+     * for its reading every #MS_ATLAS_POLL_INTERVAL_MS, starting a little
+     * before the time the last reading actually took.  As soon as the circuit
+     * answers with a success code the values are kept and the measurement is
+     * complete.  If it hasn't answered by the fixed measurement time, the
+     * measurement is complete anyway and addSingleMeasurementResult() asks one
+     * last time.
+     *
+     * @param debug True to output the result to the debugging Serial
+     * @return **bool** True if the reading is finished or the measurement time
+     * has passed.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -339,6 +380,60 @@ class AtlasParent : public Sensor {
      * within the wait period.
      */
     bool waitForProcessing(uint32_t timeout = 1000L);
+
+    /**
+     * @brief Send a command to the circuit.
+     *
+     * With hardware I2C the command is sent as a transaction on the circuit's
+     * I2CBus, so it's counted in the bus statistics.
+     *
+     * @param command The text of the command
+     * @return **bool** True if the circuit acknowledged the command.
+     */
+    bool sendCommand(const char* command);
+    /**
+     * @brief Ask the circuit for a response.
+     *
+     * With hardware I2C the request is a transaction on the circuit's I2CBus.
+     *
+     * @param length The number of bytes to ask for
+     * @return **uint8_t** The number of bytes received; 0 if the circuit
+     * didn't answer.
+     */
+    uint8_t requestResponse(uint8_t length);
+
+    /**
+     * @brief Ask the circuit for its reading and keep the values if it has
+     * one.
+     *
+     * Reading the response "consumes" it, so the values are kept in
+     * #_readingValues until they're added to the sensor results.
+     *
+     * @return **uint8_t** The response code from the circuit: 1 for success,
+     * 2 for a failure, 254 if the reading is still pending, or 255 if there is
+     * no data.
+     */
+    uint8_t readReading(void);
+
+    /**
+     * @brief The values of a finished reading, waiting to be added to the
+     * sensor results.
+     */
+    float _readingValues[MAX_NUMBER_VARS];
+    /**
+     * @brief True if #_readingValues holds a finished reading.
+     */
+    bool _readingReady;
+    /**
+     * @brief The millis() of the last check for a finished reading.
+     */
+    uint32_t _lastPoll;
+    /**
+     * @brief The time the last finished reading took, in milliseconds; used
+     * to decide when to start checking for the next one.  0 until a reading
+     * has been seen to finish.
+     */
+    uint32_t _readingTime_ms;
 };
 
 #endif  // SRC_SENSORS_ATLASPARENT_H_
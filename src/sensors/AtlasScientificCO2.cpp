@@ -60,10 +60,7 @@ bool AtlasScientificCO2::setup() {
 
     MS_DBG(F("Asking"), getSensorNameAndLocation(),
            F("to report temperature with CO2"));
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write((const uint8_t*)"O,t,1", 5);  // Enable temperature
-    success &= !_i2c->endTransmission();
-    // NOTE: The return of 0 from endTransmission indicates success
+    success &= sendCommand("O,t,1");  // Enable temperature
     success &= waitForProcessing();
 
     if (!success) {
@@ -60,31 +60,21 @@ bool AtlasScientificEC::setup() {
 
     MS_DBG(F("Asking"), getSensorNameAndLocation(),
            F("to report conductivity"));
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write((const uint8_t*)"O,EC,1", 6);  // Enable conductivity
-    success &= !_i2c->endTransmission();
+    success &= sendCommand("O,EC,1");  // Enable conductivity
     success &= waitForProcessing();
 
     MS_DBG(F("Asking"), getSensorNameAndLocation(),
            F("to report total dissolved solids"));
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write((const uint8_t*)"O,TDS,1",
-                           7);  // Enable total dissolved solids
-    success &= !_i2c->endTransmission();
+    success &= sendCommand("O,TDS,1");  // Enable total dissolved solids
     success &= waitForProcessing();
 
     MS_DBG(F("Asking"), getSensorNameAndLocation(), F("to report salinity"));
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write((const uint8_t*)"O,S,1", 5);  // Enable salinity
-    success &= !_i2c->endTransmission();
+    success &= sendCommand("O,S,1");  // Enable salinity
     success &= waitForProcessing();
 
     MS_DBG(F("Asking"), getSensorNameAndLocation(),
            F("to report specific gravity"));
-    _i2c->beginTransmission(_i2cAddressHex);
-    success &= _i2c->write((const uint8_t*)"O,SG,1",
-                           6);  // Enable specific gravity
-    success &= !_i2c->endTransmission();
+    success &= sendCommand("O,SG,1");  // Enable specific gravity
     success &= waitForProcessing();
 
     if (!success) {
@@ -127,6 +127,8 @@ bool BoschBME280::addSingleMeasurementResult(void) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         // Read values
+        I2CBus* bus = I2CBus::getBus(_i2c);
+        bus->beginTransaction(_i2cAddressHex);
         temp = bme_internal.readTemperature();
         if (isnan(temp)) temp = -9999;
         humid = bme_internal.readHumidity();
@@ -135,6 +137,9 @@ bool BoschBME280::addSingleMeasurementResult(void) {
         if (isnan(press)) press = -9999;
         alt = bme_internal.readAltitude(SEALEVELPRESSURE_HPA);
         if (isnan(alt)) alt = -9999;
+        // The library doesn't report a failure to answer; all 0's can also
+        // come from a bad response, so it isn't counted as a NACK
+        bus->endTransaction();
 
         // Assume that if all three are 0, really a failed response
         // May also return a very negative temp when receiving a bad response
@@ -92,6 +92,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <Adafruit_BME280.h>
 
 // Sensor Specific Defines
@@ -9,7 +9,7 @@
  *
  * These are used for the Campbell Scientific OBS-3+.
  *
- * This depends on the soligen2010 fork of the Adafruit ADS1015 library.
+ * The ADS1x15 is shared with any other analog sensors by the ADS1X15Manager.
  */
 /* clang-format off */
 /**
@@ -80,6 +80,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "sensors/ADS1X15Manager.h"
 
 // Sensor Specific Defines
 /** @ingroup sensor_obs3 */
@@ -217,7 +218,7 @@
  * @ingroup sensor_obs3
  */
 /* clang-format on */
-class CampbellOBS3 : public Sensor {
+class CampbellOBS3 : public ADS1X15Sensor {
  public:
     // The constructor - need the power pin, the ADS1X15 data channel, and the
     // calibration info
@@ -255,20 +256,13 @@ class CampbellOBS3 : public Sensor {
      */
     ~CampbellOBS3();
 
-    /**
-     * @copydoc Sensor::getSensorLocation()
-     */
-    String getSensorLocation(void) override;
-
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
-    uint8_t _adsChannel;
     float   _x2_coeff_A, _x1_coeff_B, _x0_coeff_C;
-    uint8_t _i2cAddress;
 };
 
 
@@ -36,23 +36,18 @@ bool Decagon5TM::addSingleMeasurementResult(void) {
         _SDI12Internal.clearBuffer();
 
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
-        String getDataCommand = "";
-        getDataCommand += _SDI12address;
-        // SDI-12 command to get data [address][D][dataOption][!]
-        getDataCommand += "D0!";
-        _SDI12Internal.sendCommand(getDataCommand);
-        delay(30);  // It just needs this little delay
-        MS_DBG(F("    >>>"), getDataCommand);
-
-        uint32_t start = millis();
-        while (_SDI12Internal.available() < 3 && (millis() - start) < 1500) {}
-        MS_DBG(F("  Receiving results from"), getSensorNameAndLocation());
-        _SDI12Internal.read();  // ignore the repeated SDI12 address
+        // Ask for the data; the response has the format
+        // [address][ea][temp]<CR><LF>, with any CRC checked and removed
+        char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+        uint8_t length = requestDataBlock(0, sdiResponse,
+                                          sizeof(sdiResponse));
+        // skip the repeated SDI12 address
+        const char* next = length > 0 ? sdiResponse + 1 : sdiResponse;
         // First variable returned is the Dialectric E
-        ea = _SDI12Internal.parseFloat();
+        if (!parseValue(next, ea)) ea = -9999;
         if (ea < 0 || ea > 350) ea = -9999;
         // Second variable returned is the temperature in °C
-        temp = _SDI12Internal.parseFloat();
+        if (!parseValue(next, temp)) temp = -9999;
         if (temp < -50 || temp > 60) temp = -9999;  // Range is - 40°C to + 50°C
         // the "third" variable of VWC is actually calculated, not returned by
         // the sensor!
@@ -78,7 +73,7 @@ bool Decagon5TM::addSingleMeasurementResult(void) {
         MS_DBG(F("  Temperature:"), temp);
         MS_DBG(F("  Volumetric Water Content:"), VWC);
 
-        success = true;
+        success = length > 0;
     } else {
         MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
     }
@@ -14,7 +14,7 @@
  * is a multiplier allowed for a voltage divider between the raw voltage and the
  * ADS.
  *
- * This depends on the soligen2010 fork of the Adafruit ADS1015 library.
+ * The ADS1x15 is shared with any other analog sensors by the ADS1X15Manager.
  */
 /* clang-format off */
 /**
@@ -50,12 +50,11 @@
  * @note ModularSensors only supports connecting the ADS1x15 to primary hardware I2C instance.
  * Connecting the ADS to a secondary hardware or software I2C instance is *not* supported!
  *
- * Communication with the ADS1x15 depends on the
- * [soligen2010 fork of the Adafruit ADS1015 library](https://github.com/soligen2010/Adafruit_ADS1X15).
- *
- * @note We do *not* use the Adafruit library! The soligen2010 fork corrects some errors
- * in the Adafruit library.  Until those corrections are pulled into the main library, we
- * use the fork instead.
+ * Communication with the ADS1x15 is handled by the ADS1X15Manager.  All of the sensors
+ * on one ADS1x15 share a single manager, which queues their conversions and runs them
+ * back to back.  A conversion is started when a sensor starts a measurement and is
+ * usually finished by the time the result is collected, so no sensor has to set up the
+ * ADC or sit through its conversion time on its own.
  *
  * @section analog_ads1x15_specs Specifications
  * @note *In all cases, we assume that the ADS1x15 is powered at 3.3V and set the ADC's internal gain to 1x.
@@ -151,6 +150,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "sensors/ADS1X15Manager.h"
 
 // Sensor Specific Defines
 /** @ingroup sensor_ads1x15 */
@@ -177,8 +177,8 @@
 #define EXT_VOLTAGE_STABILIZATION_TIME_MS 0
 /**
  * @brief Sensor::_measurementTime_ms; the ADS1115 completes 860 conversions per
- * second, but the wait for the conversion to complete is built into the
- * underlying library, so we do not need to wait further here.
+ * second, but the wait for the conversion to complete is handled by the
+ * ADS1X15Manager, so we do not need to wait further here.
  */
 #define EXT_VOLTAGE_MEASUREMENT_TIME_MS 0
 /**@}*/
@@ -242,7 +242,7 @@
  * @ingroup sensor_ads1x15
  */
 /* clang-format on */
-class ExternalVoltage : public Sensor {
+class ExternalVoltage : public ADS1X15Sensor {
  public:
     /**
      * @brief Construct a new External Voltage object - need the power pin and
@@ -273,20 +273,13 @@ class ExternalVoltage : public Sensor {
      */
     ~ExternalVoltage();
 
-    /**
-     * @copydoc Sensor::getSensorLocation()
-     */
-    String getSensorLocation(void) override;
-
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
-    uint8_t _adsChannel;
-    float   _gain;
-    uint8_t _i2cAddress;
+    float _gain;
 };
 
 
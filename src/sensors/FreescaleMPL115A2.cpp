@@ -68,7 +68,11 @@ bool MPL115A2::addSingleMeasurementResult(void) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         // Read values
+        I2CBus* bus = I2CBus::getBus(_i2c);
+        bus->beginTransaction(MPL115A2_I2C_ADDRESS);
         mpl115a2_internal.getPT(&press, &temp);
+        // The library doesn't report a failure to answer
+        bus->endTransaction();
 
         if (isnan(temp)) temp = -9999;
         if (isnan(press)) press = -9999;
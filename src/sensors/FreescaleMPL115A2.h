@@ -74,6 +74,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <Adafruit_MPL115A2.h>
 
 // Sensor Specific Defines
@@ -82,6 +83,8 @@
 
 /// @brief Sensor::_numReturnedValues; the MPL115A2 can report 2 values.
 #define MPL115A2_NUM_VARIABLES 2
+/// @brief The I2C address of the MPL115A2, which can't be changed.
+#define MPL115A2_I2C_ADDRESS 0x60
 
 /**
  * @anchor sensor_mpl115a2_timing
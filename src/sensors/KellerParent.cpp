@@ -22,7 +22,8 @@ KellerParent::KellerParent(byte modbusAddress, Stream* stream, int8_t powerPin,
     : Sensor(sensName, numVariables, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, -1, measurementsToAverage),
       _ksensor(), _model(model), _modbusAddress(modbusAddress), _stream(stream),
-      _RS485EnablePin(enablePin), _powerPin2(powerPin2) {}
+      _RS485EnablePin(enablePin), _powerPin2(powerPin2),
+      _modbusBus(ModbusBus::getBus(stream)) {}
 KellerParent::KellerParent(byte modbusAddress, Stream& stream, int8_t powerPin,
                            int8_t powerPin2, int8_t enablePin,
                            uint8_t measurementsToAverage, kellerModel model,
@@ -33,7 +34,8 @@ KellerParent::KellerParent(byte modbusAddress, Stream& stream, int8_t powerPin,
     : Sensor(sensName, numVariables, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, -1, measurementsToAverage),
       _ksensor(), _model(model), _modbusAddress(modbusAddress),
-      _stream(&stream), _RS485EnablePin(enablePin), _powerPin2(powerPin2) {}
+      _stream(&stream), _RS485EnablePin(enablePin), _powerPin2(powerPin2),
+      _modbusBus(ModbusBus::getBus(&stream)) {}
 // Destructor
 KellerParent::~KellerParent() {}
 
@@ -134,7 +136,9 @@ bool KellerParent::addSingleMeasurementResult(void) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         // Get Values
-        success     = _ksensor.getValues(waterPressureBar, waterTempertureC);
+        _modbusBus->beginTransaction();
+        success = _ksensor.getValues(waterPressureBar, waterTempertureC);
+        _modbusBus->endTransaction(success);
         waterDepthM = _ksensor.calcWaterDepthM(
             waterPressureBar,
             waterTempertureC);  // float calcWaterDepthM(float waterPressureBar,
@@ -41,6 +41,12 @@
  * Sensors ship with default slave addresses set to 0x01, which can be set by
  * the user.
  *
+ * All of the Modbus sensors on the same stream share a ModbusBus, which keeps
+ * the quiet time between their frames and counts how many requests succeed or
+ * fail, and how long they take.  Modbus RTU only allows one request on the
+ * line at a time, so the requests still go out one after another; the bus
+ * doesn't queue them.
+ *
  * The Keller sensors expect an input voltage of 9-28 VDC, so they also require
  * a voltage booster and an RS485 to TTL Serial converter with logic level
  * shifting from the higher output voltage to the 3.3V or 5V of the Arduino data
@@ -96,6 +102,7 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "sensors/ModbusBus.h"
 #include <KellerModbus.h>
 
 // Sensor Specific Defines
@@ -253,6 +260,7 @@ class KellerParent : public Sensor {
     Stream*     _stream;
     int8_t      _RS485EnablePin;
     int8_t      _powerPin2;
+    ModbusBus*  _modbusBus;
 };
 /**@}*/
 #endif  // SRC_SENSORS_KELLERPARENT_H_
@@ -10,24 +10,53 @@
 #include "MaxBotixSonar.h"
 
 
+// The list of sonars
+MaxBotixSonar* MaxBotixSonar::_firstSonar = NULL;
+
+
 MaxBotixSonar::MaxBotixSonar(Stream* stream, int8_t powerPin, int8_t triggerPin,
                              uint8_t measurementsToAverage)
     : Sensor("MaxBotixMaxSonar", HRXL_NUM_VARIABLES, HRXL_WARM_UP_TIME_MS,
              HRXL_STABILIZATION_TIME_MS, HRXL_MEASUREMENT_TIME_MS, powerPin, -1,
              measurementsToAverage) {
-    _triggerPin = triggerPin;
-    _stream     = stream;
+    _triggerPin     = triggerPin;
+    _stream         = stream;
+    _rangeWindow_ms = HRXL_MEASUREMENT_TIME_MS;
+    _numRanges      = 0;
+    _frameValue     = 0;
+    _frameDigits    = -1;
+    _awaitingReply  = false;
+    _lastTrigger    = 0;
+    _nextSonar      = _firstSonar;
+    _firstSonar     = this;
 }
 MaxBotixSonar::MaxBotixSonar(Stream& stream, int8_t powerPin, int8_t triggerPin,
                              uint8_t measurementsToAverage)
     : Sensor("MaxBotixMaxSonar", HRXL_NUM_VARIABLES, HRXL_WARM_UP_TIME_MS,
              HRXL_STABILIZATION_TIME_MS, HRXL_MEASUREMENT_TIME_MS, powerPin, -1,
              measurementsToAverage) {
-    _triggerPin = triggerPin;
-    _stream     = &stream;
+    _triggerPin     = triggerPin;
+    _stream         = &stream;
+    _rangeWindow_ms = HRXL_MEASUREMENT_TIME_MS;
+    _numRanges      = 0;
+    _frameValue     = 0;
+    _frameDigits    = -1;
+    _awaitingReply  = false;
+    _lastTrigger    = 0;
+    _nextSonar      = _firstSonar;
+    _firstSonar     = this;
+}
+// Destructor - take the sonar out of the list
+MaxBotixSonar::~MaxBotixSonar() {
+    MaxBotixSonar** link = &_firstSonar;
+    while (*link != NULL) {
+        if (*link == this) {
+            *link = _nextSonar;
+            break;
+        }
+        link = &(*link)->_nextSonar;
+    }
 }
-// Destructor
-MaxBotixSonar::~MaxBotixSonar() {}
 
 
 // unfortunately, we really cannot know where the stream is attached.
@@ -45,15 +74,11 @@ bool MaxBotixSonar::setup(void) {
         digitalWrite(_triggerPin, LOW);
     }
 
-    // Set the stream timeout;
-    // Even the slowest sensors should respond at a rate of 6Hz (166ms).
-    _stream->setTimeout(180);
-
     return Sensor::setup();  // this will set pin modes and the setup status bit
 }
 
 
-// Parsing and tossing the header lines in the wake-up
+// Dumping the header lines in the wake-up
 bool MaxBotixSonar::wake(void) {
     // Sensor::wake() checks if the power pin is on and sets the wake timestamp
     // and status bits.  If it returns false, there's no reason to go on.
@@ -63,35 +88,88 @@ bool MaxBotixSonar::wake(void) {
     // lines of header to the serial port, beginning at ~65ms and finising at
     // ~160ms. Although we are waiting for them to complete in the
     // "waitForWarmUp" function, the values will still be in the serial buffer
-    // and need to be read to be cleared out For an HRXL without temperature
+    // and need to be cleared out. For an HRXL without temperature
     // compensation, the headers are: HRXL-MaxSonar-WRL PN:MB7386 Copyright
     // 2011-2013 MaxBotix Inc. RoHS 1.8b090  0713 TempI
+    // None of the header lines has an 'R' followed by digits and a carriage
+    // return, so anything that comes in later is skipped by the parser.
 
     // NOTE ALSO:  Depending on what type of serial stream you are using, there
     // may also be a bunch of junk in the buffer that this will clear out.
     MS_DBG(F("Dumping Header Lines from MaxBotix on"), getSensorLocation());
-    for (int i = 0; i < 6; i++) {
-        String headerLine = _stream->readStringUntil('\r');
-        MS_DBG(i, '-', headerLine);
+    dumpBuffer();
+    _awaitingReply = false;
+
+    return true;
+}
+
+
+void MaxBotixSonar::setRangeWindow(uint32_t windowTime_ms) {
+    _rangeWindow_ms = windowTime_ms;
+}
+
+
+bool MaxBotixSonar::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+
+    _numRanges     = 0;
+    _awaitingReply = false;
+    if (_triggerPin >= 0) {
+        // Another sonar on the stream may be waiting for its reply, so only
+        // trigger now if the stream is free; otherwise the trigger is left to
+        // isMeasurementComplete()
+        if (!streamInUse()) trigger();
+    } else {
+        // Only ranges sent from now on count
+        dumpBuffer();
     }
-    // Clear anything else out of the stream buffer
-    uint8_t junkChars = _stream->available();
-    if (junkChars) {
-        MS_DBG(F("Dumping"), junkChars,
-               F("characters from MaxBotix stream buffer"));
-        for (uint8_t i = 0; i < junkChars; i++) {
-#ifdef MS_MAXBOTIXSONAR_DEBUG
-            DEBUGGING_SERIAL_OUTPUT.print(_stream->read());
-#else
-            _stream->read();
-#endif
+    return true;
+}
+
+
+bool MaxBotixSonar::isMeasurementComplete(bool debug) {
+    // If the measurement didn't start there's nothing to do
+    if (!bitRead(_sensorStatus, 6)) return true;
+
+    uint32_t elapsed = millis() - _millisMeasurementRequested;
+
+    if (_triggerPin >= 0) {
+        if (_awaitingReply) {
+            uint8_t frames = readRanges();
+            if (_numRanges > 0) {
+                _awaitingReply = false;
+                if (debug) {
+                    MS_DBG(getSensorNameAndLocation(), F("got a good range in"),
+                           elapsed, F("ms"));
+                }
+                return true;
+            }
+            // Trigger again after a bad range or no reply
+            if (frames > 0 ||
+                millis() - _lastTrigger > HRXL_TRIGGER_TIMEOUT_MS) {
+                _awaitingReply = false;
+            }
         }
-#ifdef MS_MAXBOTIXSONAR_DEBUG
-        DEBUGGING_SERIAL_OUTPUT.println();
-#endif
+        if (elapsed > MS_MAXBOTIX_MAX_WAIT_MS) {
+            _awaitingReply = false;
+            return true;
+        }
+        if (!_awaitingReply && !streamInUse()) trigger();
+        return false;
     }
 
-    return true;
+    readRanges();
+    if (elapsed > _rangeWindow_ms && _numRanges > 0) {
+        if (debug) {
+            MS_DBG(getSensorNameAndLocation(), F("got"), _numRanges,
+                   F("good ranges in"), elapsed, F("ms"));
+        }
+        return true;
+    }
+    return elapsed > MS_MAXBOTIX_MAX_WAIT_MS;
 }
 
 
@@ -100,67 +178,36 @@ bool MaxBotixSonar::addSingleMeasurementResult(void) {
     bool    success = false;
     int16_t result  = -9999;
 
-    // Clear anything out of the stream buffer
-    uint8_t junkChars = _stream->available();
-    if (junkChars) {
-        MS_DBG(F("Dumping"), junkChars,
-               F("characters from MaxBotix stream buffer:"));
-        for (uint8_t i = 0; i < junkChars; i++) {
-#ifdef MS_MAXBOTIXSONAR_DEBUG
-            DEBUGGING_SERIAL_OUTPUT.print(_stream->read());
-#else
-            _stream->read();
-#endif
-        }
-#ifdef MS_MAXBOTIXSONAR_DEBUG
-        DEBUGGING_SERIAL_OUTPUT.println();
-#endif
-    }
-
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
     if (bitRead(_sensorStatus, 6)) {
-        MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
-
-        uint8_t rangeAttempts = 0;
-        while (success == false && rangeAttempts < 25) {
-            // If the sonar is running on a trigger, activating the trigger
-            // should in theory happen within the startSingleMeasurement
-            // function.  Because we're really taking up to 25 measurements
-            // for each "single measurement" until a valid value is returned
-            // and the measurement time is <166ms, we'll actually activate
-            // the trigger here.
-            if (_triggerPin >= 0) {
-                MS_DBG(F("  Triggering Sonar with"), _triggerPin);
-                digitalWrite(_triggerPin, HIGH);
-                delayMicroseconds(30);  // Trigger must be held high for >20 µs
-                digitalWrite(_triggerPin, LOW);
-            }
-
-            // Immediately ask for a result and let the stream timeout be our
-            // "wait" for the measurement.
-            result = _stream->parseInt();
-            _stream->read();  // To throw away the carriage return
-            MS_DBG(F("  Sonar Range:"), result);
-            rangeAttempts++;
+        // Pick up anything sent since the last check; a triggered sonar's
+        // stream may only be read while it's waiting for its reply
+        if (_triggerPin < 0 || _awaitingReply) readRanges();
+        _awaitingReply = false;
 
-            // If it cannot obtain a result , the sonar is supposed to send a
-            // value just above it's max range.  For 10m models, this is 9999,
-            // for 5m models it's 4999.  The sonar might also send readings of
-            // 300 or 500 (the blanking distance) if there are too many acoustic
-            // echos. If the result becomes garbled or the sonar is
-            // disconnected, the parseInt function returns 0.  Luckily, these
-            // sensors are not capable of reading 0, so we also know the 0 value
-            // is bad.
-            if (result <= 300 || result == 500 || result == 4999 ||
-                result == 9999 || result == 0) {
-                MS_DBG(F("  Bad or Suspicious Result, Retry Attempt #"),
-                       rangeAttempts);
-                result = -9999;
+        if (_numRanges > 0) {
+            // Sort the ranges to find the median
+            for (uint8_t i = 1; i < _numRanges; i++) {
+                int16_t range = _ranges[i];
+                int8_t  j     = i - 1;
+                while (j >= 0 && _ranges[j] > range) {
+                    _ranges[j + 1] = _ranges[j];
+                    j--;
+                }
+                _ranges[j + 1] = range;
+            }
+            uint8_t middle = _numRanges / 2;
+            if (_numRanges % 2) {
+                result = _ranges[middle];
             } else {
-                MS_DBG(F("  Good result found"));
-                success = true;
+                result = (_ranges[middle - 1] + _ranges[middle]) / 2;
             }
+            MS_DBG(getSensorNameAndLocation(), F("median of"), _numRanges,
+                   F("ranges:"), result);
+            success = true;
+        } else {
+            MS_DBG(getSensorNameAndLocation(), F("sent no good ranges"));
         }
     } else {
         MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
@@ -176,3 +223,86 @@ bool MaxBotixSonar::addSingleMeasurementResult(void) {
     // Return values shows if we got a not-obviously-bad reading
     return success;
 }
+
+
+uint8_t MaxBotixSonar::readRanges(void) {
+    uint8_t frames = 0;
+    while (_stream->available()) {
+        int c = _stream->read();
+        if (c == 'R') {
+            // The start of a new frame
+            _frameValue  = 0;
+            _frameDigits = 0;
+        } else if (_frameDigits >= 0 && _frameDigits < 4 && c >= '0' &&
+                   c <= '9') {
+            _frameValue = _frameValue * 10 + (c - '0');
+            _frameDigits++;
+        } else if (_frameDigits >= 3 && c == '\r') {
+            frames++;
+            int16_t range = _frameValue;
+            MS_DBG(F("  Sonar Range:"), range);
+            // If it cannot obtain a result , the sonar is supposed to send a
+            // value just above it's max range.  For 10m models, this is 9999,
+            // for 5m models it's 4999.  The sonar might also send readings of
+            // 300 or 500 (the blanking distance) if there are too many acoustic
+            // echos.  These sensors are not capable of reading 0, so we also
+            // know a 0 value is bad.
+            if (range <= 300 || range == 500 || range == 4999 ||
+                range == 9999) {
+                MS_DBG(F("  Bad or Suspicious Result"));
+            } else if (_numRanges < MS_MAXBOTIX_MAX_RANGES) {
+                _ranges[_numRanges++] = range;
+            }
+            _frameDigits = -1;
+        } else {
+            // Anything else isn't part of a range
+            _frameDigits = -1;
+        }
+    }
+    return frames;
+}
+
+
+void MaxBotixSonar::dumpBuffer(void) {
+    uint8_t junkChars = _stream->available();
+    if (junkChars) {
+        MS_DBG(F("Dumping"), junkChars,
+               F("characters from MaxBotix stream buffer:"));
+        for (uint8_t i = 0; i < junkChars; i++) {
+#ifdef MS_MAXBOTIXSONAR_DEBUG
+            DEBUGGING_SERIAL_OUTPUT.print(_stream->read());
+#else
+            _stream->read();
+#endif
+        }
+#ifdef MS_MAXBOTIXSONAR_DEBUG
+        DEBUGGING_SERIAL_OUTPUT.println();
+#endif
+    }
+    _frameDigits = -1;
+}
+
+
+void MaxBotixSonar::trigger(void) {
+    // Anything already in the buffer isn't the reply to this trigger
+    dumpBuffer();
+    MS_DBG(F("  Triggering Sonar with"), _triggerPin);
+    digitalWrite(_triggerPin, HIGH);
+    delayMicroseconds(30);  // Trigger must be held high for >20 µs
+    digitalWrite(_triggerPin, LOW);
+    _awaitingReply = true;
+    _lastTrigger   = millis();
+}
+
+
+bool MaxBotixSonar::streamInUse(void) {
+    MaxBotixSonar* sonar = _firstSonar;
+    while (sonar != NULL) {
+        if (sonar != this && sonar->_stream == _stream &&
+            sonar->_awaitingReply) {
+            return true;
+        }
+        sonar = sonar->_nextSonar;
+    }
+    return false;
+}
@@ -55,6 +55,15 @@
  * effective.  In this case, you may save a very small amount of power by
  * setting up a trigger pin and manually trigger individual readings.
  *
+ * The ranges are read from the serial buffer as they come in, without waiting
+ * on the stream timeout.  In free-ranging mode every good range sent during
+ * the measurement window is kept and the median is reported, which rejects the
+ * odd stray echo.  The window is one read cycle (#HRXL_MEASUREMENT_TIME_MS) by
+ * default and can be lengthened with MaxBotixSonar::setRangeWindow().  With a
+ * trigger pin the sonar is triggered again after each bad range until a good
+ * one comes back.  In either mode the sensor gives up after
+ * #MS_MAXBOTIX_MAX_WAIT_MS without a good range.
+ *
  * Please see the section
  * "[Notes on Arduino Streams and Software Serial](https://envirodiy.github.io/ModularSensors/page_arduino_streams.html)"
  * for more information about what streams can be used along with this library.
@@ -133,8 +142,27 @@
 /// @brief Sensor::_measurementTime_ms; the HRXL takes 166ms to complete a
 /// measurement.
 #define HRXL_MEASUREMENT_TIME_MS 166
+/// @brief The time to wait for a reply after triggering the HRXL before
+/// triggering it again; a little more than one read cycle.
+#define HRXL_TRIGGER_TIMEOUT_MS 180
 /**@}*/
 
+#ifndef MS_MAXBOTIX_MAX_RANGES
+/**
+ * @brief The number of ranges kept from the measurement window of a
+ * free-ranging MaxBotix; any more are ignored.
+ */
+#define MS_MAXBOTIX_MAX_RANGES 16
+#endif
+
+#ifndef MS_MAXBOTIX_MAX_WAIT_MS
+/**
+ * @brief The longest time to wait for a good range from a MaxBotix before
+ * giving up on the measurement; about 25 read cycles.
+ */
+#define MS_MAXBOTIX_MAX_WAIT_MS 4200
+#endif
+
 /**
  * @anchor sensor_maxbotix_range
  * @name Range
@@ -209,9 +237,8 @@ class MaxBotixSonar : public Sensor {
      * @brief Do any one-time preparations needed before the sensor will be able
      * to take readings.
      *
-     * This sets pin mode on the trigger pin.  It also sets the expected stream
-     * timeout for modbus and updates the #_sensorStatus.  No sensor power is
-     * required.  This will always return true.
+     * This sets pin mode on the trigger pin and updates the #_sensorStatus.
+     * No sensor power is required.  This will always return true.
      *
      * @return **bool** True if the setup was successful.
      */
@@ -223,8 +250,8 @@ class MaxBotixSonar : public Sensor {
      * Verifies that the power is on and updates the #_sensorStatus.  This also
      * sets the #_millisSensorActivated timestamp.
      *
-     * For the MaxSonar, this also reads and dumps any returned "header" lines
-     * from the sensor.
+     * For the MaxSonar, this also dumps any "header" lines the sensor has
+     * already sent.  Any sent later are skipped by the range parser.
      *
      * @note This does NOT include any wait for sensor readiness.
      *
@@ -232,14 +259,114 @@ class MaxBotixSonar : public Sensor {
      */
     bool wake(void) override;
 
+    /**
+     * @brief Set the time a free-ranging sonar collects ranges for in each
+     * measurement.
+     *
+     * The median of the good ranges sent in the window is reported.  This has
+     * no effect on a triggered sonar, which reports the first good range.
+     *
+     * @param windowTime_ms The window in milliseconds; the default is
+     * #HRXL_MEASUREMENT_TIME_MS, about one range.
+     */
+    void setRangeWindow(uint32_t windowTime_ms);
+
+    /**
+     * @brief Tell the sensor to start a single measurement, if needed.
+     *
+     * This clears the ranges kept from any earlier measurement.  A
+     * free-ranging sonar also has any stale characters dumped from its
+     * stream, while a triggered sonar is triggered as soon as no other sonar
+     * on the same stream is waiting for a reply.
+     *
+     * @return **bool** True if the start measurement function completed
+     * successfully.
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @brief Check whether the measurement is finished.
+     *
+     * This parses any ranges waiting in the serial buffer.  A triggered sonar
+     * is finished as soon as it's sent a good range and is triggered again if
+     * it sends a bad one or nothing.  A free-ranging sonar is finished once
+     * its range window has passed and it's sent at least one good range.
+     * Either is finished after #MS_MAXBOTIX_MAX_WAIT_MS.
+     *
+     * @param debug True to output the result to the debugging Serial
+     * @return **bool** True indicates the measurement is finished.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
+    /**
+     * @brief Parse all of the characters waiting in the stream into ranges.
+     *
+     * Each range is sent as an 'R', three or four digits, and a carriage
+     * return.  Anything else resets the parser, so header lines and garbled
+     * frames are skipped.  Good ranges are added to #_ranges.
+     *
+     * @return **uint8_t** The number of frames, good or bad, parsed.
+     */
+    uint8_t readRanges(void);
+    /**
+     * @brief Dump everything from the stream buffer and reset the parser.
+     */
+    void dumpBuffer(void);
+    /**
+     * @brief Pulse the trigger pin to start a range.
+     */
+    void trigger(void);
+    /**
+     * @brief Check if another triggered sonar on the same stream is waiting
+     * for its reply.
+     *
+     * @return **bool** True if the stream is in use
+     */
+    bool streamInUse(void);
+
     int8_t  _triggerPin;
     Stream* _stream;
+    /**
+     * @brief The time a free-ranging sonar collects ranges for
+     */
+    uint32_t _rangeWindow_ms;
+    /**
+     * @brief The good ranges received in the current measurement
+     */
+    int16_t _ranges[MS_MAXBOTIX_MAX_RANGES];
+    /**
+     * @brief The number of good ranges received in the current measurement
+     */
+    uint8_t _numRanges;
+    /**
+     * @brief The digits of the frame being parsed
+     */
+    int16_t _frameValue;
+    /**
+     * @brief The number of digits of the frame being parsed, or -1 if the
+     * parser is waiting for the 'R' that starts a frame
+     */
+    int8_t _frameDigits;
+    /**
+     * @brief True if the sonar has been triggered and hasn't replied
+     */
+    bool _awaitingReply;
+    /**
+     * @brief The millis() of the last trigger
+     */
+    uint32_t _lastTrigger;
+    /**
+     * @brief The next sonar in the list of all sonars
+     */
+    MaxBotixSonar* _nextSonar;
+    /**
+     * @brief The first sonar in the list of all sonars
+     */
+    static MaxBotixSonar* _firstSonar;
 };
 
 
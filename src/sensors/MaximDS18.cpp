@@ -9,6 +9,145 @@
 
 #include "MaximDS18.h"
 
+// The list of busses
+DS18Bus* DS18Bus::_firstBus = NULL;
+
+// The constructor - the bus isn't searched until a sensor is set up
+DS18Bus::DS18Bus(int8_t dataPin) : _oneWire(dataPin), _dallasTemp(&_oneWire) {
+    _dataPin         = dataPin;
+    _numAddresses    = 0;
+    _numFound        = 0;
+    _conversionId    = 0;
+    _conversionStart = 0;
+    _nextBus         = NULL;
+}
+
+
+// This finds the bus on a pin or makes a new one
+DS18Bus* DS18Bus::getBus(int8_t dataPin) {
+    DS18Bus* bus = _firstBus;
+    while (bus != NULL) {
+        if (bus->_dataPin == dataPin) return bus;
+        bus = bus->_nextBus;
+    }
+    bus           = new DS18Bus(dataPin);
+    bus->_nextBus = _firstBus;
+    _firstBus     = bus;
+    return bus;
+}
+
+
+DallasTemperature& DS18Bus::getDallasTemp(void) {
+    return _dallasTemp;
+}
+
+
+// This searches the bus for all of the sensors on it, unless they've already
+// been found
+bool DS18Bus::begin(void) {
+    if (_numFound > 0) return true;
+
+    // NOTE: DallasTemperature::begin() also searches the bus, to count the
+    // devices and check for parasite power
+    _dallasTemp.begin();
+    // Tell the sensors that we do NOT want to wait for conversions to finish
+    // That is, we're in ASYNC mode and will get values when we're ready
+    _dallasTemp.setWaitForConversion(false);
+
+    search();
+    return _numFound > 0;
+}
+
+
+void DS18Bus::search(void) {
+    DeviceAddress address;
+    _numFound = 0;
+    _oneWire.reset_search();
+    while (_oneWire.search(address)) {
+        if (OneWire::crc8(address, 7) != address[7]) continue;
+        _numFound++;
+        if (findAddress(address) >= 0) continue;
+        if (_numAddresses >= MS_DS18_BUS_MAX_SENSORS) continue;
+        for (uint8_t i = 0; i < 8; i++) {
+            _addresses[_numAddresses][i] = address[i];
+        }
+        _claimed[_numAddresses] = false;
+        _numAddresses++;
+    }
+    MS_DBG(F("Found"), _numFound, F("OneWire devices on pin"), _dataPin);
+}
+
+
+int8_t DS18Bus::findAddress(DeviceAddress address) {
+    for (uint8_t n = 0; n < _numAddresses; n++) {
+        if (memcmp(_addresses[n], address, 8) == 0) return n;
+    }
+    return -1;
+}
+int8_t DS18Bus::findUnclaimed(void) {
+    for (uint8_t n = 0; n < _numAddresses; n++) {
+        if (!_claimed[n]) return n;
+    }
+    return -1;
+}
+
+
+// A sensor made with its address keeps it, whether or not the search has
+// found it yet
+void DS18Bus::reserveAddress(DeviceAddress address) {
+    int8_t slot = findAddress(address);
+    if (slot < 0) {
+        if (_numAddresses >= MS_DS18_BUS_MAX_SENSORS) return;
+        slot = _numAddresses++;
+        for (uint8_t i = 0; i < 8; i++) _addresses[slot][i] = address[i];
+    }
+    _claimed[slot] = true;
+}
+
+
+bool DS18Bus::claimAddress(DeviceAddress address) {
+    int8_t slot = findUnclaimed();
+    if (slot < 0) {
+        // Everything found is taken; the first search may have missed a
+        // sensor, or it may have been plugged in since
+        search();
+        slot = findUnclaimed();
+    }
+    if (slot < 0) return false;
+    for (uint8_t i = 0; i < 8; i++) address[i] = _addresses[slot][i];
+    _claimed[slot] = true;
+    return true;
+}
+
+
+// This starts a conversion on every sensor at once with a "skip ROM" and
+// "convert T", unless there's one running that the asking sensor can share
+uint16_t DS18Bus::startConversion(uint16_t lastJoined) {
+    if (_conversionStart != 0 && lastJoined != _conversionId &&
+        millis() - _conversionStart < DS18_MEASUREMENT_TIME_MS) {
+        MS_DBG(F("Sharing the conversion started on pin"), _dataPin,
+               millis() - _conversionStart, F("ms ago"));
+        return _conversionId;
+    }
+
+    // The reset returns true if any device answered with a presence pulse
+    if (!_oneWire.reset()) return 0;
+    _oneWire.skip();
+    // Sensors on parasite power need the line held high during the conversion
+    _oneWire.write(0x44, _dallasTemp.isParasitePowerMode() ? 1 : 0);
+
+    // Skip 0, which means no conversion
+    if (++_conversionId == 0) _conversionId = 1;
+    _conversionStart = millis();
+    MS_DBG(F("Started a conversion on all sensors on pin"), _dataPin);
+    return _conversionId;
+}
+
+
+uint32_t DS18Bus::getConversionStart(void) {
+    return _conversionStart;
+}
+
 
 // The constructor - if the hex address is known - also need the power pin and
 // the data pin
@@ -17,10 +156,14 @@ MaximDS18::MaximDS18(DeviceAddress OneWireAddress, int8_t powerPin,
     : Sensor("MaximDS18", DS18_NUM_VARIABLES, DS18_WARM_UP_TIME_MS,
              DS18_STABILIZATION_TIME_MS, DS18_MEASUREMENT_TIME_MS, powerPin,
              dataPin, measurementsToAverage),
-      _internalOneWire(dataPin), _internalDallasTemp(&_internalOneWire) {
+      _ds18Bus(DS18Bus::getBus(dataPin)),
+      _internalDallasTemp(_ds18Bus->getDallasTemp()), _conversionId(0) {
     for (uint8_t i = 0; i < 8; i++) _OneWireAddress[i] = OneWireAddress[i];
     // _OneWireAddress = OneWireAddress;
     _addressKnown = true;
+    // Keep sensors with unknown addresses from claiming this one, whichever
+    // is set up first
+    _ds18Bus->reserveAddress(_OneWireAddress);
 }
 // The constructor - if the hex address is NOT known - only need the power pin
 // and the data pin Can only use this if there is only a single sensor on the
@@ -30,7 +173,8 @@ MaximDS18::MaximDS18(int8_t powerPin, int8_t dataPin,
     : Sensor("MaximDS18", DS18_NUM_VARIABLES, DS18_WARM_UP_TIME_MS,
              DS18_STABILIZATION_TIME_MS, DS18_MEASUREMENT_TIME_MS, powerPin,
              dataPin, measurementsToAverage),
-      _internalOneWire(dataPin), _internalDallasTemp(&_internalOneWire) {
+      _ds18Bus(DS18Bus::getBus(dataPin)),
+      _internalDallasTemp(_ds18Bus->getDallasTemp()), _conversionId(0) {
     _addressKnown = false;
 }
 // Destructor
@@ -73,7 +217,8 @@ bool MaximDS18::setup(void) {
     if (!wasOn) { powerUp(); }
     waitForWarmUp();
 
-    _internalDallasTemp.begin();
+    // Search the bus, if no other sensor on it has already
+    _ds18Bus->begin();
 
     // Find the address if it's not known
     if (!_addressKnown) {
@@ -85,7 +230,7 @@ bool MaximDS18::setup(void) {
         bool gotAddress = false;
         // Try 5 times to get an address
         while (!gotAddress && ntries < 5) {
-            gotAddress = _internalOneWire.search(address);
+            gotAddress = _ds18Bus->begin() && _ds18Bus->claimAddress(address);
             ntries++;
         }
         if (gotAddress) {
@@ -126,10 +271,6 @@ bool MaximDS18::setup(void) {
         // have variable resolution.
     }
 
-    // Tell the sensor that we do NOT want to wait for conversions to finish
-    // That is, we're in ASYNC mode and will get values when we're ready
-    _internalDallasTemp.setWaitForConversion(false);
-
     // Turn the power back off it it had been turned on
     if (!wasOn) { powerDown(); }
 
@@ -144,23 +285,24 @@ bool MaximDS18::setup(void) {
 }
 
 
-// Sending the device a request to start temp conversion.
-// Because we put ourselves in ASYNC mode in setup, we don't have to wait for
-// finish
+// Sending the devices on the bus a request to start temp conversion.
+// Because the bus is in ASYNC mode, we don't have to wait for finish
 bool MaximDS18::startSingleMeasurement(void) {
     // Sensor::startSingleMeasurement() checks that if it's awake/active and
     // sets the timestamp and status bits.  If it returns false, there's no
     // reason to go on.
     if (!Sensor::startSingleMeasurement()) return false;
 
-    // Send the command to get temperatures
+    // Send the command to get temperatures, or join the conversion other
+    // sensors on the bus just started
     MS_DBG(F("Asking DS18 to take a measurement"));
-    bool success =
-        _internalDallasTemp.requestTemperaturesByAddress(_OneWireAddress);
+    uint16_t conversionId = _ds18Bus->startConversion(_conversionId);
+    bool     success      = conversionId != 0;
 
     if (success) {
-        // Update the time that a measurement was requested
-        _millisMeasurementRequested = millis();
+        _conversionId = conversionId;
+        // The measurement was requested when the bus conversion started
+        _millisMeasurementRequested = _ds18Bus->getConversionStart();
     } else {
         // Otherwise, make sure that the measurement start time and success bit
         // (bit 6) are unset
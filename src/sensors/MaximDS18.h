@@ -59,6 +59,15 @@
  * example provided within the Dallas Temperature library.  The sensor address
  * is programmed at the factory and cannot be changed.
  *
+ * All of the DS18's on the same data pin share a DS18Bus.  The bus searches for
+ * the sensors on the pin once, and again only if a sensor without a known
+ * address can't find one that hasn't been taken.  Sensors without a known
+ * address never take the address of a sensor made with one.  The bus starts the
+ * temperature conversion on every sensor at once with a single "skip ROM"
+ * convert command.  Sensors on a long chain (like a lake temperature string)
+ * then all finish their conversions together, after one 750ms wait, and each
+ * only has to have its own scratchpad read.
+ *
  * @section sensor_ds18_datasheet Sensor Datasheet
  * - [DS18B20 Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Sensor-Datasheets/Maxim-DS18B20-1-Wire-Temperature-Probe-Datasheet.pdf)
  * - [DS18S20 Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Sensor-Datasheets/Maxim-DS18S20-1-Wire-Temperature-Probe-Datasheet.pdf)
@@ -153,6 +162,157 @@
 #define DS18_TEMP_DEFAULT_CODE "DS18Temp"
 /**@}*/
 
+#ifndef MS_DS18_BUS_MAX_SENSORS
+/**
+ * @brief The number of sensor addresses a DS18 bus keeps from its search.
+ */
+#define MS_DS18_BUS_MAX_SENSORS 16
+#endif
+
+/**
+ * @brief The DS18 sensors sharing a OneWire data pin.
+ *
+ * There is one bus per data pin, made the first time a sensor on the pin asks
+ * for it with DS18Bus::getBus().  The bus owns the OneWire and
+ * DallasTemperature instances for the pin, keeps the addresses found by
+ * searching the pin, and starts the conversions for every sensor on it.
+ *
+ * @ingroup sensor_ds18
+ */
+class DS18Bus {
+ public:
+    /**
+     * @brief Get the bus for a data pin, creating it if needed.
+     *
+     * @param dataPin The pin on the mcu of the OneWire bus.
+     * @return **DS18Bus\*** The bus on that pin
+     */
+    static DS18Bus* getBus(int8_t dataPin);
+
+    /**
+     * @brief Get the DallasTemperature instance for the bus.
+     *
+     * @return **DallasTemperature&** The instance
+     */
+    DallasTemperature& getDallasTemp(void);
+
+    /**
+     * @brief Start the bus and search it for sensors, if that hasn't been done
+     * yet.
+     *
+     * The search is only repeated here if no sensors were found before.  The
+     * sensors must be powered.
+     *
+     * @return **bool** True if any sensors have been found on the bus
+     */
+    bool begin(void);
+    /**
+     * @brief Mark the address of a sensor made with a known address as taken,
+     * so it is never handed out by claimAddress().
+     *
+     * @param address The address of the sensor
+     */
+    void reserveAddress(DeviceAddress address);
+    /**
+     * @brief Get the first address found by the search that no other sensor
+     * has claimed or reserved.
+     *
+     * If every address found has been taken, the bus is searched again in
+     * case a sensor was missed or has been plugged in since.
+     *
+     * @param address The address to fill in
+     * @return **bool** True if there was an unclaimed address
+     */
+    bool claimAddress(DeviceAddress address);
+
+    /**
+     * @brief Start a temperature conversion on every sensor on the bus, unless
+     * one is already running that the sensor hasn't joined yet.
+     *
+     * @param lastJoined The id of the last conversion the sensor joined
+     * @return **uint16_t** The id of the conversion the sensor is now
+     * waiting on, or 0 if none could be started
+     */
+    uint16_t startConversion(uint16_t lastJoined);
+    /**
+     * @brief Get the millis() when the current conversion started.
+     *
+     * @return **uint32_t** The start of the conversion
+     */
+    uint32_t getConversionStart(void);
+
+ protected:
+    /**
+     * @brief Construct a new DS18 bus
+     *
+     * @param dataPin The data pin of the bus
+     */
+    explicit DS18Bus(int8_t dataPin);
+
+    /**
+     * @brief Search the bus and add any sensors not already known.
+     */
+    void search(void);
+    /**
+     * @brief Find an address in the list of known addresses.
+     *
+     * @param address The address to look for
+     * @return **int8_t** The slot of the address, or -1 if it isn't known
+     */
+    int8_t findAddress(DeviceAddress address);
+    /**
+     * @brief Find the first known address that hasn't been taken.
+     *
+     * @return **int8_t** The slot of the address, or -1 if they are all taken
+     */
+    int8_t findUnclaimed(void);
+
+    /**
+     * @brief The data pin of the bus
+     */
+    int8_t _dataPin;
+    /**
+     * @brief The OneWire instance on the data pin
+     */
+    OneWire _oneWire;
+    /**
+     * @brief The DallasTemperature instance using the OneWire instance
+     */
+    DallasTemperature _dallasTemp;
+    /**
+     * @brief The addresses found by searching the bus or reserved by sensors
+     */
+    DeviceAddress _addresses[MS_DS18_BUS_MAX_SENSORS];
+    /**
+     * @brief True for each address a sensor has claimed or reserved
+     */
+    bool _claimed[MS_DS18_BUS_MAX_SENSORS];
+    /**
+     * @brief The number of addresses in the list
+     */
+    uint8_t _numAddresses;
+    /**
+     * @brief The number of sensors that answered the last search
+     */
+    uint8_t _numFound;
+    /**
+     * @brief The id of the current conversion
+     */
+    uint16_t _conversionId;
+    /**
+     * @brief The millis() when the current conversion started
+     */
+    uint32_t _conversionStart;
+    /**
+     * @brief The next bus in the list of all busses
+     */
+    DS18Bus* _nextBus;
+    /**
+     * @brief The first bus in the list of all busses
+     */
+    static DS18Bus* _firstBus;
+};
+
 /* clang-format off */
 /**
  * @brief The Sensor sub-class for the
@@ -248,12 +408,13 @@ class MaximDS18 : public Sensor {
  private:
     DeviceAddress _OneWireAddress;
     bool          _addressKnown;
-    // Setup an internal OneWire instance to communicate with any OneWire
-    // devices (not just Maxim/Dallas temperature ICs)
-    OneWire _internalOneWire;
-    // Set up the internal a "Dallas Temperature" instance for communication
+    // The bus shared by all of the DS18's on the data pin
+    DS18Bus* _ds18Bus;
+    // The "Dallas Temperature" instance of the bus, for communication
     // specifically with the temperature sensors.
-    DallasTemperature _internalDallasTemp;
+    DallasTemperature& _internalDallasTemp;
+    // The id of the bus conversion this sensor last joined
+    uint16_t _conversionId;
     // Turns the address into a printable string
     String makeAddressString(DeviceAddress OneWireAddress);
 };
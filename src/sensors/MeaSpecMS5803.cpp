@@ -68,8 +68,12 @@ bool MeaSpecMS5803::addSingleMeasurementResult(void) {
         // NOTE:  These functions actually include the request to begin
         // a measurement and the wait for said measurement to finish.
         // It's pretty fast (max of 11 ms) so we'll just wait.
+        I2CBus* bus = I2CBus::getBus();
+        bus->beginTransaction(_i2cAddressHex);
         temp  = MS5803_internal.getTemperature(CELSIUS, ADC_512);
         press = MS5803_internal.getPressure(ADC_4096);
+        // The library reads back 0 when the sensor doesn't answer
+        bus->endTransaction(press != 0);
 
         if (isnan(temp)) temp = -9999;
         if (isnan(press)) press = -9999;
@@ -89,6 +89,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <MS5803.h>
 
 // Sensor Specific Defines
@@ -0,0 +1,115 @@
+/**
+ * @file ModbusBus.cpp
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the ModbusBus class.
+ */
+
+#include "ModbusBus.h"
+
+// The list of busses
+ModbusBus* ModbusBus::_firstBus = NULL;
+
+// The constructor
+ModbusBus::ModbusBus(Stream* stream) {
+    _stream       = stream;
+    _lastFrameEnd = 0;
+    _nextBus      = NULL;
+    setBaudRate(MS_MODBUS_BAUD_RATE);
+    resetCounts();
+}
+
+
+// This finds the bus on a stream or makes a new one
+ModbusBus* ModbusBus::getBus(Stream* stream) {
+    ModbusBus* bus = _firstBus;
+    while (bus != NULL) {
+        if (bus->_stream == stream) return bus;
+        bus = bus->_nextBus;
+    }
+    bus           = new ModbusBus(stream);
+    bus->_nextBus = _firstBus;
+    _firstBus     = bus;
+    return bus;
+}
+
+
+// The quiet time is 3.5 characters of 11 bits each, but never less than the
+// fixed time used above 19200 baud
+void ModbusBus::setBaudRate(uint32_t baudRate) {
+    _frameGap_us = baudRate > 0 ? 38500000L / baudRate : 0;
+    if (_frameGap_us < MODBUS_MIN_FRAME_GAP_US) {
+        _frameGap_us = MODBUS_MIN_FRAME_GAP_US;
+    }
+}
+
+
+void ModbusBus::beginTransaction(void) {
+    // Only wait for whatever is left of the quiet time
+    while (micros() - _lastFrameEnd < _frameGap_us) {}
+
+    // A reply that came in after its request timed out would be mistaken for
+    // the start of the next response
+    uint8_t dumped = 0;
+    while (_stream->available()) {
+        _stream->read();
+        dumped++;
+    }
+    if (dumped > 0) { MS_DBG(F("Dumped"), dumped, F("stale Modbus bytes")); }
+
+    _transactionStart = millis();
+}
+
+
+void ModbusBus::endTransaction(bool success) {
+    uint32_t latency = millis() - _transactionStart;
+    _lastFrameEnd    = micros();
+
+    _transactions++;
+    _totalLatency_ms += latency;
+    if (latency > _maxLatency_ms) _maxLatency_ms = latency;
+
+    if (success) {
+        MS_DBG(F("Modbus transaction succeeded in"), latency, F("ms"));
+    } else if (latency < MS_MODBUS_RESPONSE_TIMEOUT_MS) {
+        // The modbus library doesn't say why a request failed; this one
+        // returned before its timeout, so something probably came back
+        _fastFailures++;
+        MS_DBG(F("Modbus transaction failed in"), latency, F("ms"));
+    } else {
+        _slowFailures++;
+        MS_DBG(F("Modbus transaction failed after"), latency, F("ms"));
+    }
+}
+
+
+uint32_t ModbusBus::getTransactionCount(void) {
+    return _transactions;
+}
+uint32_t ModbusBus::getFailureCount(void) {
+    return _slowFailures + _fastFailures;
+}
+uint32_t ModbusBus::getSlowFailureCount(void) {
+    return _slowFailures;
+}
+uint32_t ModbusBus::getFastFailureCount(void) {
+    return _fastFailures;
+}
+float ModbusBus::getMeanLatency(void) {
+    if (_transactions == 0) return -9999;
+    return static_cast<float>(_totalLatency_ms) / _transactions;
+}
+uint32_t ModbusBus::getMaxLatency(void) {
+    return _maxLatency_ms;
+}
+
+
+void ModbusBus::resetCounts(void) {
+    _transactions    = 0;
+    _slowFailures    = 0;
+    _fastFailures    = 0;
+    _totalLatency_ms = 0;
+    _maxLatency_ms   = 0;
+}
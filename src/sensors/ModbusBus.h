@@ -0,0 +1,243 @@
+/**
+ * @file ModbusBus.h
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the ModbusBus class, which keeps the frame spacing and
+ * statistics for all of the Modbus sensors sharing a serial port.
+ *
+ * The Modbus requests themselves are made by the sensor libraries
+ * (YosemitechModbus, KellerModbus) through SensorModbusMaster, which block
+ * until each response comes in or times out.  Each sensor brackets its
+ * requests with ModbusBus::beginTransaction() and ModbusBus::endTransaction()
+ * so the bus can space the frames and count the results.  The bus does not
+ * queue or reorder requests; they still go out one at a time in the order the
+ * sensors make them.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_MODBUSBUS_H_
+#define SRC_SENSORS_MODBUSBUS_H_
+
+// Debugging Statement
+// #define MS_MODBUSBUS_DEBUG
+
+#ifdef MS_MODBUSBUS_DEBUG
+#define MS_DEBUGGING_STD "ModbusBus"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Arduino.h>
+
+/** @ingroup the_sensors */
+/**@{*/
+
+#ifndef MS_MODBUS_BAUD_RATE
+/**
+ * @brief The default baud rate of a Modbus bus, used to work out the quiet
+ * time between frames.  All of the Yosemitech and Keller sensors talk at 9600
+ * baud.
+ */
+#define MS_MODBUS_BAUD_RATE 9600
+#endif
+
+#ifndef MS_MODBUS_RESPONSE_TIMEOUT_MS
+/**
+ * @brief How long SensorModbusMaster waits for a response before giving up,
+ * in milliseconds.
+ *
+ * The bus uses this to sort failed transactions into fast and slow failures.
+ * This must match the timeout of the modbus library, which is 500 ms unless
+ * it has been changed.
+ */
+#define MS_MODBUS_RESPONSE_TIMEOUT_MS 500
+#endif
+
+/**
+ * @brief The quiet time between Modbus RTU frames above 19200 baud, in
+ * microseconds; the specification fixes it instead of scaling it by the baud
+ * rate.
+ */
+#define MODBUS_MIN_FRAME_GAP_US 1750
+/**@}*/
+
+/**
+ * @brief Keeps the timing and statistics of the Modbus transactions of all
+ * of the sensors on one serial port.
+ *
+ * There is one bus for each stream, made the first time a sensor on the
+ * stream asks for it with ModbusBus::getBus().  Before a sensor sends a
+ * request it calls beginTransaction(), which waits out only whatever is left
+ * of the 3.5 character quiet time Modbus RTU requires after the previous frame
+ * on the port and throws away any late reply still sitting in the buffer.
+ * When the response has been read the sensor calls endTransaction() with the
+ * result.
+ *
+ * The bus counts the transactions, the failed transactions, and the time they
+ * took, so a string of sensors that's spending too long on the bus can be
+ * spotted.  SensorModbusMaster only tells the sensor libraries whether a
+ * request succeeded, not why it failed, so the bus has no CRC or exception
+ * code to count.  Instead it sorts the failures by how long they took: a fast
+ * failure ended before #MS_MODBUS_RESPONSE_TIMEOUT_MS and a slow failure
+ * didn't.  This is only a guess at the cause.  A slow failure is most likely
+ * a request that got no answer at all, from a sensor that's unpowered or at
+ * the wrong address; a fast failure most likely got an answer that was
+ * garbled or an exception, which points to noise or wiring on the RS485 line.
+ *
+ * This is not a scheduler, and it doesn't queue or pipeline requests.  Modbus
+ * RTU is half-duplex with a single master: only one request can be
+ * outstanding on the line, and the master must have the response or give up
+ * on it before the next request goes out.  On top of that the sensor
+ * libraries block until each response arrives, and the sensors make their
+ * requests one after another as the VariableArray walks through them.  A
+ * queue could only reorder those requests, never overlap them, so the bus
+ * just keeps the frames from running together.
+ *
+ * @ingroup the_sensors
+ */
+class ModbusBus {
+ public:
+    /**
+     * @brief Get the bus for a stream, creating it if needed.
+     *
+     * @param stream The stream the Modbus sensors are attached to
+     * @return **ModbusBus\*** The bus on that stream
+     */
+    static ModbusBus* getBus(Stream* stream);
+
+    /**
+     * @brief Set the baud rate of the bus, which sets the quiet time between
+     * frames.
+     *
+     * @param baudRate The baud rate of the stream; the default is
+     * #MS_MODBUS_BAUD_RATE.
+     */
+    void setBaudRate(uint32_t baudRate);
+
+    /**
+     * @brief Get ready to send a request on the bus.
+     *
+     * This waits until the quiet time after the last frame has passed and
+     * empties the stream buffer.
+     */
+    void beginTransaction(void);
+    /**
+     * @brief Record the end of a transaction.
+     *
+     * @param success True if a good response was received
+     */
+    void endTransaction(bool success);
+
+    /**
+     * @brief Get the number of transactions on the bus since the counts were
+     * last reset.
+     *
+     * @return **uint32_t** The number of transactions
+     */
+    uint32_t getTransactionCount(void);
+    /**
+     * @brief Get the number of transactions that didn't get a good response.
+     *
+     * This is the sum of getSlowFailureCount() and getFastFailureCount().
+     *
+     * @return **uint32_t** The number of failed transactions
+     */
+    uint32_t getFailureCount(void);
+    /**
+     * @brief Get the number of failed transactions that lasted at least
+     * #MS_MODBUS_RESPONSE_TIMEOUT_MS.
+     *
+     * These are probably requests that got no response, but the modbus
+     * library doesn't say.
+     *
+     * @return **uint32_t** The number of slow failures
+     */
+    uint32_t getSlowFailureCount(void);
+    /**
+     * @brief Get the number of failed transactions that ended before
+     * #MS_MODBUS_RESPONSE_TIMEOUT_MS.
+     *
+     * These are probably responses that failed their CRC check or were
+     * exceptions, but the modbus library doesn't say.
+     *
+     * @return **uint32_t** The number of fast failures
+     */
+    uint32_t getFastFailureCount(void);
+    /**
+     * @brief Get the mean time from the start of a transaction to its end.
+     *
+     * @return **float** The mean transaction time in milliseconds, or -9999 if
+     * there have been no transactions.
+     */
+    float getMeanLatency(void);
+    /**
+     * @brief Get the longest time from the start of a transaction to its end.
+     *
+     * @return **uint32_t** The longest transaction time in milliseconds
+     */
+    uint32_t getMaxLatency(void);
+    /**
+     * @brief Reset the transaction counts and times.
+     */
+    void resetCounts(void);
+
+ protected:
+    /**
+     * @brief Construct a new Modbus bus
+     *
+     * @param stream The stream of the bus
+     */
+    explicit ModbusBus(Stream* stream);
+
+    /**
+     * @brief The stream of the bus
+     */
+    Stream* _stream;
+    /**
+     * @brief The quiet time needed between frames, in microseconds
+     */
+    uint32_t _frameGap_us;
+    /**
+     * @brief The micros() at the end of the last transaction
+     */
+    uint32_t _lastFrameEnd;
+    /**
+     * @brief The millis() at the start of the current transaction
+     */
+    uint32_t _transactionStart;
+    /**
+     * @brief The number of transactions since the counts were reset
+     */
+    uint32_t _transactions;
+    /**
+     * @brief The number of slow failures since the counts were reset
+     */
+    uint32_t _slowFailures;
+    /**
+     * @brief The number of fast failures since the counts were reset
+     */
+    uint32_t _fastFailures;
+    /**
+     * @brief The total time of all transactions since the counts were reset,
+     * in milliseconds
+     */
+    uint32_t _totalLatency_ms;
+    /**
+     * @brief The longest transaction since the counts were reset, in
+     * milliseconds
+     */
+    uint32_t _maxLatency_ms;
+    /**
+     * @brief The next bus in the list of all busses
+     */
+    ModbusBus* _nextBus;
+    /**
+     * @brief The first bus in the list of all busses
+     */
+    static ModbusBus* _firstBus;
+};
+
+#endif  // SRC_SENSORS_MODBUSBUS_H_
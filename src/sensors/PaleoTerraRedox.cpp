@@ -26,6 +26,9 @@ PaleoTerraRedox::PaleoTerraRedox(SoftwareWire* theI2C, int8_t powerPin,
     _i2cAddressHex      = i2cAddressHex;
     _i2c                = theI2C;
     createdSoftwareWire = false;
+    _resultConfig       = 0;
+    _resultReady        = false;
+    _lastPoll           = 0;
 }
 PaleoTerraRedox::PaleoTerraRedox(int8_t powerPin, int8_t dataPin,
                                  int8_t clockPin, uint8_t i2cAddressHex,
@@ -36,6 +39,9 @@ PaleoTerraRedox::PaleoTerraRedox(int8_t powerPin, int8_t dataPin,
     _i2cAddressHex      = i2cAddressHex;
     _i2c                = new SoftwareWire(dataPin, clockPin);
     createdSoftwareWire = true;
+    _resultConfig       = 0;
+    _resultReady        = false;
+    _lastPoll           = 0;
 }
 #else
 PaleoTerraRedox::PaleoTerraRedox(TwoWire* theI2C, int8_t powerPin,
@@ -46,6 +52,9 @@ PaleoTerraRedox::PaleoTerraRedox(TwoWire* theI2C, int8_t powerPin,
              measurementsToAverage) {
     _i2cAddressHex = i2cAddressHex;
     _i2c           = theI2C;
+    _resultConfig  = 0;
+    _resultReady   = false;
+    _lastPoll      = 0;
 }
 PaleoTerraRedox::PaleoTerraRedox(int8_t powerPin, uint8_t i2cAddressHex,
                                  uint8_t measurementsToAverage)
@@ -54,6 +63,9 @@ PaleoTerraRedox::PaleoTerraRedox(int8_t powerPin, uint8_t i2cAddressHex,
              measurementsToAverage) {
     _i2cAddressHex = i2cAddressHex;
     _i2c           = &Wire;
+    _resultConfig  = 0;
+    _resultReady   = false;
+    _lastPoll      = 0;
 }
 #endif
 
@@ -84,6 +96,10 @@ String      PaleoTerraRedox::getSensorLocation(void) {
 
 
 bool PaleoTerraRedox::setup(void) {
+#if !defined(MS_PALEOTERRA_SOFTWAREWIRE)
+    // Start the hardware bus, unless it's already running
+    I2CBus::getBus(_i2c)->begin();
+#else
     _i2c->begin();  // Start the wire library (sensor power not required)
     // Eliminate any potential extra waits in the wire library
     // These waits would be caused by a readBytes or parseX being called
@@ -93,70 +109,172 @@ bool PaleoTerraRedox::setup(void) {
     // buffer.  In the case of the Wire library, that will never happen and
     // the timeout period is a useless delay.
     _i2c->setTimeout(0);
+#endif
     return Sensor::setup();  // this will set pin modes and the setup status
                              // bit
 }
 
 
+// The configuration byte for a one-shot, 18 bit conversion with a gain of one
+#define PTR_CONFIG_ONE_SHOT_18_BIT B10001100
+// The ready bit of the configuration byte reads as 0 once a new result is
+// in the output register
+#define PTR_CONFIG_NOT_READY B10000000
+
+
+bool PaleoTerraRedox::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+
+    MS_DBG(F("Starting conversion on"), getSensorNameAndLocation());
+#if !defined(MS_PALEOTERRA_SOFTWAREWIRE)
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->beginTransaction(_i2cAddressHex);
+#endif
+    _i2c->beginTransmission(_i2cAddressHex);
+    _i2c->write(PTR_CONFIG_ONE_SHOT_18_BIT);
+    int i2c_status = _i2c->endTransmission();
+    // NOTE: The return of 0 from endTransmission indicates success
+#if !defined(MS_PALEOTERRA_SOFTWAREWIRE)
+    bus->endTransaction(i2c_status == 0);
+#endif
+
+    if (i2c_status == 0) {
+        // Update the time that a measurement was requested
+        _millisMeasurementRequested = millis();
+        // Any output kept from before is now stale
+        _resultReady = false;
+        _lastPoll    = 0;
+        return true;
+    }
+    // Otherwise, make sure that the measurement start time and success bit
+    // (bit 6) are unset
+    MS_DBG(getSensorNameAndLocation(),
+           F("did not successfully start a measurement. I2C status:"),
+           i2c_status);
+    _millisMeasurementRequested = 0;
+    _sensorStatus &= 0b10111111;
+    return false;
+}
+
+
+bool PaleoTerraRedox::isMeasurementComplete(bool debug) {
+    // If the measurement didn't start, or is finished, there's nothing to do
+    if (!bitRead(_sensorStatus, 6) || _resultReady) return true;
+
+    uint32_t elapsed = millis() - _millisMeasurementRequested;
+    // Once the full measurement time has passed the result is read anyway
+    if (elapsed > _measurementTime_ms) {
+        return Sensor::isMeasurementComplete(debug);
+    }
+
+    // Don't start checking until most of the conversion time has passed, and
+    // then don't check too often
+    if (elapsed < PTR_CONVERSION_TIME_MS - PTR_CONVERSION_TIME_MS / 8) {
+        return false;
+    }
+    if (_lastPoll != 0 && millis() - _lastPoll < MS_PTR_POLL_INTERVAL_MS) {
+        return false;
+    }
+    _lastPoll = millis();
+
+    if (readConversion()) {
+        if (debug) {
+            MS_DBG(getSensorNameAndLocation(), F("finished its conversion in"),
+                   elapsed, F("ms"));
+        }
+        return true;
+    }
+    return false;
+}
+
+
+bool PaleoTerraRedox::readConversion(void) {
+    // Get 4 bytes from device; the 3 output bytes and the configuration
+#if !defined(MS_PALEOTERRA_SOFTWAREWIRE)
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->beginTransaction(_i2cAddressHex);
+#endif
+    uint8_t received = _i2c->requestFrom(int(_i2cAddressHex), 4);
+#if !defined(MS_PALEOTERRA_SOFTWAREWIRE)
+    bus->endTransaction(received > 0);
+#endif
+    if (received != 4) {
+        // Drop anything that did come back
+        while (_i2c->available()) _i2c->read();
+        _resultConfig = 0;
+        return false;
+    }
+    _resultBytes[0] = _i2c->read();
+    _resultBytes[1] = _i2c->read();
+    _resultBytes[2] = _i2c->read();
+    _resultConfig   = _i2c->read();
+
+    _resultReady = !(_resultConfig & PTR_CONFIG_NOT_READY);
+    return _resultReady;
+}
+
+
 bool PaleoTerraRedox::addSingleMeasurementResult(void) {
     bool success = false;
 
-    byte config = 0;  // Data transfer values
-
-    float res = 0;  // Calculated voltage in uV
-
-    byte i2c_status = -1;
-    if (_millisMeasurementRequested > 0) {
-        _i2c->beginTransmission(_i2cAddressHex);
-        _i2c->write(B10001100);  // initiate conversion, One-Shot mode, 18
-                                 // bits, PGA x1
-        i2c_status = _i2c->endTransmission();
-
-        delay(300);
-
-        _i2c->requestFrom(int(_i2cAddressHex),
-                          4);  // Get 4 bytes from device
-        byte res1 = _i2c->read();
-        byte res2 = _i2c->read();
-        byte res3 = _i2c->read();
-        config    = _i2c->read();
-
-        res      = 0;
-        int sign = bitRead(res1, 1);  // one but least significant bit
-        if (sign == 1) {
-            res1 = ~res1;
-            res2 = ~res2;
-            res3 = ~res3;  // two's complements
-            res  = bitRead(res1, 0) *
-                -1024;  // 256 * 256 * 15.625 uV per LSB = 16
-            res -= res2 * 4;
-            res -= res3 * 0.015625;
-            res -= 0.015625;
+    float res = -9999;  // Calculated voltage in uV
+
+    // Check a measurement was *successfully* started (status bit 6 set)
+    // Only go on to get a result if it was
+    if (bitRead(_sensorStatus, 6)) {
+        // Read the output unless it was already picked up while checking
+        if (!_resultReady) readConversion();
+
+        byte res1 = _resultBytes[0];
+        byte res2 = _resultBytes[1];
+        byte res3 = _resultBytes[2];
+
+        if (!_resultReady) {
+            MS_DBG(getSensorNameAndLocation(),
+                   F("did not finish its conversion; config:"),
+                   String(_resultConfig, BIN));
         } else {
-            res = bitRead(res1, 0) *
-                1024;  // 256 * 256 * 15.625 uV per LSB = 16
-            res += res2 * 4;
-            res += res3 * 0.015625;
+            int sign = bitRead(res1, 1);  // one but least significant bit
+            if (sign == 1) {
+                res1 = ~res1;
+                res2 = ~res2;
+                res3 = ~res3;  // two's complements
+                res  = bitRead(res1, 0) *
+                    -1024;  // 256 * 256 * 15.625 uV per LSB = 16
+                res -= res2 * 4;
+                res -= res3 * 0.015625;
+                res -= 0.015625;
+            } else {
+                res = bitRead(res1, 0) *
+                    1024;  // 256 * 256 * 15.625 uV per LSB = 16
+                res += res2 * 4;
+                res += res3 * 0.015625;
+            }
+            success = true;
         }
     } else {
-        MS_DBG(F("Sensor is not currently measuring!\n"));
+        MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
     }
 
     // ADD FAILURE CONDITIONS!!
-    if (isnan(res))
-        res = -9999;  // list a failure if the sensor returns nan (not sure
-                      // how this would happen, keep to be safe)
-    else if (res == 0 && i2c_status == 0 && config == 0)
-        res = -9999;  // List a failure when the sensor is not connected
+    if (isnan(res)) {
+        res     = -9999;  // list a failure if the sensor returns nan (not sure
+                          // how this would happen, keep to be safe)
+        success = false;
+    } else if (res == 0 && _resultConfig == 0) {
+        res     = -9999;  // List a failure when the sensor is not connected
+        success = false;
+    }
     // Store the results in the sensorValues array
     verifyAndAddMeasurementResult(PTR_VOLTAGE_VAR_NUM, res);
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
-    // Unset the status bit for a measurement having been requested (bit 5)
-    _sensorStatus &= 0b11011111;
-    // Set the status bit for measurement completion (bit 6)
-    _sensorStatus |= 0b01000000;
+    // Unset the status bits for a measurement request (bits 5 & 6)
+    _sensorStatus &= 0b10011111;
 
     return success;
 }
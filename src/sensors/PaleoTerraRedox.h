@@ -72,6 +72,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <Wire.h>
 
 #if defined MS_PALEOTERRA_SOFTWAREWIRE
@@ -98,11 +99,27 @@
 /// @brief Sensor::_stabilizationTime_ms; the PaleoTerra redox sensor is
 /// immediately stable.
 #define PTR_STABILIZATION_TIME_MS 0
-/// @brief Sensor::_measurementTime_ms; the PaleoTerra redox sensor takes 67ms
-/// to complete a measurement.
-#define PTR_MEASUREMENT_TIME_MS 67
+/**
+ * @brief Sensor::_measurementTime_ms; the PaleoTerra redox sensor takes at most
+ * 300ms to complete a measurement.
+ *
+ * The MCP3421 inside the probe makes 3.75 18-bit samples per second, so a
+ * one-shot conversion takes about 267ms.  The probe's ready bit is polled, so
+ * this is only the longest the measurement is waited for.
+ */
+#define PTR_MEASUREMENT_TIME_MS 300
+/// @brief The nominal time of an 18-bit conversion by the MCP3421, in ms.
+#define PTR_CONVERSION_TIME_MS 267
 /**@}*/
 
+#ifndef MS_PTR_POLL_INTERVAL_MS
+/**
+ * @brief The time between checks of the ready bit of a PaleoTerra redox probe
+ * once its conversion is nearly done, in ms.
+ */
+#define MS_PTR_POLL_INTERVAL_MS 5
+#endif
+
 /**
  * @anchor sensor_pt_redox_volt
  * @name Voltage
@@ -246,12 +263,60 @@ class PaleoTerraRedox : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @brief Tell the sensor to start a single measurement, if needed.
+     *
+     * This writes the configuration byte for a one-shot, 18-bit conversion
+     * with a gain of one to the MCP3421 and, if that succeeds, sets the
+     * #_millisMeasurementRequested timestamp.
+     *
+     * @return **bool** True if the start measurement function completed
+     * successfully.
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @brief Check whether the conversion is finished.
+     *
+     * Once most of #PTR_CONVERSION_TIME_MS has passed this reads the output
+     * bytes of the MCP3421 every #MS_PTR_POLL_INTERVAL_MS and checks its
+     * ready bit, so the conversions of several probes overlap and the result
+     * is taken as soon as it's ready.  The output bytes are kept for
+     * addSingleMeasurementResult().
+     *
+     * @param debug True to output the result to the debugging Serial
+     * @return **bool** True indicates the conversion is finished.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
+    /**
+     * @brief Read the three output bytes and the configuration byte of the
+     * MCP3421.
+     *
+     * @return **bool** True if the bytes were read and the ready bit shows
+     * they are the result of a new conversion.
+     */
+    bool readConversion(void);
+    /**
+     * @brief The output bytes of the last conversion read.
+     */
+    byte _resultBytes[3];
+    /**
+     * @brief The configuration byte read with the output.
+     */
+    byte _resultConfig;
+    /**
+     * @brief True if the output of the current conversion has been read.
+     */
+    bool _resultReady;
+    /**
+     * @brief The millis() of the last check of the ready bit.
+     */
+    uint32_t _lastPoll;
     /**
      * @brief The I2C address of the redox sensor.
      */
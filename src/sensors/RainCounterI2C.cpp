@@ -8,7 +8,14 @@
  * @brief Implements the RainCounterI2C class.
  */
 
+#define LIBCALL_ENABLEINTERRUPT  // To prevent compiler/linker crashes
+#include <EnableInterrupt.h>     // To handle external and pin change interrupts
+
 #include "RainCounterI2C.h"
+#include "LoggerClock.h"
+
+// The counter using an interrupt on the logger, if any
+RainCounterI2C* RainCounterI2C::_tipCounter = NULL;
 
 
 // The constructors
@@ -60,9 +67,22 @@ RainCounterI2C::RainCounterI2C(uint8_t i2cAddressHex, float rainPerTip)
 // there will be a memory leak
 RainCounterI2C::~RainCounterI2C() {
     if (createdSoftwareWire) delete _i2c;
+    if (_tipCounter == this) {
+        disableInterrupt(_tipPin);
+        _tipCounter = NULL;
+    }
+    delete[] _tipQueue;
+    delete[] _tipLog;
 }
 #else
-RainCounterI2C::~RainCounterI2C() {}
+RainCounterI2C::~RainCounterI2C() {
+    if (_tipCounter == this) {
+        disableInterrupt(_tipPin);
+        _tipCounter = NULL;
+    }
+    delete[] _tipQueue;
+    delete[] _tipLog;
+}
 #endif
 
 
@@ -80,6 +100,10 @@ String      RainCounterI2C::getSensorLocation(void) {
 
 
 bool RainCounterI2C::setup(void) {
+#if !defined(MS_RAIN_SOFTWAREWIRE)
+    // Start the hardware bus, unless it's already running
+    I2CBus::getBus(_i2c)->begin();
+#else
     _i2c->begin();  // Start the wire library (sensor power not required)
     // Eliminate any potential extra waits in the wire library
     // These waits would be caused by a readBytes or parseX being called
@@ -89,41 +113,256 @@ bool RainCounterI2C::setup(void) {
     // buffer.  In the case of the Wire library, that will never happen and
     // the timeout period is a useless delay.
     _i2c->setTimeout(0);
-    return Sensor::setup();  // this will set pin modes and the setup status bit
+#endif
+
+    bool retVal =
+        Sensor::setup();  // this will set pin modes and the setup status bit
+
+    // Start catching tips on the interrupt pin
+    if (_tipPin >= 0 && _tipQueue != NULL && _tipLog != NULL) {
+        if (_tipCounter != NULL && _tipCounter != this) {
+            // The interrupt has only one counter to hand its tips to
+            MS_DBG(F("Pin"), _tipCounter->_tipPin,
+                   F("is already counting tips; can't count on pin"),
+                   _tipPin);
+            retVal = false;
+        } else {
+            MS_DBG(F("Counting tips on pin"), _tipPin);
+            _tipCounter = this;
+            pinMode(_tipPin, INPUT_PULLUP);
+            enableInterrupt(_tipPin, tipISR, FALLING);
+            _lastReadEpoch = LoggerClock::getEpoch();
+        }
+    } else if (variables[BUCKET_PEAK_VAR_NUM] != NULL ||
+               variables[BUCKET_PEAK_VAR_NUM + 1] != NULL) {
+        MS_DBG(F("The peak intensities of"), getSensorNameAndLocation(),
+               F("are only measured with a tip pin, and will be -9999"));
+    }
+
+    if (!retVal) {  // if set-up failed
+        // Set the status error bit (bit 7)
+        _sensorStatus |= 0b10000000;
+        // UN-set the set-up bit (bit 0) since setup failed!
+        _sensorStatus &= 0b11111110;
+    }
+
+    return retVal;
+}
+
+
+void RainCounterI2C::setTipPin(int8_t tipPin) {
+    _tipPin = tipPin;
+    // The queue and log are only needed when counting on a pin
+    if (_tipPin >= 0 && _tipQueue == NULL) {
+        _tipQueue = new uint32_t[MS_RAIN_TIP_QUEUE_SIZE];
+        _tipLog   = new uint32_t[MS_RAIN_TIP_LOG_SIZE];
+    }
+}
+
+
+void RainCounterI2C::setPeakWindow(uint8_t windowNumber, uint16_t window_s) {
+    if (windowNumber < BUCKET_NUM_PEAK_WINDOWS) {
+        _peakWindow_s[windowNumber] = window_s;
+    }
+}
+
+
+// The ISR can't read the clock, so it only notes the millis() of the tip
+void RainCounterI2C::tipISR(void) {
+    RainCounterI2C* counter = _tipCounter;
+    if (counter == NULL) return;
+
+    uint32_t now = millis();
+    if (counter->_tipCount != 0 &&
+        now - counter->_lastTipMillis < MS_RAIN_TIP_DEBOUNCE_MS) {
+        return;
+    }
+    counter->_lastTipMillis = now;
+    counter->_tipCount++;
+
+    uint8_t next = (counter->_queueHead + 1) % MS_RAIN_TIP_QUEUE_SIZE;
+    if (next != counter->_queueTail) {
+        counter->_tipQueue[counter->_queueHead] = now;
+        counter->_queueHead                     = next;
+    }
+}
+
+
+// millis() stops while the processor sleeps, so this has to be done before
+// each sleep.  A tip that woke the processor has the millis() it went to sleep
+// with, which the logger clock, re-anchored on waking, puts at the wake.
+void RainCounterI2C::timestampEvents(void) {
+    if (_tipPin < 0 || _tipQueue == NULL) return;
+    if (_queueTail == _queueHead) return;
+
+    // Any tip that comes in after this is left for the next time
+    uint8_t  head = _queueHead;
+    uint16_t nowMs;
+    uint32_t nowEpoch  = LoggerClock::getEpoch(nowMs);
+    uint32_t nowMillis = millis();
+
+    while (_queueTail != head) {
+        // The ISR only writes at the head, so the tail is safe to read
+        uint32_t elapsed  = nowMillis - _tipQueue[_queueTail];
+        uint32_t tipEpoch = nowEpoch;
+        if (elapsed > nowMs) tipEpoch -= (elapsed - nowMs + 999) / 1000;
+        logTip(tipEpoch);
+        _queueTail = (_queueTail + 1) % MS_RAIN_TIP_QUEUE_SIZE;
+    }
+}
+
+
+void RainCounterI2C::logTip(uint32_t tipEpoch) {
+    if (_logCount >= MS_RAIN_TIP_LOG_SIZE) {
+        // Drop the oldest tip; the peaks for this interval may now be short
+        _logStart = (_logStart + 1) % MS_RAIN_TIP_LOG_SIZE;
+        _logCount--;
+        _logOverflowed = true;
+    }
+    _tipLog[(_logStart + _logCount) % MS_RAIN_TIP_LOG_SIZE] = tipEpoch;
+    _logCount++;
+}
+
+
+uint32_t RainCounterI2C::loggedTip(uint16_t i) {
+    return _tipLog[(_logStart + i) % MS_RAIN_TIP_LOG_SIZE];
+}
+
+
+// This slides a window over the logged tips and keeps the most tips in it
+float RainCounterI2C::getPeakIntensity(uint8_t  windowNumber,
+                                       uint32_t intervalStart) {
+    uint16_t window_s = _peakWindow_s[windowNumber];
+    if (window_s == 0 || _logOverflowed) return -9999;
+
+    uint16_t mostTips = 0;
+    uint16_t first    = 0;
+    for (uint16_t last = 0; last < _logCount; last++) {
+        uint32_t lastEpoch = loggedTip(last);
+        while (first < last && lastEpoch - loggedTip(first) >= window_s) {
+            first++;
+        }
+        // Windows ending before the last reading were already reported
+        if (lastEpoch >= intervalStart && last - first + 1 > mostTips) {
+            mostTips = last - first + 1;
+        }
+    }
+    return mostTips * _rainPerTip * 3600.0f / window_s;
 }
 
 
 bool RainCounterI2C::addSingleMeasurementResult(void) {
     // intialize values
     float   rain = -9999;  // Number of mm of rain
-    int16_t tips = -9999;  // Number of tip events
+    int32_t tips = -9999;  // Number of tip events
+    float   peaks[BUCKET_NUM_PEAK_WINDOWS];
+    for (uint8_t i = 0; i < BUCKET_NUM_PEAK_WINDOWS; i++) peaks[i] = -9999;
 
-    // Get data from external tip counter
-    // if the 'requestFrom' returns 0, it means no bytes were received
-    if (_i2c->requestFrom(static_cast<uint8_t>(_i2cAddressHex),
-                          static_cast<uint8_t>(2))) {
-        MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
+    if (_tipPin >= 0 && _tipLog != NULL) {
+        // Tips caught by the interrupt
+        timestampEvents();
+        uint32_t nowEpoch = LoggerClock::getEpoch();
 
-        uint8_t Byte1 = _i2c->read();  // Low byte of data
-        uint8_t Byte2 = _i2c->read();  // High byte of data
+        noInterrupts();
+        uint32_t count = _tipCount;
+        interrupts();
+        // The count is unsigned, so the difference is right even after the
+        // count wraps
+        tips            = static_cast<int32_t>(count - _tipCountAtRead);
+        _tipCountAtRead = count;
+        rain            = static_cast<float>(tips) * _rainPerTip;
 
-        tips = (Byte2 << 8) | (Byte1);  // Concatenate tip values
-        rain = static_cast<float>(tips) *
-            _rainPerTip;  // Multiply by tip coefficient (0.2 by default)
+        uint16_t longest = 0;
+        for (uint8_t i = 0; i < BUCKET_NUM_PEAK_WINDOWS; i++) {
+            peaks[i] = getPeakIntensity(i, _lastReadEpoch);
+            if (_peakWindow_s[i] > longest) longest = _peakWindow_s[i];
+        }
 
-        if (tips < 0)
-            tips = -9999;  // If negetive value results, return failure
-        if (rain < 0)
-            rain = -9999;  // If negetive value results, return failure
+        // Keep only the tips that could be in a window ending after now
+        while (_logCount > 0 && loggedTip(0) + longest <= nowEpoch) {
+            _logStart = (_logStart + 1) % MS_RAIN_TIP_LOG_SIZE;
+            _logCount--;
+        }
+        _logOverflowed = false;
+        _lastReadEpoch = nowEpoch;
 
+        MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
         MS_DBG(F("  Rain:"), rain);
         MS_DBG(F("  Tips:"), tips);
+        MS_DBG(F("  Peak intensities:"), peaks[0], peaks[1]);
     } else {
-        MS_DBG(F("No bytes received from"), getSensorNameAndLocation());
+        // Get data from external tip counter
+        // if the 'requestFrom' returns 0, it means no bytes were received
+#if !defined(MS_RAIN_SOFTWAREWIRE)
+        I2CBus* bus = I2CBus::getBus(_i2c);
+        bus->beginTransaction(_i2cAddressHex);
+#endif
+        uint8_t received = _i2c->requestFrom(
+            static_cast<uint8_t>(_i2cAddressHex),
+            static_cast<uint8_t>(BUCKET_COUNT_BYTES));
+#if !defined(MS_RAIN_SOFTWAREWIRE)
+        bus->endTransaction(received > 0);
+#endif
+        if (received) {
+            MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
+
+            uint8_t countBytes[BUCKET_COUNT_BYTES];
+            for (uint8_t i = 0; i < BUCKET_COUNT_BYTES; i++) {
+                // Bytes past the end of what was sent read as 0xFF
+                countBytes[i] = _i2c->available() ? _i2c->read() : 0xFF;
+            }
+
+            // Older counter firmware only sends a 16 bit count, so the two
+            // high bytes come back as 0xFF; a real 32 bit count can't get
+            // that high
+            if (countBytes[2] == 0xFF && countBytes[3] == 0xFF) {
+                MS_DBG(F("  16 bit count from older counter firmware"));
+                // The count is unsigned, so counts over 32767 are still good
+                tips = (static_cast<uint16_t>(countBytes[1]) << 8) |
+                    countBytes[0];
+            } else {
+                uint32_t count = 0;
+                for (int8_t i = BUCKET_COUNT_BYTES - 1; i >= 0; i--) {
+                    count = (count << 8) | countBytes[i];
+                }
+                tips = static_cast<int32_t>(count);
+            }
+
+            // The counter clears its count when read, so a count of more tips
+            // than the bucket could make since the last reading has wrapped
+            // or been garbled
+            uint32_t nowEpoch = LoggerClock::getEpoch();
+            if (_lastReadEpoch != 0 && tips > 0 &&
+                static_cast<uint32_t>(tips) >
+                    ((nowEpoch - _lastReadEpoch) / 60 + 1) *
+                        MS_RAIN_MAX_TIPS_PER_MINUTE) {
+                MS_DBG(F("  Impossible count of"), tips, F("tips in"),
+                       nowEpoch - _lastReadEpoch, F("seconds"));
+                tips = -9999;
+            }
+            _lastReadEpoch = nowEpoch;
+
+            rain = static_cast<float>(tips) *
+                _rainPerTip;  // Multiply by tip coefficient (0.2 by default)
+
+            if (tips < 0)
+                tips = -9999;  // If negetive value results, return failure
+            if (rain < 0)
+                rain = -9999;  // If negetive value results, return failure
+
+            MS_DBG(F("  Rain:"), rain);
+            MS_DBG(F("  Tips:"), tips);
+        } else {
+            MS_DBG(F("No bytes received from"), getSensorNameAndLocation());
+        }
     }
 
     verifyAndAddMeasurementResult(BUCKET_RAIN_VAR_NUM, rain);
-    verifyAndAddMeasurementResult(BUCKET_TIPS_VAR_NUM, tips);
+    verifyAndAddMeasurementResult(BUCKET_TIPS_VAR_NUM,
+                                  static_cast<float>(tips));
+    for (uint8_t i = 0; i < BUCKET_NUM_PEAK_WINDOWS; i++) {
+        verifyAndAddMeasurementResult(BUCKET_PEAK_VAR_NUM + i, peaks[i]);
+    }
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
@@ -6,7 +6,8 @@
  * Edited by Sara Geleskie Damiano <sdamiano@stroudcenter.org>
  *
  * @brief Contains the RainCounterI2C sensor subclass and the variable
- * subclasses RainCounterI2C_Tips and RainCounterI2C_Depth.
+ * subclasses RainCounterI2C_Tips, RainCounterI2C_Depth and
+ * RainCounterI2C_PeakIntensity.
  *
  * These are for an external tip counter, used to measure rainfall via a tipping
  * bucket rain gauge
@@ -31,14 +32,29 @@
  * @section sensor_i2c_rain_intro Introduction
  *
  * This module is for use with a simple external I2C tipping bucket counter
- * based on an [Adafriut Trinket](https://www.adafruit.com/product/1501). This
- * is *NOT* for direct counting of tips using an interrupt on the main
- * processor.  The construction and programming of the tipping bucket counter is
+ * based on an [Adafriut Trinket](https://www.adafruit.com/product/1501).  The
+ * construction and programming of the tipping bucket counter is
  * documented on
  * [GitHub](https://github.com/EnviroDIY/TippingBucketRainCounter).  It is
  * assumed that the processor of the tip counter takes care of its own power
  * management.
  *
+ * The same driver can instead count the tips of a bucket wired straight to an
+ * interrupt pin on the logger, with RainCounterI2C::setTipPin().  Then each
+ * tip is caught by an interrupt, which notes its millis(), and is given a time
+ * from the logger clock before the processor next sleeps.  Each tip wakes the
+ * processor, so tips during sleep are timed by the wake.  From those times the
+ * driver reports the peak rain intensity over two moving windows, set with
+ * RainCounterI2C::setPeakWindow(); by default 1 and 15 minutes.  The I2C
+ * counter only sends a count, so the peak intensities are always -9999 unless
+ * setTipPin() is used.  Only one counter can use an interrupt pin, and the pin
+ * must be able to wake the processor.  The setup of a second counter with a
+ * tip pin fails.
+ *
+ * A count from the I2C counter that's more than the bucket could tip since the
+ * last reading (#MS_RAIN_MAX_TIPS_PER_MINUTE) is taken to have wrapped or been
+ * garbled, and is reported as -9999.
+ *
  * @section sensor_i2c_rain_datasheet Sensor Datasheet
  * - [Adafriut Trinket](https://www.adafruit.com/product/1501)
  * - [I2C Tipping Bucket Library](https://github.com/EnviroDIY/TippingBucketRainCounter)
@@ -82,6 +98,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
 #include <Wire.h>
 
 #if defined MS_RAIN_SOFTWAREWIRE
@@ -92,9 +109,68 @@
 /** @ingroup sensor_i2c_rain */
 /**@{*/
 
-/// @brief Sensor::_numReturnedValues; the tipping bucket counter can report 2
-/// values.
-#define BUCKET_NUM_VARIABLES 2
+/**
+ * @brief Sensor::_numReturnedValues; the tipping bucket counter can report 4
+ * values.
+ *
+ * The two peak intensities are only measured when the tips are counted on an
+ * interrupt pin with RainCounterI2C::setTipPin().  With the I2C counter they
+ * are always -9999.
+ */
+#define BUCKET_NUM_VARIABLES 4
+/// @brief The number of windows the peak rain intensity is reported for.
+#define BUCKET_NUM_PEAK_WINDOWS 2
+
+/**
+ * @brief The number of bytes of tip count read from the counter.
+ *
+ * Current versions of the counter firmware send the tips since the last
+ * reading as a 32 bit count.  Older versions send only a 16 bit count and the
+ * bytes after it read as 0xFF, which is how the older versions are recognized.
+ */
+#define BUCKET_COUNT_BYTES 4
+
+#ifndef MS_RAIN_MAX_TIPS_PER_MINUTE
+/**
+ * @brief The most tips a bucket can make in a minute.
+ *
+ * A count from the I2C counter higher than this allows for the time since the
+ * last reading has wrapped or been garbled, so it is thrown out.
+ */
+#define MS_RAIN_MAX_TIPS_PER_MINUTE 120
+#endif
+
+#ifndef MS_RAIN_TIP_DEBOUNCE_MS
+/**
+ * @brief The time after a tip caught by interrupt during which any more
+ * switch closures are taken as bounces, in milliseconds.
+ */
+#define MS_RAIN_TIP_DEBOUNCE_MS 25
+#endif
+
+#ifndef MS_RAIN_TIP_QUEUE_SIZE
+/**
+ * @brief The number of tips caught by interrupt that can wait for a time
+ * stamp.
+ *
+ * Tips are stamped before every sleep, so this only needs to hold the tips
+ * from one stretch of the logger being awake.  Tips that don't fit are still
+ * counted but aren't used for the peak intensity.
+ */
+#define MS_RAIN_TIP_QUEUE_SIZE 16
+#endif
+
+#ifndef MS_RAIN_TIP_LOG_SIZE
+/**
+ * @brief The number of time stamped tips kept for working out the peak
+ * intensities.
+ *
+ * This must hold all the tips in a logging interval plus the longest peak
+ * window; if it overflows, the peak intensities for the interval are -9999.
+ * Each tip takes 4 bytes, allocated only when a tip pin is set.
+ */
+#define MS_RAIN_TIP_LOG_SIZE 100
+#endif
 
 /**
  * @anchor sensor_i2c_rain_timing
@@ -170,6 +246,39 @@
 #define BUCKET_TIPS_DEFAULT_CODE "RainCounterI2CTips"
 /**@}*/
 
+/**
+ * @anchor sensor_i2c_rain_peak
+ * @name Peak Intensity
+ * Defines for the peak rain intensity variables from a tipping bucket counted
+ * with an interrupt on the logger
+ * - Only available when the tips are counted with RainCounterI2C::setTipPin()
+ * - The unit follows the rain per tip, per hour
+ *
+ * {{ @ref RainCounterI2C_PeakIntensity::RainCounterI2C_PeakIntensity }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the peak intensity should
+/// have 1.
+#define BUCKET_PEAK_RESOLUTION 1
+/// @brief Sensor variable number; the peak intensity over the first window is
+/// stored in sensorValues[2] and over the second in sensorValues[3].
+#define BUCKET_PEAK_VAR_NUM 2
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "rainfallRate"
+#define BUCKET_PEAK_VAR_NAME "rainfallRate"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millimeterPerHour"
+#define BUCKET_PEAK_UNIT_NAME "millimeterPerHour"
+/// @brief Default variable short code; "RainCounterI2CPeak"
+#define BUCKET_PEAK_DEFAULT_CODE "RainCounterI2CPeak"
+/// @brief The default length of the first peak intensity window, in seconds
+#define BUCKET_PEAK_WINDOW_1_S 60
+/// @brief The default length of the second peak intensity window, in seconds
+#define BUCKET_PEAK_WINDOW_2_S 900
+/**@}*/
+
 
 /* clang-format off */
 /**
@@ -269,16 +378,134 @@ class RainCounterI2C : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @brief Count the tips of a bucket wired to an interrupt pin on the
+     * logger instead of asking the I2C counter.
+     *
+     * Call this before setup().  The pin is pulled up and a tip is counted
+     * when the bucket's switch pulls it low.  This is the only way to get the
+     * peak intensities.  Only one counter can use an interrupt pin; the setup
+     * of any other counter given a tip pin fails.
+     *
+     * @param tipPin The pin the bucket's switch is on; -1 to use the I2C
+     * counter.
+     */
+    void setTipPin(int8_t tipPin);
+    /**
+     * @brief Set the length of a moving window the peak intensity is reported
+     * for.
+     *
+     * @param windowNumber The window; 0 or 1
+     * @param window_s The length of the window in seconds; 0 turns off the
+     * window.
+     */
+    void setPeakWindow(uint8_t windowNumber, uint16_t window_s);
+
+    /**
+     * @brief Give a time from the logger clock to the tips caught by the
+     * interrupt since this was last called.
+     */
+    void timestampEvents(void) override;
+
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
+    /**
+     * @brief The interrupt service routine for a tip.
+     */
+    static void tipISR(void);
+    /**
+     * @brief Add a time stamped tip to the tip log, dropping the oldest if
+     * the log is full.
+     *
+     * @param tipEpoch The time of the tip
+     */
+    void logTip(uint32_t tipEpoch);
+    /**
+     * @brief Get a tip from the tip log.
+     *
+     * @param i The position of the tip, from the oldest
+     * @return **uint32_t** The time of the tip
+     */
+    uint32_t loggedTip(uint16_t i);
+    /**
+     * @brief Work out the peak intensity over a window from the tip log.
+     *
+     * @param windowNumber The window
+     * @param intervalStart The time of the last reading; only windows ending
+     * after it are used.
+     * @return **float** The peak intensity in rain units per hour, or -9999
+     * if the window is off or the log overflowed.
+     */
+    float getPeakIntensity(uint8_t windowNumber, uint32_t intervalStart);
+
+    /**
+     * @brief The counter using an interrupt on the logger, if any.
+     */
+    static RainCounterI2C* _tipCounter;
+
     /**
      * @brief The depth of rain per tip.
      */
     float _rainPerTip;
+    /**
+     * @brief The interrupt pin the tips are counted on, or -1 to use the I2C
+     * counter.
+     */
+    int8_t _tipPin = -1;
+    /**
+     * @brief The lengths of the peak intensity windows, in seconds.
+     */
+    uint16_t _peakWindow_s[BUCKET_NUM_PEAK_WINDOWS] = {BUCKET_PEAK_WINDOW_1_S,
+                                                       BUCKET_PEAK_WINDOW_2_S};
+    /**
+     * @brief The time of the last reading from the logger clock.
+     */
+    uint32_t _lastReadEpoch = 0;
+    /**
+     * @brief The number of tips caught by the interrupt; this is allowed to
+     * wrap.
+     */
+    volatile uint32_t _tipCount = 0;
+    /**
+     * @brief The tip count at the last reading.
+     */
+    uint32_t _tipCountAtRead = 0;
+    /**
+     * @brief The millis() of the last tip caught by the interrupt.
+     */
+    volatile uint32_t _lastTipMillis = 0;
+    /**
+     * @brief The millis() of the tips waiting for a time stamp.
+     */
+    volatile uint32_t* _tipQueue = NULL;
+    /**
+     * @brief Where the interrupt puts the next tip in #_tipQueue.
+     */
+    volatile uint8_t _queueHead = 0;
+    /**
+     * @brief The oldest tip in #_tipQueue.
+     */
+    volatile uint8_t _queueTail = 0;
+    /**
+     * @brief The times of the time stamped tips, oldest first, in a ring.
+     */
+    uint32_t* _tipLog = NULL;
+    /**
+     * @brief The position of the oldest tip in #_tipLog.
+     */
+    uint16_t _logStart = 0;
+    /**
+     * @brief The number of tips in #_tipLog.
+     */
+    uint16_t _logCount = 0;
+    /**
+     * @brief True if tips were dropped from the log since the last reading.
+     */
+    bool _logOverflowed = false;
     /**
      * @brief The I2C address of the Trinket counter.
      */
@@ -387,5 +614,56 @@ class RainCounterI2C_Depth : public Variable {
      */
     ~RainCounterI2C_Depth() {}
 };
+
+/**
+ * @brief The Variable sub-class used for the
+ * [peak intensity output](@ref sensor_i2c_rain_peak) from a tipping bucket
+ * counted with an interrupt on the logger
+ * - gives the most rain in any window of the set length since the last
+ * reading, as a rate per hour.
+ *
+ * @note This is always -9999 unless the parent counter has been given a tip
+ * pin with RainCounterI2C::setTipPin().
+ *
+ * @ingroup sensor_i2c_rain
+ */
+class RainCounterI2C_PeakIntensity : public Variable {
+ public:
+    /**
+     * @brief Construct a new RainCounterI2C_PeakIntensity object.
+     *
+     * @param parentSense The parent RainCounterI2C providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "RainCounterI2CPeak".
+     * @param windowNumber The peak intensity window; 0 (the default) or 1.
+     */
+    explicit RainCounterI2C_PeakIntensity(
+        RainCounterI2C* parentSense, const char* uuid = "",
+        const char* varCode = BUCKET_PEAK_DEFAULT_CODE,
+        uint8_t     windowNumber = 0)
+        : Variable(parentSense,
+                   (const uint8_t)(BUCKET_PEAK_VAR_NUM + windowNumber),
+                   (uint8_t)BUCKET_PEAK_RESOLUTION, BUCKET_PEAK_VAR_NAME,
+                   BUCKET_PEAK_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new RainCounterI2C_PeakIntensity object for the
+     * first window.
+     *
+     * @note This must be tied with a parent RainCounterI2C before it can be
+     * used.
+     */
+    RainCounterI2C_PeakIntensity()
+        : Variable((const uint8_t)BUCKET_PEAK_VAR_NUM,
+                   (uint8_t)BUCKET_PEAK_RESOLUTION, BUCKET_PEAK_VAR_NAME,
+                   BUCKET_PEAK_UNIT_NAME, BUCKET_PEAK_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the RainCounterI2C_PeakIntensity object - no action
+     * needed.
+     */
+    ~RainCounterI2C_PeakIntensity() {}
+};
 /**@}*/
 #endif  // SRC_SENSORS_RAINCOUNTERI2C_H_
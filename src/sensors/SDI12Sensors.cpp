@@ -13,6 +13,83 @@
 #include "SDI12Sensors.h"
 
 
+// ============================================================================
+//  The shared SDI-12 bus on a data pin
+// ============================================================================
+
+// The list of busses
+SDI12Bus* SDI12Bus::_firstBus = NULL;
+
+// The constructor - the interface isn't started until a sensor needs it
+SDI12Bus::SDI12Bus(int8_t dataPin) : _interface(dataPin) {
+    _dataPin = dataPin;
+    _nextBus = NULL;
+    for (uint8_t i = 0; i < MS_SDI12_BUS_MAX_SENSORS; i++) {
+        _addresses[i]    = '\0';
+        _lastResponse[i] = 0;
+    }
+}
+
+
+// This finds the bus on a pin or makes a new one
+SDI12Bus* SDI12Bus::getBus(int8_t dataPin) {
+    SDI12Bus* bus = _firstBus;
+    while (bus != NULL) {
+        if (bus->_dataPin == dataPin) return bus;
+        bus = bus->_nextBus;
+    }
+    bus           = new SDI12Bus(dataPin);
+    bus->_nextBus = _firstBus;
+    _firstBus     = bus;
+    return bus;
+}
+
+
+SDI12& SDI12Bus::getInterface(void) {
+    return _interface;
+}
+
+
+// This records a good response from an address.  An address that isn't
+// already known takes a free slot, or the stalest slot if none are free.
+void SDI12Bus::markPresent(char address) {
+    uint32_t now  = millis();
+    int8_t   slot = -1;
+    for (uint8_t i = 0; i < MS_SDI12_BUS_MAX_SENSORS && slot < 0; i++) {
+        if (_addresses[i] == address) slot = i;
+    }
+    for (uint8_t i = 0; i < MS_SDI12_BUS_MAX_SENSORS && slot < 0; i++) {
+        if (_addresses[i] == '\0') slot = i;
+    }
+    if (slot < 0) {
+        slot = 0;
+        for (uint8_t i = 1; i < MS_SDI12_BUS_MAX_SENSORS; i++) {
+            if (now - _lastResponse[i] > now - _lastResponse[slot]) slot = i;
+        }
+    }
+    _addresses[slot]    = address;
+    _lastResponse[slot] = now;
+}
+void SDI12Bus::markAbsent(char address) {
+    for (uint8_t i = 0; i < MS_SDI12_BUS_MAX_SENSORS; i++) {
+        if (_addresses[i] == address) { _addresses[i] = '\0'; }
+    }
+}
+bool SDI12Bus::isPresent(char address) {
+    for (uint8_t i = 0; i < MS_SDI12_BUS_MAX_SENSORS; i++) {
+        if (_addresses[i] == address) {
+            return millis() - _lastResponse[i] < MS_SDI12_PRESENCE_TIMEOUT_MS;
+        }
+    }
+    return false;
+}
+
+
+// ============================================================================
+//  The SDI-12 sensor parent class
+// ============================================================================
+
+
 // The constructor - need the number of measurements the sensor will return,
 // SDI-12 address, the power pin, and the data pin
 SDI12Sensors::SDI12Sensors(char SDI12address, int8_t powerPin, int8_t dataPin,
@@ -24,7 +101,12 @@ SDI12Sensors::SDI12Sensors(char SDI12address, int8_t powerPin, int8_t dataPin,
                            uint32_t      measurementTime_ms)
     : Sensor(sensorName, numReturnedVars, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, dataPin, measurementsToAverage),
-      _SDI12Internal(dataPin) {
+      _SDI12Bus(SDI12Bus::getBus(dataPin)),
+      _SDI12Internal(_SDI12Bus->getInterface()),
+      _measurementWait_ms(-1),
+      _useCRC(false),
+      _useContinuous(false),
+      _crcFailures(0) {
     _SDI12address = SDI12address;
 }
 SDI12Sensors::SDI12Sensors(char* SDI12address, int8_t powerPin, int8_t dataPin,
@@ -36,7 +118,12 @@ SDI12Sensors::SDI12Sensors(char* SDI12address, int8_t powerPin, int8_t dataPin,
                            uint32_t      measurementTime_ms)
     : Sensor(sensorName, numReturnedVars, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, dataPin, measurementsToAverage),
-      _SDI12Internal(dataPin) {
+      _SDI12Bus(SDI12Bus::getBus(dataPin)),
+      _SDI12Internal(_SDI12Bus->getInterface()),
+      _measurementWait_ms(-1),
+      _useCRC(false),
+      _useContinuous(false),
+      _crcFailures(0) {
     _SDI12address = *SDI12address;
 }
 SDI12Sensors::SDI12Sensors(int SDI12address, int8_t powerPin, int8_t dataPin,
@@ -48,7 +135,12 @@ SDI12Sensors::SDI12Sensors(int SDI12address, int8_t powerPin, int8_t dataPin,
                            uint32_t      measurementTime_ms)
     : Sensor(sensorName, numReturnedVars, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, dataPin, measurementsToAverage),
-      _SDI12Internal(dataPin) {
+      _SDI12Bus(SDI12Bus::getBus(dataPin)),
+      _SDI12Internal(_SDI12Bus->getInterface()),
+      _measurementWait_ms(-1),
+      _useCRC(false),
+      _useContinuous(false),
+      _crcFailures(0) {
     _SDI12address = SDI12address + '0';
 }
 // Destructor
@@ -103,36 +195,49 @@ bool SDI12Sensors::setup(void) {
 }
 
 
+void SDI12Sensors::powerDown(void) {
+    Sensor::powerDown();
+    // A sensor that loses power must be checked again once it's powered back
+    // up; it might not come back, or might come back on another address
+    if (_powerPin >= 0) { _SDI12Bus->markAbsent(_SDI12address); }
+}
+
+
 bool SDI12Sensors::requestSensorAcknowledgement(void) {
+    // Skip the check if the sensor answered a moment ago
+    if (_SDI12Bus->isPresent(_SDI12address)) {
+        MS_DBG(F("  "), getSensorNameAndLocation(),
+               F("responded recently; not asking for acknowledgement"));
+        return true;
+    }
+
     // Empty the buffer
     _SDI12Internal.clearBuffer();
 
     MS_DBG(F("  Asking for sensor acknowlegement"));
-    String myCommand = "";
-    myCommand += static_cast<char>(_SDI12address);
-    myCommand += "!";  // sends 'acknowledge active' command [address][!]
+    // sends 'acknowledge active' command [address][!]
+    char myCommand[3] = {_SDI12address, '!', '\0'};
 
     bool    didAcknowledge = false;
     uint8_t ntries         = 0;
-    while (!didAcknowledge && ntries < 5) {
+    while (!didAcknowledge && ntries < MS_SDI12_ACKNOWLEDGE_RETRIES) {
         _SDI12Internal.sendCommand(myCommand);
         MS_DBG(F("    >>>"), myCommand);
-        delay(30);
 
         // wait for acknowlegement with format:
         // [address]<CR><LF>
-        String sdiResponse = _SDI12Internal.readStringUntil('\n');
-        sdiResponse.trim();
+        char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+        uint8_t length = readResponse(sdiResponse, sizeof(sdiResponse));
         MS_DBG(F("    <<<"), sdiResponse);
 
         // Empty the buffer again
         _SDI12Internal.clearBuffer();
 
-        if (sdiResponse == String(_SDI12address)) {
+        if (length == 1 && sdiResponse[0] == _SDI12address) {
             MS_DBG(F("   "), getSensorNameAndLocation(),
                    F("replied as expected."));
             didAcknowledge = true;
-        } else if (sdiResponse.startsWith(String(_SDI12address))) {
+        } else if (length > 1 && sdiResponse[0] == _SDI12address) {
             MS_DBG(F("   "), getSensorNameAndLocation(),
                    F("replied, unexpectedly"));
             didAcknowledge = true;
@@ -144,6 +249,11 @@ bool SDI12Sensors::requestSensorAcknowledgement(void) {
         ntries++;
     }
 
+    if (didAcknowledge) {
+        _SDI12Bus->markPresent(_SDI12address);
+    } else {
+        _SDI12Bus->markAbsent(_SDI12address);
+    }
     return didAcknowledge;
 }
 
@@ -168,17 +278,17 @@ bool SDI12Sensors::getSensorInfo(void) {
     if (!requestSensorAcknowledgement()) return false;
 
     MS_DBG(F("  Getting sensor info"));
-    String myCommand = "";
-    myCommand += static_cast<char>(_SDI12address);
-    myCommand += "I!";  // sends 'info' command [address][I][!]
+    // sends 'info' command [address][I][!]
+    char myCommand[4] = {_SDI12address, 'I', '!', '\0'};
     _SDI12Internal.sendCommand(myCommand);
     MS_DBG(F("    >>>"), myCommand);
-    delay(30);
 
     // wait for acknowlegement with format:
     // [address][SDI12 version supported (2 char)][vendor (8 char)][model (6
     // char)][version (3 char)][serial number (<14 char)]<CR><LF>
-    String sdiResponse = _SDI12Internal.readStringUntil('\n');
+    char infoResponse[SDI12_RESPONSE_BUFFER_SIZE];
+    readResponse(infoResponse, sizeof(infoResponse));
+    String sdiResponse = infoResponse;
     sdiResponse.trim();
     MS_DBG(F("    <<<"), sdiResponse);
 
@@ -235,6 +345,45 @@ String SDI12Sensors::getSensorSerialNumber(void) {
 }
 
 
+// The CRC settings and diagnostics
+void SDI12Sensors::setCRCMode(bool useCRC) {
+    _useCRC = useCRC;
+}
+bool SDI12Sensors::getCRCMode(void) {
+    return _useCRC;
+}
+uint16_t SDI12Sensors::getCRCFailureCount(void) {
+    return _crcFailures;
+}
+float SDI12Sensors::getDiagnosticValue(uint8_t diagnosticNumber) {
+    if (diagnosticNumber == SDI12_CRC_FAILURES_DIAG_NUM) return _crcFailures;
+    return -9999;
+}
+
+
+// The continuous measurement setting
+void SDI12Sensors::setContinuousMode(bool useContinuous) {
+    _useContinuous = useContinuous;
+}
+bool SDI12Sensors::getContinuousMode(void) {
+    return _useContinuous;
+}
+
+
+// This builds the command to collect a block of data
+void SDI12Sensors::buildDataCommand(char* command, uint8_t block) {
+    uint8_t i    = 0;
+    command[i++] = _SDI12address;
+    command[i++] = _useContinuous ? 'R' : 'D';
+    // The CRC of a continuous measurement has to be asked for with the
+    // command; after a measurement it was asked for when it was started
+    if (_useContinuous && _useCRC) command[i++] = 'C';
+    command[i++] = static_cast<char>('0' + block);
+    command[i++] = '!';
+    command[i]   = '\0';
+}
+
+
 // The sensor installation location on the Mayfly
 String SDI12Sensors::getSensorLocation(void) {
     String sensorLocation = F("SDI12-");
@@ -251,9 +400,7 @@ bool SDI12Sensors::startSingleMeasurement(void) {
     // reason to go on.
     if (!Sensor::startSingleMeasurement()) return false;
 
-    String startCommand;
-    String sdiResponse;
-    bool   wasActive;
+    bool wasActive;
 
     // MS_DBG(F("   Activating SDI-12 instance for"),
     //        getSensorNameAndLocation());
@@ -276,22 +423,33 @@ bool SDI12Sensors::startSingleMeasurement(void) {
         return false;
     }
 
+    // For continuous measurements there's nothing to start; the values are
+    // ready as soon as they're asked for
+    if (_useContinuous) {
+        MS_DBG(F("  Using continuous measurements on"),
+               getSensorNameAndLocation());
+        if (!wasActive) _SDI12Internal.end();
+        _measurementWait_ms = 0;
+        return true;
+    }
+
     MS_DBG(F("  Beginning concurrent measurement on"),
            getSensorNameAndLocation());
-    startCommand = "";
-    startCommand += _SDI12address;
-    startCommand +=
-        "C!";  // Start concurrent measurement - format  [address]['C'][!]
+    // Start concurrent measurement - format  [address]['C'][!], or
+    // [address]['C']['C'][!] to get CRC's on the data
+    char startCommand[5] = {_SDI12address, 'C', '!', '\0', '\0'};
+    if (_useCRC) {
+        startCommand[2] = 'C';
+        startCommand[3] = '!';
+    }
     _SDI12Internal.sendCommand(startCommand);
-    delay(30);  // It just needs this little delay
     MS_DBG(F("    >>>"), startCommand);
 
     // wait for acknowlegement with format
     // [address][ttt (3 char, seconds)][number of values to be returned,
     // 0-9]<CR><LF>
-    sdiResponse = _SDI12Internal.readStringUntil('\n');
-    sdiResponse.trim();
-    _SDI12Internal.clearBuffer();
+    char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+    uint8_t length = readResponse(sdiResponse, sizeof(sdiResponse));
     MS_DBG(F("    <<<"), sdiResponse);
 
     // Empty the buffer again
@@ -302,16 +460,26 @@ bool SDI12Sensors::startSingleMeasurement(void) {
     if (!wasActive) _SDI12Internal.end();
 
     // Verify the number of results the sensor will send
-    uint8_t numVariables = sdiResponse.substring(4).toInt();
+    uint8_t numVariables = length > 4 ? atoi(sdiResponse + 4) : 0;
     if (numVariables != _numReturnedValues) {
         PRINTOUT(numVariables, F("results expected"),
                  F("This differs from the sensor's standard design of"),
                  _numReturnedValues, F("measurements!!"));
     }
 
+    // Find out how long the measurement will take, in seconds
+    _measurementWait_ms = -1;
+    if (length >= 4 && isdigit(sdiResponse[1]) && isdigit(sdiResponse[2]) &&
+        isdigit(sdiResponse[3])) {
+        _measurementWait_ms = 1000L *
+            ((sdiResponse[1] - '0') * 100 + (sdiResponse[2] - '0') * 10 +
+             (sdiResponse[3] - '0'));
+    }
+
     // Set the times we've activated the sensor and asked for a measurement
-    if (sdiResponse.length() > 0) {
+    if (length > 0) {
         MS_DBG(F("    Concurrent measurement started."));
+        _SDI12Bus->markPresent(_SDI12address);
         // Update the time that a measurement was requested
         _millisMeasurementRequested = millis();
         // Set the status bit for measurement start success (bit 6)
@@ -320,11 +488,33 @@ bool SDI12Sensors::startSingleMeasurement(void) {
     } else {
         MS_DBG(getSensorNameAndLocation(),
                F("did not respond to measurement request!"));
+        _SDI12Bus->markAbsent(_SDI12address);
         _millisMeasurementRequested = 0;
         _sensorStatus &= 0b10111111;
         return false;
     }
 }
+
+
+// This checks the time the sensor gave for the measurement
+bool SDI12Sensors::isMeasurementComplete(bool debug) {
+    // Without a time from the sensor, use the standard measurement time
+    if (!bitRead(_sensorStatus, 6) || _measurementWait_ms < 0) {
+        return Sensor::isMeasurementComplete(debug);
+    }
+
+    uint32_t elapsed_since_meas_start = millis() - _millisMeasurementRequested;
+    if (elapsed_since_meas_start >=
+        static_cast<uint32_t>(_measurementWait_ms)) {
+        if (debug) {
+            MS_DBG(F("It's been"), (elapsed_since_meas_start),
+                   F("ms, and"), getSensorNameAndLocation(),
+                   F("said its measurement would take"), _measurementWait_ms);
+        }
+        return true;
+    }
+    return false;
+}
 #endif
 
 bool SDI12Sensors::getResults(void) {
@@ -355,74 +545,37 @@ bool SDI12Sensors::getResults(void) {
     // more data is returned.
     while (resultsReceived < _numReturnedValues && cmd_number <= 9) {
         bool gotResults = false;
-        // Assemble the command based on how many commands we've already sent,
-        // starting with D0 and ending with D9
-        // SDI-12 command to get data [address][D][dataOption][!]
-        String getDataCommand = "";
-        getDataCommand += _SDI12address;
-        getDataCommand += "D";
-        getDataCommand += cmd_number;
-        getDataCommand += "!";
-        _SDI12Internal.sendCommand(getDataCommand);
-        delay(30);  // It just needs this little delay
-        MS_DBG(F("    >>>"), getDataCommand);
+        // Ask for the next block of data, D0 through D9; the response has
+        // the format [address][values]<CR><LF>, with the CRC removed
+        char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+        uint8_t length = requestDataBlock(cmd_number, sdiResponse,
+                                          sizeof(sdiResponse));
+        if (length == 0) {
+            MS_DBG(F("  No usable response, will not continue requests!"));
+            break;
+        }
 
-        // Wait for the first few charaters to arrive.  The response from a data
-        // request should always have more than three characters
-        uint32_t start = millis();
-        while (_SDI12Internal.available() < 3 && (millis() - start) < 1500) {}
-        MS_DBG(F("  Receiving results from"), getSensorNameAndLocation());
-        // read the returned address to remove it from the buffer
-        char returnedAddress = _SDI12Internal.read();
         // print out a warning if the address doesn't match up
-        if (returnedAddress != _SDI12address) {
+        if (sdiResponse[0] != _SDI12address) {
             MS_DBG(F("Warning, expecting data from"), _SDI12address,
-                   F("but got data from"), returnedAddress);
+                   F("but got data from"), sdiResponse[0]);
         }
-        // Start printing out the returned data
-        MS_DBG(F("    <<<"), static_cast<char>(returnedAddress));
-
-        // While there is any data left in the buffer
-        while (_SDI12Internal.available() && (millis() - start) < 3000) {
-            // First peek to see if the next character in the buffer in a number
-            int c = _SDI12Internal.peek();
-            // if there's a number, a decimal, or a negative sign next in the
-            // buffer, start reading it as a float.
-            if (c == '-' || (c >= '0' && c <= '9') || c == '.') {
-                // Read the float without skipping any in-valid characters.
-                // We don't want to skip anything because we want to be able to
-                // debug and see exactly which characters the sensor sent over
-                // if they weren't numbers.
-                // Reading the numbers as a float will remove them from the
-                // buffer.
-                float result = _SDI12Internal.parseFloat(SKIP_NONE);
-                // The SDI-12 library should return -9999 on timeout
-                if (result == -9999 || isnan(result)) result = -9999;
-                // Print out what we got
-                MS_DBG(F("    <<<"), String(result, 10));
-                // Verify that the number is valid and add it to the result
-                // array. After each result is read, tick up the number of
-                // results received so that the next one goes in the next spot
-                // in the variable array.
-                verifyAndAddMeasurementResult(resultsReceived, result);
-                if (result != -9999) {
-                    gotResults = true;
-                    resultsReceived++;
-                }
-                // if the next spot in the buffer isn't a number, we don't want
-                // to try and parse it, but we do want to print it out to the
-                // debugging port
-            } else {
-                // if we're debugging print out the non-numeric character
-#ifdef MS_SDI12SENSORS_DEBUG
-                MS_DBG(F("    <<<"), static_cast<char>(_SDI12Internal.read()));
-#else
-                // if we're not debugging, just read the character to make sure
-                // it's removed from the buffer
-                _SDI12Internal.read();
-#endif
+
+        // Parse the values following the address
+        const char* next = sdiResponse + 1;
+        float       result;
+        while (parseValue(next, result)) {
+            // Print out what we got
+            MS_DBG(F("    <<<"), String(result, 10));
+            // Verify that the number is valid and add it to the result
+            // array. After each result is read, tick up the number of
+            // results received so that the next one goes in the next spot
+            // in the variable array.
+            verifyAndAddMeasurementResult(resultsReceived, result);
+            if (result != -9999) {
+                gotResults = true;
+                resultsReceived++;
             }
-            delay(10);  // 1 character ~ 7.5ms
         }
         if (!gotResults) {
             MS_DBG(F("  No results received, will not continue requests!"));
@@ -448,6 +601,156 @@ bool SDI12Sensors::getResults(void) {
 }
 
 
+// This reads a single response line into a buffer
+uint8_t SDI12Sensors::readResponse(char* buffer, uint8_t bufferSize,
+                                   uint32_t timeout_ms) {
+    uint8_t length = 0;
+    buffer[0]      = '\0';
+
+    // Wait for the response to start
+    uint32_t start = millis();
+    while (!_SDI12Internal.available()) {
+        if (millis() - start > timeout_ms) return 0;
+    }
+
+    // Read until the end of the line, a gap in the characters, or the time
+    // it would take to fill the buffer
+    uint32_t lineTime_ms = static_cast<uint32_t>(bufferSize + 2) *
+            SDI12_CHARACTER_TIME_US / 1000 +
+        SDI12_CHARACTER_GAP_MS;
+    uint32_t lineStart = millis();
+    uint32_t lastChar  = lineStart;
+    while (millis() - lastChar < SDI12_CHARACTER_GAP_MS &&
+           millis() - lineStart < lineTime_ms) {
+        if (!_SDI12Internal.available()) continue;
+        char c   = _SDI12Internal.read();
+        lastChar = millis();
+        if (c == '\n') break;
+        if (c == '\r') continue;
+        if (length < bufferSize - 1) buffer[length++] = c;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+
+// This asks for one block of data, asking again for blocks that fail their CRC
+uint8_t SDI12Sensors::requestDataBlock(uint8_t block, char* response,
+                                       uint8_t responseSize) {
+    // SDI-12 command to get data [address][D][dataOption][!], or
+    // [address][R][dataOption][!] for continuous measurements
+    char getDataCommand[6];
+    buildDataCommand(getDataCommand, block);
+
+    uint8_t crcTries = 0;
+    while (true) {
+        _SDI12Internal.sendCommand(getDataCommand);
+        MS_DBG(F("    >>>"), getDataCommand);
+
+        // Read the whole response, with format:
+        // [address][values]<CR><LF> or [address][values][CRC]<CR><LF>
+        MS_DBG(F("  Receiving results from"), getSensorNameAndLocation());
+        uint8_t length = readResponse(response, responseSize,
+                                      SDI12_DATA_TIMEOUT_MS);
+        MS_DBG(F("    <<<"), response);
+
+        // A sensor that didn't answer won't answer if it's asked again, and
+        // that's not a CRC failure
+        if (length == 0) return 0;
+
+        // Only this block of data needs to be asked for again if it doesn't
+        // match its CRC.  A response too short to carry a CRC is cut off,
+        // rather than mismatched, so it's asked for again without counting.
+        if (!_useCRC || checkCRC(response, length)) {
+            _SDI12Bus->markPresent(_SDI12address);
+            return length;
+        }
+        if (length >= 4) {
+            _crcFailures++;
+            MS_DBG(F("  CRC check failed!"));
+        } else {
+            MS_DBG(F("  Response too short to have a CRC!"));
+        }
+        if (crcTries++ >= MS_SDI12_CRC_RETRIES) {
+            MS_DBG(F("  No response passed its CRC check!"));
+            response[0] = '\0';
+            return 0;
+        }
+    }
+}
+
+
+// This checks and removes the CRC from the end of a response
+bool SDI12Sensors::checkCRC(char* response, uint8_t& length) {
+    if (length < 4) return false;
+
+    uint16_t crc = 0;
+    for (uint8_t i = 0; i < length - 3; i++) {
+        crc ^= static_cast<uint8_t>(response[i]);
+        for (uint8_t j = 0; j < 8; j++) {
+            if (crc & 0x0001) {
+                crc = (crc >> 1) ^ 0xA001;
+            } else {
+                crc >>= 1;
+            }
+        }
+    }
+
+    const char* sentCRC = response + length - 3;
+    if (sentCRC[0] != static_cast<char>(0x40 | (crc >> 12)) ||
+        sentCRC[1] != static_cast<char>(0x40 | ((crc >> 6) & 0x3F)) ||
+        sentCRC[2] != static_cast<char>(0x40 | (crc & 0x3F))) {
+        return false;
+    }
+    length -= 3;
+    response[length] = '\0';
+    return true;
+}
+
+
+// This parses the next value out of a data response without any allocation
+bool SDI12Sensors::parseValue(const char*& next, float& value) {
+    // Skip anything up to the start of the next value
+    while (*next != '\0' && *next != '+' && *next != '-' && *next != '.' &&
+           !isdigit(*next)) {
+        next++;
+    }
+    if (*next == '\0') return false;
+
+    bool negative = *next == '-';
+    if (*next == '+' || *next == '-') next++;
+
+    // Collect the digits as an integer and count the places after the decimal
+    int32_t mantissa   = 0;
+    int8_t  exponent   = 0;
+    bool    gotDigit   = false;
+    bool    gotDecimal = false;
+    while (isdigit(*next) || (*next == '.' && !gotDecimal)) {
+        if (*next == '.') {
+            gotDecimal = true;
+        } else if (mantissa < 100000000L) {
+            mantissa = mantissa * 10 + (*next - '0');
+            if (gotDecimal) exponent--;
+            gotDigit = true;
+        } else if (!gotDecimal) {
+            // More digits than fit; keep the magnitude
+            exponent++;
+        }
+        next++;
+    }
+
+    if (!gotDigit) {
+        value = -9999;
+        return true;
+    }
+    value = mantissa;
+    for (; exponent < 0; exponent++) value /= 10;
+    for (; exponent > 0; exponent--) value *= 10;
+    if (negative) value = -value;
+    return true;
+}
+
+
 #ifndef MS_SDI12_NON_CONCURRENT
 bool SDI12Sensors::addSingleMeasurementResult(void) {
     bool success = false;
@@ -476,9 +779,6 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
 bool SDI12Sensors::addSingleMeasurementResult(void) {
     bool success = false;
 
-    String startCommand;
-    String sdiResponse;
-
     // MS_DBG(F("   Activating SDI-12 instance for"),
     //        getSensorNameAndLocation());
     // Check if this the currently active SDI-12 Object
@@ -494,47 +794,64 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
     // Empty the buffer
     _SDI12Internal.clearBuffer();
 
-    MS_DBG(F("  Beginning concurrent measurement on"),
-           getSensorNameAndLocation());
-    startCommand = "";
-    startCommand += _SDI12address;
-    startCommand +=
-        "M!";  // Start concurrent measurement - format  [address]['C'][!]
-    _SDI12Internal.sendCommand(startCommand);
-    delay(30);  // It just needs this little delay
-    MS_DBG(F("    >>>"), startCommand);
-
-    // wait for acknowlegement with format
-    // [address][ttt (3 char, seconds)][number of values to be returned,
-    // 0-9]<CR><LF>
-    sdiResponse = _SDI12Internal.readStringUntil('\n');
-    sdiResponse.trim();
-    _SDI12Internal.clearBuffer();
-    MS_DBG(F("    <<<"), sdiResponse);
+    // Find out how long we have to wait (in seconds); there's no wait for
+    // continuous measurements
+    uint8_t wait = 0;
+    char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
 
-    // find out how long we have to wait (in seconds).
-    uint8_t wait = sdiResponse.substring(1, 4).toInt();
-
-    // Verify the number of results the sensor will send
-    uint8_t numVariables = sdiResponse.substring(4).toInt();
-    if (numVariables != _numReturnedValues) {
-        PRINTOUT(numVariables, F("results expected"),
-                 F("This differs from the sensor's standard design of"),
-                 _numReturnedValues, F("measurements!!"));
-    }
-
-    // Set the times we've activated the sensor and asked for a measurement
-    if (sdiResponse.length() > 0) {
-        MS_DBG(F("    NON-concurrent measurement started."));
-        // Update the time that a measurement was requested
+    if (_useContinuous) {
+        MS_DBG(F("  Using continuous measurements on"),
+               getSensorNameAndLocation());
         _millisMeasurementRequested = millis();
-        // Set the status bit for measurement start success (bit 6)
         _sensorStatus |= 0b01000000;
     } else {
-        MS_DBG(getSensorNameAndLocation(),
-               F("did not respond to measurement request!"));
-        _millisMeasurementRequested = 0;
-        _sensorStatus &= 0b10111111;
+        MS_DBG(F("  Beginning non-concurrent measurement on"),
+               getSensorNameAndLocation());
+        // Start a standard measurement - format  [address]['M'][!], or
+        // [address]['M']['C'][!] to get CRC's on the data
+        char startCommand[5] = {_SDI12address, 'M', '!', '\0', '\0'};
+        if (_useCRC) {
+            startCommand[2] = 'C';
+            startCommand[3] = '!';
+        }
+        _SDI12Internal.sendCommand(startCommand);
+        MS_DBG(F("    >>>"), startCommand);
+
+        // wait for acknowlegement with format
+        // [address][ttt (3 char, seconds)][number of values to be returned,
+        // 0-9]<CR><LF>
+        uint8_t length = readResponse(sdiResponse, sizeof(sdiResponse));
+        _SDI12Internal.clearBuffer();
+        MS_DBG(F("    <<<"), sdiResponse);
+
+        // Read the wait from the ttt of the response
+        for (uint8_t i = 1; i < 4 && i < length; i++) {
+            if (isdigit(sdiResponse[i])) {
+                wait = wait * 10 + sdiResponse[i] - '0';
+            }
+        }
+
+        // Verify the number of results the sensor will send
+        uint8_t numVariables = length > 4 ? atoi(sdiResponse + 4) : 0;
+        if (numVariables != _numReturnedValues) {
+            PRINTOUT(numVariables, F("results expected"),
+                     F("This differs from the sensor's standard design of"),
+                     _numReturnedValues, F("measurements!!"));
+        }
+
+        // Set the time we've asked for a measurement
+        if (length > 0) {
+            MS_DBG(F("    NON-concurrent measurement started."));
+            // Update the time that a measurement was requested
+            _millisMeasurementRequested = millis();
+            // Set the status bit for measurement start success (bit 6)
+            _sensorStatus |= 0b01000000;
+        } else {
+            MS_DBG(getSensorNameAndLocation(),
+                   F("did not respond to measurement request!"));
+            _millisMeasurementRequested = 0;
+            _sensorStatus &= 0b10111111;
+        }
     }
 
     // Check a measurement was *successfully* started (status bit 6 set)
@@ -549,13 +866,13 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
             if (_SDI12Internal.available())  // sensor can interrupt us to let
                                              // us know it is done early
             {
-                MS_DBG(F("    <<<"), _SDI12Internal.readStringUntil('\n'));
-                _SDI12Internal.clearBuffer();
+                // Read the service request, [address]<CR><LF>
+                readResponse(sdiResponse, sizeof(sdiResponse));
+                MS_DBG(F("    <<<"), sdiResponse);
                 break;
             }
         }
-        // Wait for anything else and clear it out
-        delay(30);
+        // Clear out anything else
         _SDI12Internal.clearBuffer();
 
         // get the results
@@ -48,6 +48,10 @@
  * SDI12 sensor, no interrupts (or tips) will be registered during SDI12
  * communication.
  *
+ * For a sensor that supports the SDI-12 continuous measurement commands (aR0!
+ * to aR9!), SDI12Sensors::setContinuousMode() collects values with them
+ * instead of starting a measurement and waiting for it.
+ *
  * @section sdi12_group_flags Build flags
  * - `-D MS_SDI12_NON_CONCURRENT`
  *    - Instructs *all* SDI-12 sensors to take non-concurrent measurements
@@ -57,6 +61,9 @@
  *    - This may be necessary if your sensor uses a version of the SDI-12
  * protocol prior to 1.2 or if your sensor is not properly compliant with the
  * protocol.
+ * - `-D MS_SDI12_CRC_RETRIES=x`
+ *    - The number of times to ask again for a block of data that fails its
+ * CRC check, for sensors set to use CRC's with SDI12Sensors::setCRCMode()
  *
  */
 /* clang-format on */
@@ -86,6 +93,188 @@
 // SDI12_EXTERNAL_PCINT Unfortunately, that is not compatible with the Arduino
 // IDE
 
+/**
+ * @brief The time to send one character over SDI-12 in microseconds.
+ *
+ * SDI-12 runs at 1200 baud with 7 data bits, even parity and 1 stop bit, so
+ * each character takes 10 bits.
+ */
+#define SDI12_CHARACTER_TIME_US 8333
+/**
+ * @brief The longest gap between the characters of a response before the
+ * response is treated as finished, in milliseconds; three character times.
+ *
+ * The SDI-12 specification allows no more than 1.66ms of marking between
+ * characters, so a longer gap means the sensor has stopped sending.
+ */
+#define SDI12_CHARACTER_GAP_MS (3 * SDI12_CHARACTER_TIME_US / 1000)
+/**
+ * @brief The size of the buffer for a single response line.
+ *
+ * This fits the longest response to a data command: the address, 75
+ * characters of values, a 3 character CRC, and the terminating null.
+ */
+#define SDI12_RESPONSE_BUFFER_SIZE 80
+/**
+ * @brief The time to wait for a sensor to start its response to a command, in
+ * milliseconds.
+ *
+ * This is 10 times that specified by the SDI-12 protocol for a sensor
+ * response.
+ */
+#define SDI12_RESPONSE_TIMEOUT_MS 150
+/**
+ * @brief The time to wait for a sensor to start its response to a data
+ * command, in milliseconds.
+ *
+ * Some sensors are slow to return data, so this is longer than for other
+ * commands.
+ */
+#define SDI12_DATA_TIMEOUT_MS 1500
+
+#ifndef MS_SDI12_ACKNOWLEDGE_RETRIES
+/**
+ * @brief The number of times to send the 'acknowledge active' command to a
+ * sensor before giving up on it.
+ */
+#define MS_SDI12_ACKNOWLEDGE_RETRIES 5
+#endif
+
+#ifndef MS_SDI12_CRC_RETRIES
+/**
+ * @brief The number of times to ask again for a block of data that fails its
+ * CRC check.
+ */
+#define MS_SDI12_CRC_RETRIES 3
+#endif
+
+/**
+ * @anchor sensor_sdi12_crc_failures
+ * @name CRC Failures
+ * The diagnostic count of blocks of data from an SDI-12 sensor that failed
+ * their CRC check
+ *
+ * {{ @ref SDI12Sensors_CRCFailures::SDI12Sensors_CRCFailures }}
+ */
+/**@{*/
+/// Diagnostic number; the CRC failure count is diagnostic 0.
+#define SDI12_CRC_FAILURES_DIAG_NUM 0
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "counter"
+#define SDI12_CRC_FAILURES_VAR_NAME "counter"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "count"
+#define SDI12_CRC_FAILURES_UNIT_NAME "count"
+/// @brief Default variable short code; "SDI12CRCFailures"
+#define SDI12_CRC_FAILURES_DEFAULT_CODE "SDI12CRCFailures"
+/// @brief Decimals places in string representation; a count has 0.
+#define SDI12_CRC_FAILURES_RESOLUTION 0
+/**@}*/
+
+#ifndef MS_SDI12_PRESENCE_TIMEOUT_MS
+/**
+ * @brief How long a response from a sensor is trusted as proof that the
+ * sensor is present, in milliseconds.
+ *
+ * Within this time of any good response, the 'acknowledge active' command is
+ * skipped.  A sensor is forgotten as soon as its power is cut, so this only
+ * applies while a sensor stays powered.
+ */
+#define MS_SDI12_PRESENCE_TIMEOUT_MS 10000L
+#endif
+
+#ifndef MS_SDI12_BUS_MAX_SENSORS
+/**
+ * @brief The number of sensor addresses each SDI-12 bus keeps presence
+ * information for.
+ */
+#define MS_SDI12_BUS_MAX_SENSORS 8
+#endif
+
+/**
+ * @brief A single SDI-12 data line shared by any number of sensors.
+ *
+ * There is one bus for each data pin, created the first time a sensor on that
+ * pin asks for it.  The bus owns the only SDI-12 interface for the pin, so
+ * sensors on the same pin never fight over which instance is active, and
+ * remembers which sensor addresses have recently answered.
+ *
+ * @ingroup sdi12_group
+ */
+class SDI12Bus {
+ public:
+    /**
+     * @brief Get the bus for a data pin, creating it if needed.
+     *
+     * @param dataPin The pin on the mcu connected to the data line of the
+     * SDI-12 circuit.
+     * @return **SDI12Bus\*** The bus on that pin
+     */
+    static SDI12Bus* getBus(int8_t dataPin);
+
+    /**
+     * @brief Get the SDI-12 interface for the bus.
+     *
+     * @return **SDI12&** The interface
+     */
+    SDI12& getInterface(void);
+
+    /**
+     * @brief Record that a sensor gave a good response.
+     *
+     * @param address The SDI-12 address of the sensor
+     */
+    void markPresent(char address);
+    /**
+     * @brief Forget that a sensor responded.
+     *
+     * @param address The SDI-12 address of the sensor
+     */
+    void markAbsent(char address);
+    /**
+     * @brief Check if a sensor has given a good response within the last
+     * #MS_SDI12_PRESENCE_TIMEOUT_MS.
+     *
+     * @param address The SDI-12 address of the sensor
+     * @return **bool** True if the sensor recently responded
+     */
+    bool isPresent(char address);
+
+ protected:
+    /**
+     * @brief Construct a new SDI-12 bus
+     *
+     * @param dataPin The data pin of the bus
+     */
+    explicit SDI12Bus(int8_t dataPin);
+
+    /**
+     * @brief The SDI-12 interface on the data pin
+     */
+    SDI12 _interface;
+    /**
+     * @brief The data pin of the bus
+     */
+    int8_t _dataPin;
+    /**
+     * @brief The addresses of the sensors that have responded on the bus
+     */
+    char _addresses[MS_SDI12_BUS_MAX_SENSORS];
+    /**
+     * @brief The millis() of the last good response from each address
+     */
+    uint32_t _lastResponse[MS_SDI12_BUS_MAX_SENSORS];
+    /**
+     * @brief The next bus in the list of all busses
+     */
+    SDI12Bus* _nextBus;
+    /**
+     * @brief The first bus in the list of all busses
+     */
+    static SDI12Bus* _firstBus;
+};
+
 /**
  * @brief The main class for SDI-12 Sensors
  */
@@ -176,6 +365,68 @@ class SDI12Sensors : public Sensor {
      * itself.
      */
     String getSensorSerialNumber(void);
+
+    /**
+     * @brief Set whether to ask the sensor for CRC's on its data.
+     *
+     * With CRC's on, measurements are started with the aCC! or aMC! commands
+     * and every block of data is checked against its CRC before any values are
+     * taken from it.  A block that fails is asked for again, up to
+     * #MS_SDI12_CRC_RETRIES times, without starting a new measurement.
+     *
+     * @note CRC's were added in version 1.3 of the SDI-12 protocol; only turn
+     * this on for sensors that support them.
+     *
+     * @param useCRC True to ask for and check CRC's
+     */
+    void setCRCMode(bool useCRC);
+    /**
+     * @brief Check whether CRC's are being used for this sensor.
+     *
+     * @return **bool** True if CRC's are asked for and checked
+     */
+    bool getCRCMode(void);
+    /**
+     * @brief Get the number of blocks of data that have failed their CRC
+     * check since the sensor was created.
+     *
+     * Only responses that carry a CRC that doesn't match are counted; a
+     * sensor that doesn't answer at all is not.  To log this as a diagnostic,
+     * create an SDI12Sensors_CRCFailures variable for the sensor.
+     *
+     * @return **uint16_t** The number of failed CRC checks
+     */
+    uint16_t getCRCFailureCount(void);
+    /**
+     * @copydoc Sensor::getDiagnosticValue(uint8_t diagnosticNumber)
+     *
+     * SDI-12 sensors report the number of failed CRC checks as diagnostic
+     * #SDI12_CRC_FAILURES_DIAG_NUM.
+     */
+    float getDiagnosticValue(uint8_t diagnosticNumber) override;
+
+    /**
+     * @brief Set whether to take continuous measurements from the sensor.
+     *
+     * Sensors that support continuous measurements return fresh values to the
+     * aRn! command straight away.  With this on, no measurement is started
+     * and the values are collected with aR0! - aR9! (or aRC0! - aRC9! with
+     * CRC's) in place of aD0! - aD9!, so each averaged sample takes
+     * milliseconds instead of the full measurement time.
+     *
+     * @note Only turn this on for sensors that document support for
+     * continuous measurements; many sensors only return old or no values to
+     * aRn!.
+     *
+     * @param useContinuous True to use continuous measurements
+     */
+    void setContinuousMode(bool useContinuous);
+    /**
+     * @brief Check whether continuous measurements are used for this sensor.
+     *
+     * @return **bool** True if values are taken with aRn!
+     */
+    bool getContinuousMode(void);
     /**
      * @copydoc Sensor::getSensorLocation()
      *
@@ -199,6 +450,15 @@ class SDI12Sensors : public Sensor {
      */
     bool setup(void) override;
 
+    /**
+     * @copydoc Sensor::powerDown()
+     *
+     * If the power is really cut, this also makes the bus forget that the
+     * sensor recently responded, so the presence check is only ever skipped
+     * for a sensor that has stayed powered since its last response.
+     */
+    void powerDown(void) override;
+
 // Only need this for concurrent measurements.
 // NOTE:  By default, concurrent measurements are used!
 #ifndef MS_SDI12_NON_CONCURRENT
@@ -214,6 +474,14 @@ class SDI12Sensors : public Sensor {
      * successfully.
      */
     bool startSingleMeasurement(void) override;
+    /**
+     * @copydoc Sensor::isMeasurementComplete(bool debug)
+     *
+     * For concurrent measurements, this uses the time the sensor gave in its
+     * reply to the start measurement command rather than the standard
+     * measurement time, when the sensor gave one.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
 #endif
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
@@ -245,9 +513,102 @@ class SDI12Sensors : public Sensor {
      */
     bool getResults();
     /**
-     * @brief Internal reference to the SDI-12 object.
+     * @brief Read a single response line from the sensor.
+     *
+     * This waits up to the timeout for the response to start and then reads
+     * until the line ends (the <LF>), the sensor stops sending for
+     * #SDI12_CHARACTER_GAP_MS, or the time it would take to send a full
+     * buffer has passed.  The <CR><LF> are not kept, and any characters that
+     * don't fit in the buffer are dropped.
+     *
+     * @param buffer The buffer to read into; it is always null terminated.
+     * @param bufferSize The size of the buffer
+     * @param timeout_ms The time to wait for the response to start
+     * @return **uint8_t** The number of characters read into the buffer
+     */
+    uint8_t readResponse(char* buffer, uint8_t bufferSize,
+                         uint32_t timeout_ms = SDI12_RESPONSE_TIMEOUT_MS);
+    /**
+     * @brief Ask the sensor for one block of data and read the response.
+     *
+     * When CRC's are on, the CRC is checked and removed, and a block that
+     * fails its check is asked for again up to #MS_SDI12_CRC_RETRIES times.
+     * A sensor that doesn't respond is not asked again.  The SDI-12 interface
+     * must already be active.
+     *
+     * @param block The block of data to collect (0-9)
+     * @param response The buffer to read the response into; it is always null
+     * terminated and starts with the address of the sensor that responded.
+     * @param responseSize The size of the buffer
+     * @return **uint8_t** The number of characters in the response, or 0 if
+     * there was no response or no response passed its CRC check.
+     */
+    uint8_t requestDataBlock(uint8_t block, char* response,
+                             uint8_t responseSize);
+    /**
+     * @brief Parse the next value out of a data response.
+     *
+     * SDI-12 values are a sign followed by up to 7 digits and an optional
+     * decimal point, ie "+1.234" or "-56".  Any characters before the next
+     * value are skipped.
+     *
+     * @param next A pointer into the response; it is moved past the value.
+     * @param value The parsed value; -9999 if the sensor sent a sign without
+     * any digits.
+     * @return **bool** True if a value was found, false at the end of the
+     * response.
+     */
+    static bool parseValue(const char*& next, float& value);
+    /**
+     * @brief Check the CRC at the end of a response and remove it.
+     *
+     * The SDI-12 CRC is a CRC-16 (polynomial 0xA001, initial value 0) of the
+     * address and values, sent as 3 characters of 6 bits each, OR'd with
+     * 0x40.
+     *
+     * @param response The response, with the <CR><LF> already removed
+     * @param length The length of the response; this is shortened by 3 if the
+     * CRC matches.
+     * @return **bool** True if the CRC matches
+     */
+    static bool checkCRC(char* response, uint8_t& length);
+    /**
+     * @brief Build the command to collect a block of data from the sensor.
+     *
+     * This is [address][D][block][!] after a measurement, or
+     * [address][R][block][!] for continuous measurements, with a C after the D
+     * or R when using CRC's.
+     *
+     * @param command A buffer of at least 6 characters for the command
+     * @param block The block of data to collect (0-9)
+     */
+    void buildDataCommand(char* command, uint8_t block);
+    /**
+     * @brief Internal reference to the SDI-12 bus the sensor is on.
+     */
+    SDI12Bus* _SDI12Bus;
+    /**
+     * @brief Internal reference to the SDI-12 object; this is shared with
+     * every other sensor on the same bus.
+     */
+    SDI12& _SDI12Internal;
+    /**
+     * @brief The time the sensor said its current concurrent measurement
+     * would take, in milliseconds, or -1 if it didn't say.
+     */
+    int32_t _measurementWait_ms;
+    /**
+     * @brief True if the sensor should be asked for CRC's on its data.
      */
-    SDI12 _SDI12Internal;
+    bool _useCRC;
+    /**
+     * @brief True if values should be taken with continuous measurements.
+     */
+    bool _useContinuous;
+    /**
+     * @brief The number of blocks of data that have failed their CRC check.
+     */
+    uint16_t _crcFailures;
     /**
      * @brief Internal reference to the SDI-12 address.
      */
@@ -260,4 +621,42 @@ class SDI12Sensors : public Sensor {
     String _sensorSerialNumber;
 };
 
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [number of failed CRC checks](@ref sensor_sdi12_crc_failures) from any
+ * SDI-12 sensor.
+ *
+ * This is a diagnostic; it counts up from when the sensor was created and is
+ * only ever non-zero for sensors using CRC's.
+ *
+ * @ingroup sdi12_group
+ */
+/* clang-format on */
+class SDI12Sensors_CRCFailures : public Variable {
+ public:
+    /**
+     * @brief Construct a new SDI12Sensors_CRCFailures object.
+     *
+     * @param parentSense The parent SDI12Sensors providing the diagnostic.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SDI12CRCFailures".
+     */
+    explicit SDI12Sensors_CRCFailures(
+        SDI12Sensors* parentSense, const char* uuid = "",
+        const char* varCode = SDI12_CRC_FAILURES_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)SDI12_CRC_FAILURES_DIAG_NUM,
+                   SENSOR_DIAGNOSTIC, (uint8_t)SDI12_CRC_FAILURES_RESOLUTION,
+                   SDI12_CRC_FAILURES_VAR_NAME, SDI12_CRC_FAILURES_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Destroy the SDI12Sensors_CRCFailures object - no action needed.
+     */
+    ~SDI12Sensors_CRCFailures() {}
+};
+
 #endif  // SRC_SENSORS_SDI12SENSORS_H_
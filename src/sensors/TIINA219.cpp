@@ -10,22 +10,39 @@
 
 #include "TIINA219.h"
 
+// The INA219 profiling the logger, if any
+TIINA219* TIINA219::_profiler = NULL;
+
+#if !defined(MS_INA219_NO_YIELD)
+// Arduino's delay() calls yield() while it waits, and so do the modem and
+// SDI-12 libraries; the core's own yield() does nothing.  This is the only
+// place a profile can take samples in the middle of a phase without the
+// logger calling it; I2C can't be used from a timer interrupt.
+void yield(void) {
+    TIINA219::profileSample();
+}
+#endif
+
 // The constructors
 TIINA219::TIINA219(TwoWire* theI2C, int8_t powerPin, uint8_t i2cAddressHex,
                    uint8_t measurementsToAverage)
     : Sensor("TIINA219", INA219_NUM_VARIABLES, INA219_WARM_UP_TIME_MS,
              INA219_STABILIZATION_TIME_MS, INA219_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage) {
-    _i2cAddressHex = i2cAddressHex;
-    _i2c           = theI2C;
+    _i2cAddressHex   = i2cAddressHex;
+    _i2c             = theI2C;
+    _sleepCurrent_mA = -9999;
+    resetProfile();
 }
 TIINA219::TIINA219(int8_t powerPin, uint8_t i2cAddressHex,
                    uint8_t measurementsToAverage)
     : Sensor("TIINA219", INA219_NUM_VARIABLES, INA219_WARM_UP_TIME_MS,
              INA219_STABILIZATION_TIME_MS, INA219_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage) {
-    _i2cAddressHex = i2cAddressHex;
-    _i2c           = &Wire;
+    _i2cAddressHex   = i2cAddressHex;
+    _i2c             = &Wire;
+    _sleepCurrent_mA = -9999;
+    resetProfile();
 }
 // Destructor
 TIINA219::~TIINA219() {}
@@ -66,6 +83,8 @@ bool TIINA219::wake(void) {
     // Begin/Init needs to be rerun after every power-up to set the calibration
     // coefficient for the INA219 (see p21 of datasheet)
     ina219_phy.begin(_i2c);
+    // That also resets the conversion settings
+    if (_profiler == this) configureProfiling();
 
     return true;
 }
@@ -85,12 +104,16 @@ bool TIINA219::addSingleMeasurementResult(void) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         // Read values
+        I2CBus* bus = I2CBus::getBus(_i2c);
+        bus->beginTransaction(_i2cAddressHex);
         current_mA = ina219_phy.getCurrent_mA();
         if (isnan(current_mA)) current_mA = -9999;
         busV_V = ina219_phy.getBusVoltage_V();
         if (isnan(busV_V)) busV_V = -9999;
         power_mW = ina219_phy.getPower_mW();
         if (isnan(power_mW)) power_mW = -9999;
+        // The library doesn't report a failure to answer
+        bus->endTransaction();
 
         success = true;
 
@@ -113,3 +136,170 @@ bool TIINA219::addSingleMeasurementResult(void) {
 
     return success;
 }
+
+
+void TIINA219::beginProfiling(void) {
+    MS_DBG(F("Profiling logger power with"), getSensorNameAndLocation());
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->begin();
+    bus->beginTransaction(_i2cAddressHex);
+    ina219_phy.begin(_i2c);
+    bus->endTransaction();
+    if (!configureProfiling()) {
+        MS_DBG(F("Unable to set the conversions of"),
+               getSensorNameAndLocation());
+    }
+    resetProfile();
+    _profiler = this;
+    LoggerClock::setPhaseCallback(profilePhase);
+}
+
+
+void TIINA219::endProfiling(void) {
+    if (_profiler != this) return;
+    _profiler = NULL;
+    LoggerClock::setPhaseCallback(NULL);
+}
+
+
+bool TIINA219::configureProfiling(void) {
+    // The shunt ADC setting for averaging 2^n 12 bit conversions is 0b1nnn;
+    // for a single 12 bit conversion it's 0b0011
+    uint16_t shuntADC = 0x0018;
+    uint8_t  n        = 0;
+    while (n < 7 && (1 << (n + 1)) <= MS_INA219_PROFILE_SAMPLES) n++;
+    if (n > 0) shuntADC = 0x0040 | (n << 3);
+
+    // 32 V bus range and a /8 gain as set by the library, a single 9 bit bus
+    // conversion, and continuous shunt and bus conversions
+    uint16_t config = 0x2000 | 0x1800 | shuntADC | 0x0007;
+
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->beginTransaction(_i2cAddressHex);
+    _i2c->beginTransmission(_i2cAddressHex);
+    _i2c->write(0x00);  // the configuration register
+    _i2c->write(static_cast<uint8_t>(config >> 8));
+    _i2c->write(static_cast<uint8_t>(config & 0xFF));
+    bool acknowledged = _i2c->endTransmission() == 0;
+    bus->endTransaction(acknowledged);
+    return acknowledged;
+}
+
+
+void TIINA219::setSleepCurrent(float sleepCurrent_mA) {
+    _sleepCurrent_mA = sleepCurrent_mA;
+}
+
+
+float TIINA219::readProfileCurrent(void) {
+    I2CBus* bus = I2CBus::getBus(_i2c);
+    bus->beginTransaction(_i2cAddressHex);
+    float current_mA = ina219_phy.getCurrent_mA();
+    bus->endTransaction();
+    if (isnan(current_mA)) current_mA = -9999;
+    return current_mA;
+}
+
+
+void TIINA219::sampleProfile(void) {
+    // Nothing can be read while the logger sleeps; a sample now would be
+    // an awake one
+    if (_profilePhase == LOGGER_PHASE_SLEEP) return;
+    _lastSampleMillis = millis();
+    float current_mA  = readProfileCurrent();
+    if (current_mA == -9999) return;
+    _phaseCurrentSum += current_mA;
+    _phaseSamples++;
+}
+
+
+void TIINA219::profileSample(void) {
+    if (_profiler == NULL) return;
+    if (millis() - _profiler->_lastSampleMillis <
+        MS_INA219_PROFILE_INTERVAL_MS)
+        return;
+    // This may be called in the middle of another driver's transaction, or
+    // of this one's own read
+    if (I2CBus::getBus(_profiler->_i2c)->inTransaction()) return;
+    _profiler->sampleProfile();
+}
+
+
+void TIINA219::profilePhase(uint8_t phase, uint32_t lastPhaseTime_ms) {
+    if (_profiler == NULL) return;
+    TIINA219* p    = _profiler;
+    uint8_t   last = p->_profilePhase;
+
+    // The reading averages the time just before it, so it closes the phase
+    // being left.  The logger is awake at both ends of the sleep phase, so
+    // the reading isn't added to it.
+    p->_lastSampleMillis = millis();
+    float current_mA     = p->readProfileCurrent();
+    if (current_mA != -9999 && last != LOGGER_PHASE_SLEEP) {
+        p->_phaseCurrentSum += current_mA;
+        p->_phaseSamples++;
+    }
+
+    if (last < MS_INA219_MAX_PHASES) {
+        p->_phaseTime_ms[last] += lastPhaseTime_ms;
+        float mean_mA = -9999;
+        if (last == LOGGER_PHASE_SLEEP) {
+            mean_mA = p->_sleepCurrent_mA;
+        } else if (p->_phaseSamples > 0) {
+            mean_mA = p->_phaseCurrentSum / p->_phaseSamples;
+        }
+        if (mean_mA != -9999) {
+            // mA * ms / (3600000 ms/h) = mAh
+            p->_phaseCharge_mAh[last] += mean_mA * lastPhaseTime_ms /
+                3600000.0;
+            MS_DBG(F("Phase"), last, F("took"), lastPhaseTime_ms,
+                   F("ms at a mean of"), mean_mA, F("mA"));
+        } else {
+            MS_DBG(F("Phase"), last, F("took"), lastPhaseTime_ms,
+                   F("ms with no current to charge it"));
+        }
+    }
+
+    p->_profilePhase    = phase;
+    p->_phaseCurrentSum = 0;
+    p->_phaseSamples    = 0;
+}
+
+
+float TIINA219::getPhaseCharge(uint8_t phase) {
+    if (phase >= MS_INA219_MAX_PHASES) return -9999;
+    return _phaseCharge_mAh[phase];
+}
+uint32_t TIINA219::getPhaseTime(uint8_t phase) {
+    if (phase >= MS_INA219_MAX_PHASES) return 0;
+    return _phaseTime_ms[phase];
+}
+
+
+void TIINA219::printProfile(Stream* stream) {
+    float total_mAh = 0;
+    stream->println(F("Phase, Time (ms), Charge (mAh)"));
+    for (uint8_t i = 0; i < MS_INA219_MAX_PHASES; i++) {
+        if (_phaseTime_ms[i] == 0) continue;
+        stream->print(i);
+        stream->print(F(", "));
+        stream->print(_phaseTime_ms[i]);
+        stream->print(F(", "));
+        stream->println(_phaseCharge_mAh[i], 4);
+        total_mAh += _phaseCharge_mAh[i];
+    }
+    stream->print(F("Total charge (mAh): "));
+    stream->println(total_mAh, 4);
+}
+
+
+void TIINA219::resetProfile(void) {
+    for (uint8_t i = 0; i < MS_INA219_MAX_PHASES; i++) {
+        _phaseCharge_mAh[i] = 0;
+        _phaseTime_ms[i]    = 0;
+    }
+    _profilePhase    = 0;
+    _phaseCurrentSum  = 0;
+    _phaseSamples     = 0;
+    _lastSampleMillis = 0;
+}
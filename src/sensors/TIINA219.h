@@ -45,6 +45,12 @@
  * https://learn.adafruit.com/adafruit-ina219-current-sensor-breakout and
  * http://www.ti.com/product/INA219
  *
+ * @section sensor_ina219_flags Build flags
+ * - `-D MS_INA219_NO_YIELD`
+ *      - keeps the TIINA219 from defining `yield()`, for sketches or other
+ * libraries that define their own.  A power profile then only gets samples at
+ * the changes of phase and from TIINA219::sampleProfile().
+ *
  * @section sensor_ina219_ctor Sensor Constructor
  * {{ @ref TIINA219::TIINA219(int8_t, uint8_t, uint8_t) }}
  * {{ @ref TIINA219::TIINA219(TwoWire*, int8_t, uint8_t, uint8_t) }}
@@ -73,6 +79,8 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "I2CBus.h"
+#include "LoggerClock.h"
 #include <Adafruit_INA219.h>
 
 // Sensor Specific Defines
@@ -108,6 +116,32 @@
 #define INA219_MEASUREMENT_TIME_MS 1100
 /**@}*/
 
+#ifndef MS_INA219_MAX_PHASES
+/**
+ * @brief The number of phases an INA219 power profile keeps totals for; enough
+ * for all of the phases of a logging cycle (#LOGGER_NUM_PHASES).
+ */
+#define MS_INA219_MAX_PHASES 8
+#endif
+#ifndef MS_INA219_PROFILE_INTERVAL_MS
+/**
+ * @brief The shortest time between the current samples an INA219 power
+ * profile takes from yield().
+ */
+#define MS_INA219_PROFILE_INTERVAL_MS 100
+#endif
+#ifndef MS_INA219_PROFILE_SAMPLES
+/**
+ * @brief The number of back to back shunt conversions the INA219 averages for
+ * each current reading while it profiles; 1, 2, 4, 8, 16, 32, 64, or 128.
+ *
+ * Each conversion takes 532 µs, the fastest the INA219 converts at full
+ * resolution, so the default of 128 makes each reading the mean current over
+ * the last 68 ms.
+ */
+#define MS_INA219_PROFILE_SAMPLES 128
+#endif
+
 /**
  * @anchor sensor_ina219_current
  * @name Current
@@ -278,7 +312,150 @@ class TIINA219 : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Start using this INA219 to profile the power used by the logger
+     * in each phase of its logging cycle.
+     *
+     * The INA219 must be on the logger's own supply rail and continuously
+     * powered.  This gives profilePhase() to LoggerClock::setPhaseCallback(),
+     * so the logger reports each change of phase.  Only one INA219 can
+     * profile at a time; starting another stops this one.
+     *
+     * The INA219 is set to convert continuously and to average
+     * #MS_INA219_PROFILE_SAMPLES shunt conversions in each reading, so a
+     * reading covers the time before it rather than a single instant.  A
+     * reading is taken to close each phase, and more are taken from yield()
+     * at most every #MS_INA219_PROFILE_INTERVAL_MS.  Arduino's delay() calls
+     * yield(), as do the modem and SDI-12 libraries while they wait, so the
+     * long waits of a logging cycle are sampled without any call from the
+     * logger.  Readings are skipped while another device's I2C transaction is
+     * in progress.  The charge used in a phase is the mean of the samples in
+     * it times its duration.
+     *
+     * No samples can be taken while the logger sleeps, so the sleep phase
+     * only gets time unless a sleep current is given with setSleepCurrent().
+     */
+    void beginProfiling(void);
+    /**
+     * @brief Stop profiling with this INA219.  The totals are kept.
+     */
+    void endProfiling(void);
+    /**
+     * @brief Take a current sample for the phase the logger is in.
+     *
+     * Call this from the sketch during long phases to improve the estimate.
+     * Samples are ignored in the sleep phase.
+     */
+    void sampleProfile(void);
+    /**
+     * @brief Take a current sample with the profiling INA219, if there is
+     * one, if at least #MS_INA219_PROFILE_INTERVAL_MS have passed since the
+     * last one and the I2C bus is free.
+     *
+     * This is called from yield(), unless #MS_INA219_NO_YIELD is defined.
+     */
+    static void profileSample(void);
+    /**
+     * @brief Set the current the logger draws while asleep, to charge the
+     * sleep phase with.
+     *
+     * The MCU and I2C bus are off during sleep, so the INA219 can't be read.
+     * Measure the sleep current separately, e.g. with a meter, and set it
+     * here.  Until it is set, the sleep phase gets time but no charge.
+     *
+     * @param sleepCurrent_mA The sleep current in mA, or -9999 to charge
+     * nothing for sleep.
+     */
+    void setSleepCurrent(float sleepCurrent_mA);
+    /**
+     * @brief Tell the profiling INA219, if there is one, about a change of
+     * phase.
+     *
+     * This matches #loggerPhaseCallback and is given to
+     * LoggerClock::setPhaseCallback() by beginProfiling().
+     *
+     * @param phase The phase being entered
+     * @param lastPhaseTime_ms The time spent in the phase being left
+     */
+    static void profilePhase(uint8_t phase, uint32_t lastPhaseTime_ms);
+    /**
+     * @brief Get the charge used in a phase since the profile was reset.
+     *
+     * @param phase The phase
+     * @return **float** The charge in milliamp hours
+     */
+    float getPhaseCharge(uint8_t phase);
+    /**
+     * @brief Get the time spent in a phase since the profile was reset.
+     *
+     * @param phase The phase
+     * @return **uint32_t** The time in milliseconds
+     */
+    uint32_t getPhaseTime(uint8_t phase);
+    /**
+     * @brief Print the time and charge of each phase of the profile.
+     *
+     * The sleep phase has no charge unless setSleepCurrent() was called.
+     *
+     * @param stream The stream to print to
+     */
+    void printProfile(Stream* stream);
+    /**
+     * @brief Clear the times and charges of all phases.
+     */
+    void resetProfile(void);
+
  private:
+    /**
+     * @brief Read the current for the power profile.
+     *
+     * @return **float** The current in mA, or -9999 if it couldn't be read.
+     */
+    float readProfileCurrent(void);
+    /**
+     * @brief Set the INA219 to convert continuously and average
+     * #MS_INA219_PROFILE_SAMPLES shunt conversions.
+     *
+     * The range and gain are left as the Adafruit library sets them, and the
+     * bus voltage gets a single fast conversion.
+     *
+     * @return **bool** True if the INA219 acknowledged the new settings.
+     */
+    bool configureProfiling(void);
+    /**
+     * @brief The INA219 profiling the logger's power use, if any.
+     */
+    static TIINA219* _profiler;
+    /**
+     * @brief The phase the profile is in.
+     */
+    uint8_t _profilePhase;
+    /**
+     * @brief The sum of the current samples in the phase the profile is in.
+     */
+    float _phaseCurrentSum;
+    /**
+     * @brief The number of current samples in the phase the profile is in.
+     */
+    uint16_t _phaseSamples;
+    /**
+     * @brief The processor millis of the last sample taken by
+     * profileSample().
+     */
+    uint32_t _lastSampleMillis;
+    /**
+     * @brief The current to charge the sleep phase with, in mA, or -9999 for
+     * none.
+     */
+    float _sleepCurrent_mA;
+    /**
+     * @brief The charge used in each phase, in mAh.
+     */
+    float _phaseCharge_mAh[MS_INA219_MAX_PHASES];
+    /**
+     * @brief The time spent in each phase, in ms.
+     */
+    uint32_t _phaseTime_ms[MS_INA219_MAX_PHASES];
     /**
      * @brief Private reference to the internal INA219 object.
      */
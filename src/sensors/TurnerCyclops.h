@@ -9,7 +9,7 @@
  *
  * These are used for the Turner Scientific Cyclops-7F.
  *
- * This depends on the soligen2010 fork of the Adafruit ADS1015 library.
+ * The ADS1x15 is shared with any other analog sensors by the ADS1X15Manager.
  */
 /* clang-format off */
 /**
@@ -140,6 +140,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "sensors/ADS1X15Manager.h"
 
 // Sensor Specific Defines
 /** @ingroup sensor_cyclops */
@@ -253,7 +254,7 @@
  * @ingroup sensor_cyclops
  */
 /* clang-format on */
-class TurnerCyclops : public Sensor {
+class TurnerCyclops : public ADS1X15Sensor {
  public:
     // The constructor - need the power pin, the ADS1X15 data channel, and the
     // calibration info
@@ -314,20 +315,13 @@ class TurnerCyclops : public Sensor {
      */
     ~TurnerCyclops();
 
-    /**
-     * @copydoc Sensor::getSensorLocation()
-     */
-    String getSensorLocation(void) override;
-
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
-    uint8_t _adsChannel;
     float   _conc_std, _volt_std, _volt_blank;
-    uint8_t _i2cAddress;
 };
 
 
@@ -8,6 +8,7 @@
  */
 
 #include "YosemitechParent.h"
+#include "LoggerClock.h"
 
 // The constructor - need the sensor type, modbus address, power pin, stream for
 // data, and number of readings to average
@@ -19,7 +20,12 @@ YosemitechParent::YosemitechParent(
     : Sensor(sensName, numVariables, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, -1, measurementsToAverage),
       _ysensor(), _model(model), _modbusAddress(modbusAddress), _stream(stream),
-      _RS485EnablePin(enablePin), _powerPin2(powerPin2) {}
+      _RS485EnablePin(enablePin), _powerPin2(powerPin2),
+      _modbusBus(ModbusBus::getBus(stream)), _brushInterval(1),
+      _wakesSinceBrush(0), _brushPeriod_s(0), _lastBrushEpoch(0),
+      _brushDrift(0), _brushedValue(-9999), _lastValue(-9999),
+      _brushedThisWake(false),
+      _unbrushedStabilization_ms(stabilizationTime_ms) {}
 YosemitechParent::YosemitechParent(
     byte modbusAddress, Stream& stream, int8_t powerPin, int8_t powerPin2,
     int8_t enablePin, uint8_t measurementsToAverage, yosemitechModel model,
@@ -28,7 +34,12 @@ YosemitechParent::YosemitechParent(
     : Sensor(sensName, numVariables, warmUpTime_ms, stabilizationTime_ms,
              measurementTime_ms, powerPin, -1, measurementsToAverage),
       _ysensor(), _model(model), _modbusAddress(modbusAddress),
-      _stream(&stream), _RS485EnablePin(enablePin), _powerPin2(powerPin2) {}
+      _stream(&stream), _RS485EnablePin(enablePin), _powerPin2(powerPin2),
+      _modbusBus(ModbusBus::getBus(&stream)), _brushInterval(1),
+      _wakesSinceBrush(0), _brushPeriod_s(0), _lastBrushEpoch(0),
+      _brushDrift(0), _brushedValue(-9999), _lastValue(-9999),
+      _brushedThisWake(false),
+      _unbrushedStabilization_ms(stabilizationTime_ms) {}
 // Destructor
 YosemitechParent::~YosemitechParent() {}
 
@@ -75,7 +86,9 @@ bool YosemitechParent::wake(void) {
     MS_DBG(F("Start Measurement on"), getSensorNameAndLocation());
     while (!success && ntries < 5) {
         MS_DBG('(', ntries + 1, F("):"));
+        _modbusBus->beginTransaction();
         success = _ysensor.startMeasurement();
+        _modbusBus->endTransaction(success);
         ntries++;
     }
 
@@ -91,21 +104,106 @@ bool YosemitechParent::wake(void) {
         _sensorStatus &= 0b11101111;
     }
 
-    // Manually activate the brush
-    // Needed for newer sensors that do not immediate activate on getting power
-    if (_model == Y511 || _model == Y514 || _model == Y550 || _model == Y4000) {
-        MS_DBG(F("Activate Brush on"), getSensorNameAndLocation());
-        if (_ysensor.activateBrush()) {
-            MS_DBG(F("Brush activated."));
-        } else {
-            MS_DBG(F("Brush NOT activated!"));
-        }
-    }
+    // The brush itself is run by runMaintenance(), which the variable array
+    // calls right after this while the other sensors are warming up
+    _brushedThisWake = false;
+    if (success && hasBrush()) _wakesSinceBrush++;
 
     return success;
 }
 
 
+// Manually activate the brush when it's due
+// Needed for newer sensors that do not immediate activate on getting power
+bool YosemitechParent::runMaintenance(void) {
+    if (!hasBrush() || !bitRead(_sensorStatus, 4)) return false;
+
+    bool due = _brushInterval > 0 && _wakesSinceBrush >= _brushInterval;
+    if (_brushPeriod_s > 0 &&
+        (_lastBrushEpoch == 0 ||
+         LoggerClock::getEpoch() - _lastBrushEpoch >= _brushPeriod_s)) {
+        MS_DBG(F("Brush period has passed on"), getSensorNameAndLocation());
+        due = true;
+    }
+    if (_brushDrift > 0 && _brushedValue != -9999 && _lastValue != -9999 &&
+        fabs(_lastValue - _brushedValue) > _brushDrift) {
+        MS_DBG(getSensorNameAndLocation(), F("has drifted from"),
+               _brushedValue, F("to"), _lastValue);
+        due = true;
+    }
+    if (!due) {
+        MS_DBG(F("Brush not due on"), getSensorNameAndLocation());
+        return false;
+    }
+    _brushedThisWake = brush();
+    return _brushedThisWake;
+}
+
+
+// The brush policy
+void YosemitechParent::setBrushInterval(uint8_t everyNCycles) {
+    _brushInterval = everyNCycles;
+}
+void YosemitechParent::setBrushPeriod(uint32_t period_s) {
+    _brushPeriod_s = period_s;
+}
+void YosemitechParent::setBrushDrift(float drift) {
+    _brushDrift = drift;
+}
+void YosemitechParent::setUnbrushedStabilization(
+    uint32_t stabilizationTime_ms) {
+    _unbrushedStabilization_ms = stabilizationTime_ms;
+}
+
+
+bool YosemitechParent::hasBrush(void) {
+    return _model == Y511 || _model == Y514 || _model == Y550 ||
+        _model == Y4000;
+}
+
+
+bool YosemitechParent::brush(void) {
+    if (!hasBrush()) return false;
+
+    MS_DBG(F("Activate Brush on"), getSensorNameAndLocation());
+    _modbusBus->beginTransaction();
+    bool brushed = _ysensor.activateBrush();
+    _modbusBus->endTransaction(brushed);
+    if (brushed) {
+        MS_DBG(F("Brush activated."));
+        _wakesSinceBrush = 0;
+        _lastBrushEpoch  = LoggerClock::getEpoch();
+        // The next good reading is the new clean reference for drift
+        _brushedValue = -9999;
+        _lastValue    = -9999;
+    } else {
+        MS_DBG(F("Brush NOT activated!"));
+    }
+    return brushed;
+}
+
+
+// A sensor that wasn't brushed on this wake may need less time to stabilize
+bool YosemitechParent::isStable(bool debug) {
+    if (_brushedThisWake || !hasBrush() ||
+        _unbrushedStabilization_ms >= _stabilizationTime_ms) {
+        return Sensor::isStable(debug);
+    }
+    if (!bitRead(_sensorStatus, 4)) return Sensor::isStable(debug);
+
+    uint32_t elapsed_since_wake_up = millis() - _millisSensorActivated;
+    if (elapsed_since_wake_up > _unbrushedStabilization_ms) {
+        if (debug) {
+            MS_DBG(F("It's been"), (elapsed_since_wake_up), F("ms, and"),
+                   getSensorNameAndLocation(),
+                   F("should be stable without brushing!"));
+        }
+        return true;
+    }
+    return false;
+}
+
+
 // The function to put the sensor to sleep
 // Different from the standard in that it stops measurements
 bool YosemitechParent::sleep(void) {
@@ -121,7 +219,9 @@ bool YosemitechParent::sleep(void) {
     MS_DBG(F("Stop Measurement on"), getSensorNameAndLocation());
     while (!success && ntries < 5) {
         MS_DBG('(', ntries + 1, F("):"));
+        _modbusBus->beginTransaction();
         success = _ysensor.stopMeasurement();
+        _modbusBus->endTransaction(success);
         ntries++;
     }
     if (success) {
@@ -214,8 +314,10 @@ bool YosemitechParent::addSingleMeasurementResult(void) {
 
                 // Get Values
                 MS_DBG(F("Get Values from"), getSensorNameAndLocation());
+                _modbusBus->beginTransaction();
                 success = _ysensor.getValues(DOmgL, Turbidity, Cond, pH, Temp,
                                              ORP, Chlorophyll, BGA);
+                _modbusBus->endTransaction(success);
 
                 // Fix not-a-number values
                 if (!success || isnan(DOmgL)) DOmgL = -9999;
@@ -244,6 +346,9 @@ bool YosemitechParent::addSingleMeasurementResult(void) {
                 verifyAndAddMeasurementResult(6, Chlorophyll);
                 verifyAndAddMeasurementResult(7, BGA);
 
+                // Watch the turbidity for drift
+                if (Turbidity != -9999) _lastValue = Turbidity;
+
                 break;
             }
             default: {
@@ -254,7 +359,9 @@ bool YosemitechParent::addSingleMeasurementResult(void) {
 
                 // Get Values
                 MS_DBG(F("Get Values from"), getSensorNameAndLocation());
+                _modbusBus->beginTransaction();
                 success = _ysensor.getValues(parmValue, tempValue, thirdValue);
+                _modbusBus->endTransaction(success);
 
                 // Fix not-a-number values
                 if (!success || isnan(parmValue)) parmValue = -9999;
@@ -276,8 +383,13 @@ bool YosemitechParent::addSingleMeasurementResult(void) {
                 verifyAndAddMeasurementResult(0, parmValue);
                 verifyAndAddMeasurementResult(1, tempValue);
                 verifyAndAddMeasurementResult(2, thirdValue);
+
+                // Watch the main parameter for drift
+                if (parmValue != -9999) _lastValue = parmValue;
             }
         }
+        // The first good reading after a brush is the reference for drift
+        if (_brushedValue == -9999) _brushedValue = _lastValue;
     } else {
         MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
     }
@@ -93,7 +93,17 @@
  *
  * By default, this library cuts power to the sensors between readings, causing them to lose track of their brushing interval.
  * The library manually activates the brushes as part of the "wake" command.
- * There are currently no other ways to set the brushing interval in this library.
+ * The brush is run by YosemitechParent::runMaintenance(), which the variable array calls as soon as the sensor is awake so the brush runs while the other sensors are still warming up.
+ * By default the brush runs on every wake.
+ * To save time and wear, YosemitechParent::setBrushInterval() can limit brushing to every Nth wake.
+ * YosemitechParent::setBrushPeriod() can instead, or also, brush whenever a set time has passed on the logger clock, which doesn't depend on the logging interval.
+ * YosemitechParent::setBrushDrift() can also start a brush early if readings have drifted since the last brush.
+ * YosemitechParent::setUnbrushedStabilization() then sets a shorter stabilization time for the wakes that skip the brush.
+ * A brush can also be started at any time with YosemitechParent::brush(), for example while other sensors are warming up.
+ *
+ * All of the Modbus sensors on the same stream share a ModbusBus, which keeps the quiet time between their frames and counts how many requests succeed or fail, and how long they take.
+ * Modbus RTU only allows one request on the line at a time, so the requests still go out one after another; the bus doesn't queue them.
+ * Get it with `ModbusBus::getBus(&modbusSerial)` to check those counts.
  *
  * The lower level details of the communication with the sensors is managed by the
  * [EnviroDIY Yosemitech library](https://github.com/EnviroDIY/YosemitechModbus)
@@ -122,6 +132,7 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "sensors/ModbusBus.h"
 #include <YosemitechModbus.h>
 
 /* clang-format off */
@@ -217,6 +228,17 @@ class YosemitechParent : public Sensor {
      * @return **bool** True if the wake function completed successfully.
      */
     bool wake(void) override;
+    /**
+     * @brief Run the brush or wiper if it's due.
+     *
+     * The brush is due when the number of wakes set with setBrushInterval()
+     * or the time set with setBrushPeriod() has passed since the last brush,
+     * or the readings have drifted by more than the amount set with
+     * setBrushDrift().  The sensor must be awake.
+     *
+     * @return **bool** True if the brush was run.
+     */
+    bool runMaintenance(void) override;
     /**
      * @brief Puts the sensor to sleep, if necessary.
      *
@@ -231,6 +253,72 @@ class YosemitechParent : public Sensor {
     void powerUp(void) override;
     void powerDown(void) override;
 
+    /**
+     * @brief Check if the sensor is stable.
+     *
+     * This uses the stabilization time set with setUnbrushedStabilization()
+     * if the brush didn't run when the sensor was woken.
+     *
+     * @param debug True to output the result to the debugging Serial
+     * @return **bool** True if the stabilization time has passed.
+     */
+    bool isStable(bool debug = false) override;
+
+    /**
+     * @brief Set how often the brush or wiper runs when the sensor is woken.
+     *
+     * This only applies to models with a brush (Y511, Y514, Y550, Y4000).
+     *
+     * @param everyNCycles Brush on every Nth wake; 1 (the default) brushes
+     * every time and 0 only brushes when triggered by drift or by brush().
+     */
+    void setBrushInterval(uint8_t everyNCycles);
+    /**
+     * @brief Set a time after which the brush or wiper runs on the next
+     * wake, whatever the number of wakes.
+     *
+     * The time is kept with the logger clock (LoggerClock::getEpoch()),
+     * so it isn't thrown off by the processor sleeping or by a change to the
+     * logging interval.  The first wake after a restart always brushes when a
+     * period is set.
+     *
+     * @param period_s The time between brushes, in seconds; 0 (the default)
+     * turns off the time trigger.
+     */
+    void setBrushPeriod(uint32_t period_s);
+    /**
+     * @brief Set a drift in readings that will trigger a brush on the next
+     * wake.
+     *
+     * The reading watched is the first value returned by the sensor, or the
+     * turbidity for the Y4000.  It is compared with the first good reading
+     * after the last brush.
+     *
+     * @param drift The change in the reading that triggers a brush, in the
+     * units the sensor reports; 0 (the default) turns off the drift trigger.
+     */
+    void setBrushDrift(float drift);
+    /**
+     * @brief Set the stabilization time to use on wakes that skip the brush.
+     *
+     * The stabilization times for the brushed sensors include the time for
+     * the brush to run.  When brushing isn't done on every wake, a shorter
+     * time can be given for the other wakes.
+     *
+     * @param stabilizationTime_ms The stabilization time in ms when the brush
+     * doesn't run; defaults to the full stabilization time of the sensor.
+     */
+    void setUnbrushedStabilization(uint32_t stabilizationTime_ms);
+    /**
+     * @brief Run the brush or wiper now.
+     *
+     * The sensor must be powered and awake.  This resets the count of wakes
+     * and the time since the last brush.
+     *
+     * @return **bool** True if the sensor accepted the command.
+     */
+    bool brush(void);
+
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -243,6 +331,24 @@ class YosemitechParent : public Sensor {
     Stream*         _stream;
     int8_t          _RS485EnablePin;
     int8_t          _powerPin2;
+    ModbusBus*      _modbusBus;
+
+    /**
+     * @brief Check whether the model has a brush or wiper.
+     *
+     * @return **bool** True if the model can be brushed
+     */
+    bool hasBrush(void);
+
+    uint8_t  _brushInterval;
+    uint8_t  _wakesSinceBrush;
+    uint32_t _brushPeriod_s;
+    uint32_t _lastBrushEpoch;
+    float    _brushDrift;
+    float    _brushedValue;
+    float    _lastValue;
+    bool     _brushedThisWake;
+    uint32_t _unbrushedStabilization_ms;
 };
 
 #endif  // SRC_SENSORS_YOSEMITECHPARENT_H_
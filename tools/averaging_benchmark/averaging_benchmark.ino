@@ -0,0 +1,104 @@
+/**
+ * @file averaging_benchmark.ino
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ *
+ * @brief Times each of the averaging modes of Sensor::reduceValues() on the
+ * board it is run on.
+ *
+ * Each mode is run over many sets of spiky made-up readings, for several
+ * numbers of readings, and the mean time per reduction is printed in
+ * microseconds and in processor cycles.
+ *
+ * The library must be built with `MS_ROBUST_AVERAGING` defined - and with
+ * `MS_MAX_AVERAGING_SAMPLES` at least as large as the biggest count below -
+ * for the modes to be available.  The platformio.ini in this folder does that.
+ */
+
+// ==========================================================================
+//  Include the libraries required for any data logger
+// ==========================================================================
+#include <Arduino.h>
+#include <SensorBase.h>
+
+#ifndef MS_ROBUST_AVERAGING
+#error The library must be built with MS_ROBUST_AVERAGING defined
+#endif
+
+
+// ==========================================================================
+//  Benchmark Settings
+// ==========================================================================
+// The numbers of readings to reduce
+const uint8_t readingCounts[] = {3, 5, 10, 20};
+// The number of reductions to time for each mode and count
+const uint16_t numberRepeats = 200;
+// One in this many readings is a spike
+const uint8_t spikeEvery = 7;
+
+
+// ==========================================================================
+//  Benchmark Helpers
+// ==========================================================================
+const char* modeNames[] = {"mean", "median", "trimmed mean", "spike rejected"};
+
+// Fill the array with readings around 100 with an occasional large spike
+void makeReadings(float* readings, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        readings[i] = 100 + random(-50, 50) / 10.0;
+        if (random(spikeEvery) == 0) { readings[i] += 1000; }
+    }
+}
+
+
+// ==========================================================================
+//  Arduino Setup Function
+// ==========================================================================
+void setup() {
+    Serial.begin(115200);
+    delay(50);
+    Serial.println(F("Averaging mode benchmark"));
+    Serial.print(F("Processor clock: "));
+    Serial.print(F_CPU / 1000000L);
+    Serial.println(F(" MHz"));
+    Serial.println(F("\nmode, readings, us per reduction, cycles per reduction"));
+
+    float readings[MS_MAX_AVERAGING_SAMPLES];
+    float sink = 0;
+
+    for (uint8_t m = MEAN_AVERAGE; m <= SPIKE_REJECTED_AVERAGE; m++) {
+        for (uint8_t c = 0; c < sizeof(readingCounts); c++) {
+            uint8_t count = readingCounts[c];
+            if (count > MS_MAX_AVERAGING_SAMPLES) continue;
+
+            uint32_t total = 0;
+            for (uint16_t r = 0; r < numberRepeats; r++) {
+                // Start from fresh readings each time because the reduction
+                // sorts them in place
+                makeReadings(readings, count);
+                uint32_t start = micros();
+                sink += Sensor::reduceValues(readings, count,
+                                             static_cast<averagingMode>(m));
+                total += micros() - start;
+            }
+
+            float us = static_cast<float>(total) / numberRepeats;
+            Serial.print(modeNames[m]);
+            Serial.print(F(", "));
+            Serial.print(count);
+            Serial.print(F(", "));
+            Serial.print(us);
+            Serial.print(F(", "));
+            Serial.println(static_cast<uint32_t>(us * (F_CPU / 1000000L)));
+        }
+    }
+    // Print the sink so the reductions can't be optimized away
+    Serial.print(F("\nChecksum: "));
+    Serial.println(sink);
+}
+
+
+// ==========================================================================
+//  Arduino Loop Function
+// ==========================================================================
+void loop() {}
@@ -0,0 +1,149 @@
+/**
+ * @file iso8601_benchmark.ino
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ *
+ * @brief Checks and times the character buffer date/time formatters of the
+ * Logger against the original String based formatting.
+ *
+ * A run steps through several years of timestamps in a handful of time zones
+ * and compares the output of Logger::formatDateTime_ISO8601(epoch, buffer) and
+ * Logger::formatDateTime_CSV(epoch, buffer) with the String and
+ * DateTime::addToString() formatting the library used before.  Any mismatch
+ * is printed.  It then times a run of consecutive timestamps - as a logger
+ * would format them - with both.
+ */
+
+// ==========================================================================
+//  Include the libraries required for any data logger
+// ==========================================================================
+#include <Arduino.h>
+#include <LoggerBase.h>
+
+
+// ==========================================================================
+//  Benchmark Settings
+// ==========================================================================
+// The timestamp to start from - 2020-01-01 00:00:00
+const uint32_t startEpoch = 1577836800;
+// The spacing between checked timestamps, in seconds; an odd number of
+// seconds over a day walks through all of the hours and minutes
+const uint32_t checkStep = 90061;
+// The number of timestamps to check in each time zone
+const uint16_t numberChecks = 2000;
+// The number of consecutive timestamps to time
+const uint16_t numberTimed = 1000;
+// The time zones to check
+const int8_t timeZones[] = {0, -5, -10, -12, 1, 9, 10, 24};
+
+
+// ==========================================================================
+//  The original String based formatters
+// ==========================================================================
+String legacyISO8601(uint32_t epochTime) {
+    String dateTimeStr;
+    Logger::dtFromEpoch(epochTime).addToString(dateTimeStr);
+    dateTimeStr.replace(" ", "T");
+    int8_t tz       = Logger::getLoggerTimeZone();
+    String tzString = String(tz);
+    if (-24 <= tz && tz <= -10) {
+        tzString += F(":00");
+    } else if (-10 < tz && tz < 0) {
+        tzString = tzString.substring(0, 1) + '0' + tzString.substring(1, 2) +
+            F(":00");
+    } else if (tz == 0) {
+        tzString = 'Z';
+    } else if (0 < tz && tz < 10) {
+        tzString = "+0" + tzString + F(":00");
+    } else if (10 <= tz && tz <= 24) {
+        tzString = "+" + tzString + F(":00");
+    }
+    dateTimeStr += tzString;
+    return dateTimeStr;
+}
+
+String legacyCSV(uint32_t epochTime) {
+    String dateTimeStr;
+    Logger::dtFromEpoch(epochTime).addToString(dateTimeStr);
+    return dateTimeStr;
+}
+
+
+// ==========================================================================
+//  Arduino Setup Function
+// ==========================================================================
+void setup() {
+    Serial.begin(115200);
+    delay(50);
+    Serial.println(F("ISO8601 formatter check and benchmark"));
+
+    char     buffer[ISO8601_BUFFER_SIZE];
+    uint32_t mismatches = 0;
+    uint32_t checked    = 0;
+
+    for (uint8_t z = 0; z < sizeof(timeZones); z++) {
+        Logger::setLoggerTimeZone(timeZones[z]);
+        uint32_t epoch = startEpoch;
+        for (uint16_t i = 0; i < numberChecks; i++) {
+            Logger::formatDateTime_ISO8601(epoch, buffer);
+            String expected = legacyISO8601(epoch);
+            if (!expected.equals(buffer)) {
+                mismatches++;
+                Serial.print(F("ISO8601 mismatch at "));
+                Serial.print(epoch);
+                Serial.print(F(": "));
+                Serial.print(expected);
+                Serial.print(F(" vs "));
+                Serial.println(buffer);
+            }
+            Logger::formatDateTime_CSV(epoch, buffer);
+            expected = legacyCSV(epoch);
+            if (!expected.equals(buffer)) {
+                mismatches++;
+                Serial.print(F("CSV mismatch at "));
+                Serial.print(epoch);
+                Serial.print(F(": "));
+                Serial.print(expected);
+                Serial.print(F(" vs "));
+                Serial.println(buffer);
+            }
+            checked += 2;
+            epoch += checkStep;
+        }
+    }
+    Serial.print(checked);
+    Serial.print(F(" timestamps checked, "));
+    Serial.print(mismatches);
+    Serial.println(F(" mismatches"));
+
+    Logger::setLoggerTimeZone(-5);
+    uint32_t sink  = 0;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < numberTimed; i++) {
+        sink += legacyISO8601(startEpoch + i).length();
+    }
+    uint32_t legacyTime = micros() - start;
+
+    start = micros();
+    for (uint16_t i = 0; i < numberTimed; i++) {
+        Logger::formatDateTime_ISO8601(startEpoch + i, buffer);
+        sink += buffer[18];
+    }
+    uint32_t bufferTime = micros() - start;
+
+    Serial.print(F("String formatter: "));
+    Serial.print(static_cast<float>(legacyTime) / numberTimed);
+    Serial.println(F(" us per timestamp"));
+    Serial.print(F("Buffer formatter: "));
+    Serial.print(static_cast<float>(bufferTime) / numberTimed);
+    Serial.println(F(" us per timestamp"));
+    // Print the sink so the loops can't be optimized away
+    Serial.print(F("Checksum: "));
+    Serial.println(sink);
+}
+
+
+// ==========================================================================
+//  Arduino Loop Function
+// ==========================================================================
+void loop() {}
@@ -0,0 +1,426 @@
+/**
+ * @file ModemEmulator.cpp
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ *
+ * @brief Implements the ModemEmulator class.
+ */
+
+#include "ModemEmulator.h"
+#include <stdio.h>
+
+// The IP address handed out when a data context is active
+#define MODEM_EMULATOR_IP "10.1.2.3"
+
+
+ModemEmulator::ModemEmulator(modemDialect dialect) {
+    _dialect         = dialect;
+    _latency_ms      = 20;
+    _boot_ms         = 3000;
+    _registration_ms = 8000;
+    _connect_ms      = 1500;
+    _rssi            = -75;
+    _dropRate        = 0;
+    _errorRate       = 0;
+    _numScripted     = 0;
+    _commandCount    = 0;
+    _failedCount     = 0;
+    powerCycle();
+}
+ModemEmulator::~ModemEmulator() {}
+
+
+void ModemEmulator::setResponseLatency(uint32_t latency_ms) {
+    _latency_ms = latency_ms;
+}
+void ModemEmulator::setBootTime(uint32_t boot_ms) {
+    _boot_ms = boot_ms;
+}
+void ModemEmulator::setRegistrationTime(uint32_t registration_ms) {
+    _registration_ms = registration_ms;
+}
+void ModemEmulator::setConnectTime(uint32_t connect_ms) {
+    _connect_ms = connect_ms;
+}
+void ModemEmulator::setSignalStrength(int16_t rssi) {
+    _rssi = rssi;
+}
+void ModemEmulator::setDropRate(uint8_t percent) {
+    _dropRate = percent;
+}
+void ModemEmulator::setErrorRate(uint8_t percent) {
+    _errorRate = percent;
+}
+
+
+bool ModemEmulator::addResponse(const char* cmdPrefix, const char* response,
+                                uint32_t extraLatency_ms) {
+    if (_numScripted >= MODEM_EMULATOR_MAX_SCRIPTED) return false;
+    _scripted[_numScripted].prefix          = cmdPrefix;
+    _scripted[_numScripted].response        = response;
+    _scripted[_numScripted].extraLatency_ms = extraLatency_ms;
+    _numScripted++;
+    return true;
+}
+
+
+void ModemEmulator::powerCycle(void) {
+    _bootStart       = millis();
+    _poweredDown     = false;
+    _commandMode     = false;
+    _contextActive   = false;
+    _rxLength        = 0;
+    _txHead          = 0;
+    _txLength        = 0;
+    _txReadyAt       = 0;
+    _extraLatency_ms = 0;
+}
+
+
+uint16_t ModemEmulator::getCommandCount(void) {
+    return _commandCount;
+}
+uint16_t ModemEmulator::getFailedCount(void) {
+    return _failedCount;
+}
+void ModemEmulator::resetCounts(void) {
+    _commandCount = 0;
+    _failedCount  = 0;
+}
+
+
+int ModemEmulator::available(void) {
+    if (_txLength == 0) return 0;
+    // Nothing is visible until the response latency has passed
+    if (static_cast<int32_t>(millis() - _txReadyAt) < 0) return 0;
+    return _txLength;
+}
+
+
+int ModemEmulator::read(void) {
+    if (!available()) return -1;
+    char c = _txBuffer[_txHead++];
+    if (--_txLength == 0) _txHead = 0;
+    return static_cast<uint8_t>(c);
+}
+
+
+int ModemEmulator::peek(void) {
+    if (!available()) return -1;
+    return static_cast<uint8_t>(_txBuffer[_txHead]);
+}
+
+
+size_t ModemEmulator::write(uint8_t c) {
+    if (c == '\r' || c == '\n') {
+        if (_rxLength > 0) {
+            _rxBuffer[_rxLength] = '\0';
+            _rxLength            = 0;
+            handleCommand(_rxBuffer);
+        }
+        return 1;
+    }
+    if (_rxLength < MODEM_EMULATOR_RX_BUFFER - 1) {
+        _rxBuffer[_rxLength++] = c;
+    }
+    // The XBee enters command mode on a bare "+++" with no line ending
+    if (_dialect == XBEE && !_commandMode && _rxLength == 3 &&
+        strncmp(_rxBuffer, "+++", 3) == 0) {
+        _rxLength = 0;
+        if (isBooted()) {
+            _commandMode     = true;
+            _extraLatency_ms = 0;
+            queue("OK\r");
+        }
+    }
+    return 1;
+}
+
+
+void ModemEmulator::flush(void) {}
+
+
+void ModemEmulator::handleCommand(const char* cmd) {
+    // Anything that isn't an AT command is treated as payload and swallowed
+    if (!startsWith(cmd, "AT") && !startsWith(cmd, "at")) return;
+    // The XBee only listens for AT commands while in command mode
+    if (_dialect == XBEE && !_commandMode) return;
+
+    _commandCount++;
+
+    // A powered down module doesn't answer; the first command it hears stands
+    // in for the wake pulse and starts it booting
+    if (_poweredDown) {
+        _poweredDown = false;
+        _bootStart   = millis();
+        _failedCount++;
+        return;
+    }
+    if (!isBooted()) {
+        _failedCount++;
+        return;
+    }
+
+    // Nothing from the last command's latency carries over to this one
+    _extraLatency_ms = 0;
+
+    // Failure injection
+    uint8_t roll = random(100);
+    if (roll < _dropRate) {
+        _failedCount++;
+        return;
+    }
+    if (roll < _dropRate + _errorRate) {
+        _failedCount++;
+        queueLine("ERROR");
+        return;
+    }
+
+    const char* body = cmd + 2;
+
+    for (uint8_t i = 0; i < _numScripted; i++) {
+        if (startsWith(body, _scripted[i].prefix)) {
+            _extraLatency_ms = _scripted[i].extraLatency_ms;
+            if (_scripted[i].response != NULL) {
+                queueLine(_scripted[i].response);
+            }
+            queueOK();
+            return;
+        }
+    }
+
+    if (!handleDialect(body)) queueOK();
+}
+
+
+bool ModemEmulator::handleDialect(const char* cmd) {
+    char buf[72];
+
+    if (_dialect == XBEE) {
+        if (startsWith(cmd, "CN")) {
+            queueOK();
+            _commandMode = false;
+        } else if (startsWith(cmd, "AI")) {
+            // 0 = connected to the internet, 0x23 = still registering
+            queueLine(isRegistered() ? "0" : "23");
+        } else if (startsWith(cmd, "DB")) {
+            snprintf(buf, sizeof(buf), "%X", -_rssi);
+            queueLine(buf);
+        } else if (startsWith(cmd, "MY")) {
+            queueLine(isRegistered() ? MODEM_EMULATOR_IP : "0.0.0.0");
+        } else if (startsWith(cmd, "HS")) {
+            queueLine("4B");
+        } else if (startsWith(cmd, "TP")) {
+            queueLine("19");
+        } else if (startsWith(cmd, "%V")) {
+            queueLine("CE4");
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    if (_dialect == ESP8266) {
+        if (startsWith(cmd, "+CWJAP=") || startsWith(cmd, "+CWJAP_CUR=") ||
+            startsWith(cmd, "+CWJAP_DEF=")) {
+            _extraLatency_ms = _connect_ms;
+            if (isRegistered()) {
+                _contextActive = true;
+                queueLine("WIFI CONNECTED");
+                queueLine("WIFI GOT IP");
+                queueOK();
+            } else {
+                queueLine("+CWJAP:3");
+                queueLine("FAIL");
+            }
+        } else if (startsWith(cmd, "+CWJAP?") ||
+                   startsWith(cmd, "+CWJAP_CUR?")) {
+            if (isConnected()) {
+                snprintf(buf, sizeof(buf),
+                         "+CWJAP_CUR:\"emulated\",\"02:00:00:00:00:00\",6,%d",
+                         _rssi);
+                queueLine(buf);
+            } else {
+                queueLine("No AP");
+            }
+            queueOK();
+        } else if (startsWith(cmd, "+CIPSTATUS")) {
+            queueLine(isConnected() ? "STATUS:2" : "STATUS:5");
+            queueOK();
+        } else if (startsWith(cmd, "+CIFSR")) {
+            queueLine("+CIFSR:STAIP,\"" MODEM_EMULATOR_IP "\"");
+            queueOK();
+        } else if (startsWith(cmd, "+CWQAP")) {
+            _contextActive = false;
+            queueOK();
+        } else if (startsWith(cmd, "+GMR")) {
+            queueLine("AT version:1.7.4.0");
+            queueLine("SDK version:3.0.4");
+            queueOK();
+        } else if (startsWith(cmd, "+GSLP") || startsWith(cmd, "+RST")) {
+            queueOK();
+            _poweredDown   = true;
+            _contextActive = false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // SIM7000 and BG96 share the 3GPP command set
+    if (startsWith(cmd, "+CSQ")) {
+        int16_t csq = (_rssi + 113) / 2;
+        if (csq < 0) csq = 0;
+        if (csq > 31) csq = 31;
+        snprintf(buf, sizeof(buf), "+CSQ: %d,99", csq);
+        queueLine(buf);
+        queueOK();
+    } else if (startsWith(cmd, "+CPIN?")) {
+        queueLine("+CPIN: READY");
+        queueOK();
+    } else if (startsWith(cmd, "+CREG?") || startsWith(cmd, "+CGREG?") ||
+               startsWith(cmd, "+CEREG?")) {
+        // Echo the command name back as the response prefix
+        uint8_t len = strchr(cmd, '?') - cmd;
+        snprintf(buf, sizeof(buf), "%.*s: 0,%d", len, cmd,
+                 isRegistered() ? 1 : 2);
+        queueLine(buf);
+        queueOK();
+    } else if (startsWith(cmd, "+CGATT?")) {
+        queueLine(isRegistered() ? "+CGATT: 1" : "+CGATT: 0");
+        queueOK();
+    } else if (startsWith(cmd, "+CFUN?")) {
+        queueLine("+CFUN: 1");
+        queueOK();
+    } else if (startsWith(cmd, "+CBC")) {
+        queueLine("+CBC: 0,85,4012");
+        queueOK();
+    } else if (startsWith(cmd, "+CGPADDR")) {
+        queueLine(isConnected() ? "+CGPADDR: 1,\"" MODEM_EMULATOR_IP "\""
+                                : "+CGPADDR: 1,\"0.0.0.0\"");
+        queueOK();
+    } else if (startsWith(cmd, "+CIICR") || startsWith(cmd, "+CNACT=1") ||
+               startsWith(cmd, "+QIACT=") || startsWith(cmd, "+CGACT=1")) {
+        // Bringing up a data context blocks for the connection time
+        _extraLatency_ms = _connect_ms;
+        if (isRegistered()) {
+            _contextActive = true;
+            queueOK();
+        } else {
+            queueLine("ERROR");
+        }
+    } else if (startsWith(cmd, "+CIPSHUT") || startsWith(cmd, "+CNACT=0") ||
+               startsWith(cmd, "+QIDEACT") || startsWith(cmd, "+CGACT=0")) {
+        _contextActive = false;
+        queueLine(startsWith(cmd, "+CIPSHUT") ? "SHUT OK" : "OK");
+    } else if (startsWith(cmd, "+CIFSR")) {
+        // No trailing OK on the SIMCom local IP query
+        queueLine(isConnected() ? MODEM_EMULATOR_IP : "ERROR");
+    } else if (startsWith(cmd, "+CNACT?")) {
+        queueLine(isConnected() ? "+CNACT: 1,\"" MODEM_EMULATOR_IP "\""
+                                : "+CNACT: 0,\"0.0.0.0\"");
+        queueOK();
+    } else if (startsWith(cmd, "+QIACT?")) {
+        if (isConnected()) queueLine("+QIACT: 1,1,1,\"" MODEM_EMULATOR_IP "\"");
+        queueOK();
+    } else if (startsWith(cmd, "+CGACT?")) {
+        queueLine(isConnected() ? "+CGACT: 1,1" : "+CGACT: 1,0");
+        queueOK();
+    } else if (_dialect == SIM7000 && startsWith(cmd, "+GMM")) {
+        queueLine("SIMCOM_SIM7000A");
+        queueOK();
+    } else if (_dialect == SIM7000 && startsWith(cmd, "I")) {
+        queueLine("SIM7000A R1351");
+        queueOK();
+    } else if (_dialect == SIM7000 && startsWith(cmd, "+CPOWD")) {
+        queueLine("NORMAL POWER DOWN");
+        _poweredDown   = true;
+        _contextActive = false;
+    } else if (_dialect == BG96 && startsWith(cmd, "+GMM")) {
+        queueLine("BG96");
+        queueOK();
+    } else if (_dialect == BG96 && startsWith(cmd, "I")) {
+        queueLine("Quectel");
+        queueLine("BG96");
+        queueLine("Revision: BG96MAR02A07M1G");
+        queueOK();
+    } else if (_dialect == BG96 && startsWith(cmd, "+QTEMP")) {
+        queueLine("+QTEMP: 24,25,26");
+        queueOK();
+    } else if (_dialect == BG96 && startsWith(cmd, "+QPOWD")) {
+        queueOK();
+        queueLine("POWERED DOWN");
+        _poweredDown   = true;
+        _contextActive = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+void ModemEmulator::queue(const char* text) {
+    // New text can't be read before its own latency has passed, even if it
+    // joins text that is already waiting
+    uint32_t readyAt = millis() + _latency_ms + _extraLatency_ms;
+    if (_txLength == 0) {
+        _txHead    = 0;
+        _txReadyAt = readyAt;
+    } else {
+        if (_txHead > 0) {
+            memmove(_txBuffer, _txBuffer + _txHead, _txLength);
+            _txHead = 0;
+        }
+        if (static_cast<int32_t>(readyAt - _txReadyAt) > 0) {
+            _txReadyAt = readyAt;
+        }
+    }
+    size_t len = strlen(text);
+    if (len > static_cast<size_t>(MODEM_EMULATOR_TX_BUFFER - _txLength)) {
+        len = MODEM_EMULATOR_TX_BUFFER - _txLength;
+    }
+    memcpy(_txBuffer + _txLength, text, len);
+    _txLength += len;
+}
+
+
+void ModemEmulator::queueLine(const char* text) {
+    // The XBee terminates responses with a bare carriage return, everything
+    // else wraps them in CR/LF pairs
+    if (_dialect != XBEE) queue(lineEnd());
+    queue(text);
+    queue(lineEnd());
+}
+
+
+void ModemEmulator::queueOK(void) {
+    queueLine("OK");
+}
+
+
+bool ModemEmulator::isBooted(void) {
+    return !_poweredDown && millis() - _bootStart >= _boot_ms;
+}
+
+
+bool ModemEmulator::isRegistered(void) {
+    if (!isBooted() || _registration_ms == 0xFFFFFFFF) return false;
+    return millis() - _bootStart >= _boot_ms + _registration_ms;
+}
+
+
+bool ModemEmulator::isConnected(void) {
+    // The XBee manages its own data connection once registered
+    if (_dialect == XBEE) return isRegistered();
+    return _contextActive && isRegistered();
+}
+
+
+const char* ModemEmulator::lineEnd(void) {
+    return _dialect == XBEE ? "\r" : "\r\n";
+}
+
+
+bool ModemEmulator::startsWith(const char* str, const char* prefix) {
+    return strncmp(str, prefix, strlen(prefix)) == 0;
+}
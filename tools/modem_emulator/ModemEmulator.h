@@ -0,0 +1,220 @@
+/**
+ * @file ModemEmulator.h
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ *
+ * @brief Contains the ModemEmulator class - a scriptable Stream that answers
+ * AT commands the way a SIM7000, BG96, XBee, or ESP8266 would.
+ *
+ * The emulator is meant to stand in for the modem's serial port so that the
+ * wake, connection, and metadata sequences of a loggerModem can be timed and
+ * regression tested on a bare board without a SIM card, antenna, or module.
+ *
+ * All latencies are measured against millis() - the same clock the modem
+ * classes use for their own timeouts - so the timing reported by a run is the
+ * timing the real logger would see given the same module behavior.
+ */
+
+// Header Guards
+#ifndef TOOLS_MODEM_EMULATOR_MODEMEMULATOR_H_
+#define TOOLS_MODEM_EMULATOR_MODEMEMULATOR_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief The maximum length of a single command the emulator will buffer.
+ *
+ * Longer commands are truncated; the response is chosen from the prefix.
+ */
+#define MODEM_EMULATOR_RX_BUFFER 96
+/**
+ * @brief The maximum number of bytes of queued response text.
+ */
+#define MODEM_EMULATOR_TX_BUFFER 192
+/**
+ * @brief The maximum number of scripted responses that can be added with
+ * ModemEmulator::addResponse().
+ */
+#define MODEM_EMULATOR_MAX_SCRIPTED 8
+
+
+/**
+ * @brief A Stream that emulates the AT command interface of a modem.
+ *
+ * Commands are collected until a carriage return and then answered after the
+ * configured latency.  Commands the emulator doesn't know are answered with a
+ * plain `OK`, so the init sequences of TinyGSM pass through without needing
+ * every setting command to be listed.  Anything more specific can be scripted
+ * with addResponse().
+ *
+ * There are no pins to toggle, so power state is modeled on the serial line
+ * alone: after a power down command the emulator stops answering and the first
+ * command it hears afterwards starts the boot timer, exactly as if the wake
+ * pulse had been sent at that moment.
+ */
+class ModemEmulator : public Stream {
+ public:
+    /**
+     * @brief The AT command dialects the emulator can answer.
+     */
+    typedef enum {
+        SIM7000 = 0,  ///< SIMCom SIM7000 (LTE-M/NB-IoT)
+        BG96,         ///< Quectel BG96 (LTE-M/NB-IoT)
+        XBEE,         ///< Digi XBee in transparent/command mode
+        ESP8266       ///< Espressif ESP8266 AT firmware
+    } modemDialect;
+
+    /**
+     * @brief Construct a new Modem Emulator object
+     *
+     * @param dialect The AT command dialect to answer in.
+     */
+    explicit ModemEmulator(modemDialect dialect);
+    /**
+     * @brief Destroy the Modem Emulator object - no action needed
+     */
+    ~ModemEmulator();
+
+    /**
+     * @brief Set the time between the end of a command and the start of its
+     * response.
+     *
+     * @param latency_ms The response latency in milliseconds; default 20.
+     */
+    void setResponseLatency(uint32_t latency_ms);
+    /**
+     * @brief Set the time the emulated module takes to boot before it will
+     * answer any command.
+     *
+     * @param boot_ms The boot time in milliseconds; default 3000.
+     */
+    void setBootTime(uint32_t boot_ms);
+    /**
+     * @brief Set the time after boot before the emulated module reports that
+     * it is registered on the network (or joined to the access point).
+     *
+     * @param registration_ms The registration time in milliseconds; default
+     * 8000.  Set to 0xFFFFFFFF to never register.
+     */
+    void setRegistrationTime(uint32_t registration_ms);
+    /**
+     * @brief Set the time the emulated module takes to activate a data context
+     * (or to join an access point).
+     *
+     * @param connect_ms The connection time in milliseconds; default 1500.
+     */
+    void setConnectTime(uint32_t connect_ms);
+    /**
+     * @brief Set the signal strength that will be reported.
+     *
+     * @param rssi The received signal strength in dBm, between -113 and -51.
+     * It is converted to CSQ for the cellular dialects.
+     */
+    void setSignalStrength(int16_t rssi);
+    /**
+     * @brief Set the percent of commands that will never get a response.
+     *
+     * @param percent The percent (0-100) of commands to silently drop.
+     */
+    void setDropRate(uint8_t percent);
+    /**
+     * @brief Set the percent of commands that will be answered with `ERROR`.
+     *
+     * @param percent The percent (0-100) of commands to reject.
+     */
+    void setErrorRate(uint8_t percent);
+    /**
+     * @brief Script a response for any command starting with the given text.
+     *
+     * Scripted responses are checked before the dialect table.  The response
+     * text should not include the trailing `OK`; it is appended.
+     *
+     * @param cmdPrefix The start of the command, without the leading `AT`.
+     * @param response The response text; NULL for a bare `OK`.
+     * @param extraLatency_ms Additional latency on top of the response latency.
+     * @return **bool** True if there was room to add the response.
+     */
+    bool addResponse(const char* cmdPrefix, const char* response,
+                     uint32_t extraLatency_ms = 0);
+    /**
+     * @brief Re-start the emulated module from power off.
+     *
+     * This drops any data context and network registration and starts the boot
+     * timer.
+     */
+    void powerCycle(void);
+
+    /**
+     * @brief Get the number of commands received since the last reset of the
+     * statistics.
+     *
+     * @return **uint16_t** The number of complete commands received.
+     */
+    uint16_t getCommandCount(void);
+    /**
+     * @brief Get the number of commands that were dropped or rejected by
+     * failure injection or because the module was powered down.
+     *
+     * @return **uint16_t** The number of commands without a good answer.
+     */
+    uint16_t getFailedCount(void);
+    /**
+     * @brief Reset the command counters.
+     */
+    void resetCounts(void);
+
+    // Stream
+    int    available(void) override;
+    int    read(void) override;
+    int    peek(void) override;
+    size_t write(uint8_t c) override;
+    void   flush(void) override;
+
+ private:
+    void        handleCommand(const char* cmd);
+    bool        handleDialect(const char* cmd);
+    void        queue(const char* text);
+    void        queueLine(const char* text);
+    void        queueOK(void);
+    bool        isBooted(void);
+    bool        isRegistered(void);
+    bool        isConnected(void);
+    const char* lineEnd(void);
+    static bool startsWith(const char* str, const char* prefix);
+
+    modemDialect _dialect;
+
+    uint32_t _latency_ms;
+    uint32_t _boot_ms;
+    uint32_t _registration_ms;
+    uint32_t _connect_ms;
+    int16_t  _rssi;
+    uint8_t  _dropRate;
+    uint8_t  _errorRate;
+
+    uint32_t _bootStart;
+    bool     _poweredDown;
+    bool     _commandMode;
+    bool     _contextActive;
+
+    struct scriptedResponse {
+        const char* prefix;
+        const char* response;
+        uint32_t    extraLatency_ms;
+    };
+    scriptedResponse _scripted[MODEM_EMULATOR_MAX_SCRIPTED];
+    uint8_t          _numScripted;
+
+    char     _rxBuffer[MODEM_EMULATOR_RX_BUFFER];
+    uint8_t  _rxLength;
+    char     _txBuffer[MODEM_EMULATOR_TX_BUFFER];
+    uint8_t  _txHead;
+    uint8_t  _txLength;
+    uint32_t _txReadyAt;
+    uint32_t _extraLatency_ms;
+
+    uint16_t _commandCount;
+    uint16_t _failedCount;
+};
+
+#endif  // TOOLS_MODEM_EMULATOR_MODEMEMULATOR_H_
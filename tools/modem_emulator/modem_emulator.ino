@@ -0,0 +1,208 @@
+/**
+ * @file modem_emulator.ino
+ * @copyright 2020 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ *
+ * @brief Times the wake, connect, and metadata sequences of a loggerModem
+ * against an emulated module.
+ *
+ * The modem object is handed a ModemEmulator instead of a real serial port, so
+ * no module, SIM card, or antenna is needed.  Each trial powers the emulated
+ * module up from off and runs the same sequence Logger::logDataAndPublish()
+ * does.  The time taken by each step is summarized on the serial monitor.
+ *
+ * Change the settings below to compare time-to-connect under different module
+ * latencies, registration times, and failure rates.
+ */
+
+// ==========================================================================
+//  Include the libraries required for any data logger
+// ==========================================================================
+// Set the TinyGSM buffer and yield time, as for a real modem
+#define TINY_GSM_RX_BUFFER 64
+#define TINY_GSM_YIELD_MS 2
+
+#include <Arduino.h>
+#include "ModemEmulator.h"
+
+
+// ==========================================================================
+//  Emulator Settings
+// ==========================================================================
+// Uncomment exactly one dialect to emulate
+#define EMULATE_SIM7000
+// #define EMULATE_BG96
+// #define EMULATE_XBEE
+// #define EMULATE_ESP8266
+
+// Milliseconds between the end of a command and the start of the response
+const uint32_t responseLatency = 20;
+// Milliseconds after power-on before the module answers anything
+const uint32_t bootTime = 3000;
+// Milliseconds after boot before the module is registered/joined
+const uint32_t registrationTime = 8000;
+// Milliseconds to bring up the data context or join the access point
+const uint32_t connectTime = 1500;
+// The signal strength to report, in dBm
+const int16_t signalStrength = -75;
+// The percent of commands that get no response at all
+const uint8_t dropRate = 0;
+// The percent of commands that get an ERROR response
+const uint8_t errorRate = 0;
+// The number of wake/connect/disconnect/sleep cycles to time
+const uint8_t numberTrials = 10;
+// The connection timeout passed to connectInternet()
+const uint32_t maxConnectionTime = 50000L;
+
+
+// ==========================================================================
+//  Modem Selection
+// ==========================================================================
+// No pins are given to the modems; the emulator models power state entirely
+// over the serial line.
+#if defined EMULATE_SIM7000
+#include <modems/SIMComSIM7000.h>
+ModemEmulator emulator(ModemEmulator::SIM7000);
+SIMComSIM7000 modem(&emulator, -1, -1, -1, -1, "emulated");
+#elif defined EMULATE_BG96
+#include <modems/QuectelBG96.h>
+ModemEmulator emulator(ModemEmulator::BG96);
+QuectelBG96   modem(&emulator, -1, -1, -1, -1, "emulated");
+#elif defined EMULATE_XBEE
+#include <modems/DigiXBeeCellularTransparent.h>
+ModemEmulator emulator(ModemEmulator::XBEE);
+DigiXBeeCellularTransparent modem(&emulator, -1, -1, false, -1, -1,
+                                  "emulated");
+#elif defined EMULATE_ESP8266
+#include <modems/EspressifESP8266.h>
+ModemEmulator    emulator(ModemEmulator::ESP8266);
+EspressifESP8266 modem(&emulator, -1, -1, -1, -1, "emulated", "emulated");
+#endif
+
+
+// ==========================================================================
+//  Timing Summaries
+// ==========================================================================
+struct stepTiming {
+    const char* name;
+    uint8_t     attempts;
+    uint8_t     successes;
+    uint32_t    minTime;
+    uint32_t    maxTime;
+    uint32_t    totalTime;
+};
+
+stepTiming timings[] = {
+    {"modemWake", 0, 0, 0xFFFFFFFF, 0, 0},
+    {"connectInternet", 0, 0, 0xFFFFFFFF, 0, 0},
+    {"updateModemMetadata", 0, 0, 0xFFFFFFFF, 0, 0},
+    {"disconnectInternet", 0, 0, 0xFFFFFFFF, 0, 0},
+    {"modemSleepPowerDown", 0, 0, 0xFFFFFFFF, 0, 0},
+};
+const uint8_t numberSteps = sizeof(timings) / sizeof(timings[0]);
+
+void recordStep(uint8_t step, uint32_t start, bool success) {
+    uint32_t elapsed = millis() - start;
+    timings[step].attempts++;
+    if (success) timings[step].successes++;
+    if (elapsed < timings[step].minTime) timings[step].minTime = elapsed;
+    if (elapsed > timings[step].maxTime) timings[step].maxTime = elapsed;
+    timings[step].totalTime += elapsed;
+    Serial.print(F("  "));
+    Serial.print(timings[step].name);
+    Serial.print(success ? F(" OK in ") : F(" FAILED in "));
+    Serial.print(elapsed);
+    Serial.println(F(" ms"));
+}
+
+
+void printSummary(void) {
+    Serial.println(F("\nstep, attempts, successes, min ms, mean ms, max ms"));
+    for (uint8_t i = 0; i < numberSteps; i++) {
+        Serial.print(timings[i].name);
+        Serial.print(F(", "));
+        Serial.print(timings[i].attempts);
+        Serial.print(F(", "));
+        Serial.print(timings[i].successes);
+        Serial.print(F(", "));
+        Serial.print(timings[i].attempts ? timings[i].minTime : 0);
+        Serial.print(F(", "));
+        Serial.print(timings[i].attempts
+                         ? timings[i].totalTime / timings[i].attempts
+                         : 0);
+        Serial.print(F(", "));
+        Serial.println(timings[i].maxTime);
+    }
+    Serial.print(F("Commands sent: "));
+    Serial.print(emulator.getCommandCount());
+    Serial.print(F(", without a good response: "));
+    Serial.println(emulator.getFailedCount());
+}
+
+
+// ==========================================================================
+//  Arduino Setup Function
+// ==========================================================================
+void setup() {
+    Serial.begin(115200);
+    delay(50);
+    Serial.println(F("Modem sequence timing against an emulated module"));
+
+    emulator.setResponseLatency(responseLatency);
+    emulator.setBootTime(bootTime);
+    emulator.setRegistrationTime(registrationTime);
+    emulator.setConnectTime(connectTime);
+    emulator.setSignalStrength(signalStrength);
+    emulator.setDropRate(dropRate);
+    emulator.setErrorRate(errorRate);
+    // Script additional responses here if the modem asks for something the
+    // emulator doesn't know, ie:
+    // emulator.addResponse("+CCLK?", "+CCLK: \"20/01/01,00:00:00+00\"");
+
+    // Set up the modem once, as Logger::begin() does, so the trials run the
+    // same sequence as logDataAndPublish() on a set up logger
+    emulator.powerCycle();
+    uint32_t setupStart   = millis();
+    bool     setupSuccess = modem.modemSetup();
+    Serial.print(F("Modem setup "));
+    Serial.print(setupSuccess ? F("succeeded") : F("failed"));
+    Serial.print(F(" in "));
+    Serial.print(millis() - setupStart);
+    Serial.println(F(" ms"));
+
+    for (uint8_t trial = 0; trial < numberTrials; trial++) {
+        Serial.print(F("\nTrial "));
+        Serial.println(trial + 1);
+
+        // Start every trial from a freshly powered module
+        emulator.powerCycle();
+
+        uint32_t start   = millis();
+        bool     success = modem.modemWake();
+        recordStep(0, start, success);
+
+        start   = millis();
+        success = modem.connectInternet(maxConnectionTime);
+        recordStep(1, start, success);
+
+        start   = millis();
+        success = modem.updateModemMetadata();
+        recordStep(2, start, success);
+
+        start = millis();
+        modem.disconnectInternet();
+        recordStep(3, start, true);
+
+        start   = millis();
+        success = modem.modemSleepPowerDown();
+        recordStep(4, start, success);
+    }
+
+    printSummary();
+}
+
+
+// ==========================================================================
+//  Arduino Loop Function
+// ==========================================================================
+void loop() {}